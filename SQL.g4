@@ -14,11 +14,16 @@ sqlStatement
     | useDatabase
     | insertInto
     | selectStatement
+    | explainStatement
     | deleteStatement
     | updateStatement
     | execStatement
+    | prepareStatement
+    | executeStatement
+    | deallocateStatement
     | showDatabases
     | showTables
+    | showStats
     | helpStatement
     | quitStatement
     ;
@@ -32,7 +37,7 @@ dropDatabase
     ;
 
 createTable
-    : CREATE TABLE IDENTIFIER LPAREN columnDefinition (COMMA columnDefinition)* (COMMA primaryKeyDefinition)? RPAREN
+    : CREATE TABLE IDENTIFIER LPAREN columnDefinition (COMMA columnDefinition)* (COMMA primaryKeyDefinition)? RPAREN storageClause?
     ;
 
 dropTable
@@ -52,7 +57,11 @@ useDatabase
     ;
 
 insertInto
-    : INSERT INTO IDENTIFIER VALUES LPAREN valueList RPAREN
+    : INSERT INTO IDENTIFIER VALUES valueRow (COMMA valueRow)*
+    ;
+
+valueRow
+    : LPAREN valueList RPAREN
     ;
 
 valueList
@@ -62,14 +71,49 @@ valueList
 value
     : STRING_LITERAL
     | NUMERIC_LITERAL
+    | PARAM
     ;
 
 selectStatement
-    : SELECT STAR FROM IDENTIFIER (WHERE condition (AND condition)*)?
+    : SELECT selectList FROM IDENTIFIER joinClause? (WHERE condition (AND condition)*)? groupBy? orderBy? (LIMIT NUMERIC_LITERAL)?
+    ;
+
+joinClause
+    : JOIN IDENTIFIER ON columnName EQ columnName
+    ;
+
+columnName
+    : IDENTIFIER (DOT IDENTIFIER)?
+    ;
+
+selectList
+    : STAR
+    | selectItem (COMMA selectItem)*
+    ;
+
+selectItem
+    : columnName
+    | aggregate
+    ;
+
+aggregate
+    : (COUNT | SUM | MIN | MAX) LPAREN (STAR | columnName) RPAREN
+    ;
+
+groupBy
+    : GROUP BY columnName (COMMA columnName)*
+    ;
+
+orderBy
+    : ORDER BY orderItem (COMMA orderItem)*
+    ;
+
+orderItem
+    : columnName (ASC | DESC)?
     ;
 
 condition
-    : IDENTIFIER comparator value
+    : columnName comparator value
     ;
 
 comparator
@@ -97,10 +141,26 @@ assignment
     : IDENTIFIER EQ value
     ;
 
+explainStatement
+    : EXPLAIN ANALYZE selectStatement
+    ;
+
 execStatement
     : EXEC IDENTIFIER
     ;
 
+prepareStatement
+    : PREPARE IDENTIFIER AS (insertInto | selectStatement)
+    ;
+
+executeStatement
+    : EXECUTE IDENTIFIER (USING value (COMMA value)*)?
+    ;
+
+deallocateStatement
+    : DEALLOCATE IDENTIFIER
+    ;
+
 showDatabases
     : SHOW DATABASES
     ;
@@ -109,6 +169,10 @@ showTables
     : SHOW TABLES
     ;
 
+showStats
+    : SHOW STATS
+    ;
+
 helpStatement
     : HELP
     ;
@@ -131,6 +195,10 @@ primaryKeyDefinition
     : PRIMARY KEY LPAREN IDENTIFIER RPAREN
     ;
 
+storageClause
+    : USING IDENTIFIER
+    ;
+
 CREATE: 'CREATE';
 DATABASE: 'DATABASE';
 TABLE: 'TABLE';
@@ -151,11 +219,19 @@ SET: 'SET';
 UPDATE: 'UPDATE';
 DELETE: 'DELETE';
 EXEC: 'EXEC';
+EXECUTE: 'EXECUTE';
+PREPARE: 'PREPARE';
+DEALLOCATE: 'DEALLOCATE';
+EXPLAIN: 'EXPLAIN';
+ANALYZE: 'ANALYZE';
+AS: 'AS';
+USING: 'USING';
 SHOW: 'SHOW';
 HELP: 'HELP';
 QUIT: 'QUIT';
 DATABASES: 'DATABASES';
 TABLES: 'TABLES';
+STATS: 'STATS';
 PRIMARY: 'PRIMARY';
 KEY: 'KEY';
 INT: 'INT';
@@ -164,7 +240,19 @@ CHAR: 'CHAR';
 NULL: 'NULL';
 IS: 'IS';
 IN: 'IN';
+LIMIT: 'LIMIT';
+GROUP: 'GROUP';
+BY: 'BY';
+ORDER: 'ORDER';
+ASC: 'ASC';
+DESC: 'DESC';
+JOIN: 'JOIN';
+COUNT: 'COUNT';
+SUM: 'SUM';
+MIN: 'MIN';
+MAX: 'MAX';
 STAR: '*';
+PARAM: '?';
 
 EQ: '=';
 NEQ: '<>';
@@ -176,6 +264,7 @@ GEQ: '>=';
 LPAREN: '(';
 RPAREN: ')';
 COMMA: ',';
+DOT: '.';
 SEMICOLON: ';';
 
 STRING_LITERAL
@@ -0,0 +1,349 @@
+#include "aggregate.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "exceptions.h"
+
+namespace {
+
+size_t Align8(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+/**
+ * @brief 키 바이트의 64비트 해시. 8바이트씩 섞음
+ */
+uint64_t HashKey(const char *key, size_t len) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ len;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, key + i, 8);
+        h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    if (i < len) {
+        uint64_t word = 0;
+        memcpy(&word, key + i, len - i);
+        h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    h ^= h >> 29;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 32);
+}
+
+/**
+ * @brief 값을 키·상태 바이트로 복사. CHAR는 NULL 뒤를 0으로, 실수 -0은 0으로 바꿈
+ */
+void CopyValue(char *dst, const TKeyView &value) {
+    if (value.key_type() == T_CHAR) {
+        size_t n = strnlen(value.key(), value.length());
+        memcpy(dst, value.key(), n);
+        memset(dst + n, 0, value.length() - n);
+    } else if (value.key_type() == T_FLOAT) {
+        float f;
+        memcpy(&f, value.key(), sizeof(float));
+        f = f == 0.0f ? 0.0f : f;
+        memcpy(dst, &f, sizeof(float));
+    } else {
+        memcpy(dst, value.key(), value.length());
+    }
+}
+
+int KeyLength(int data_type, int length) {
+    return data_type == T_CHAR ? length : 4;   // TKey(keytype, length)와 같은 규칙
+}
+
+}  // namespace
+
+/*=======================================AggregateTable================================================ */
+AggregateTable::AggregateTable(const std::vector<Attribute> &group, const std::vector<AggregateSpec> &aggs)
+    : group_(group), aggs_(aggs), key_len_(0), size_(0), slots_(AGGREGATE_INITIAL_SLOTS, 0) {
+    for (const Attribute &attr : group_) {
+        key_offsets_.push_back(static_cast<int>(key_len_));
+        key_len_ += KeyLength(attr.data_type(), attr.length());
+    }
+    entry_len_ = Align8(key_len_);
+    for (AggregateSpec &agg : aggs_) {
+        agg.state_offset = static_cast<int>(entry_len_);
+        bool value_state = agg.func == AGG_MIN || agg.func == AGG_MAX;
+        entry_len_ += value_state ? Align8(KeyLength(agg.data_type, agg.length)) : 8;
+    }
+    entry_len_ = std::max<size_t>(entry_len_, 8);   // GROUP BY도 집계도 없는 entry
+    key_.resize(key_len_ + 1);
+}
+
+char *AggregateTable::Find(const char *key, uint64_t hash, bool *inserted) {
+    uint64_t tag = hash >> 32;
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        uint64_t slot = slots_[i];
+        if (slot == 0) {
+            if ((size_ + 1) * 2 > slots_.size()) {
+                Grow();     // 채운 비율을 1/2 이하로 유지
+                return Find(key, hash, inserted);
+            }
+            entries_.resize(entries_.size() + entry_len_);
+            char *entry = entries_.data() + size_ * entry_len_;
+            memcpy(entry, key, key_len_);
+            slots_[i] = (tag << 32) | (size_ + 1);
+            size_++;
+            *inserted = true;
+            return entry;
+        }
+        if ((slot >> 32) == tag) {
+            char *entry = entries_.data() + ((slot & 0xFFFFFFFFull) - 1) * entry_len_;
+            if (memcmp(entry, key, key_len_) == 0) {
+                *inserted = false;
+                return entry;
+            }
+        }
+    }
+}
+
+void AggregateTable::Grow() {
+    std::vector<uint64_t> slots(slots_.size() * 2, 0);
+    size_t mask = slots.size() - 1;
+    for (size_t e = 0; e < size_; e++) {
+        uint64_t hash = HashKey(entry(e), key_len_);
+        size_t i = hash & mask;
+        while (slots[i] != 0) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = ((hash >> 32) << 32) | (e + 1);
+    }
+    slots_.swap(slots);
+}
+
+void AggregateTable::Add(const std::vector<TKeyView> &row) {
+    for (size_t k = 0; k < group_.size(); k++) {
+        CopyValue(key_.data() + key_offsets_[k], row[k]);
+    }
+    bool inserted;
+    char *entry = Find(key_.data(), HashKey(key_.data(), key_len_), &inserted);
+    for (const AggregateSpec &agg : aggs_) {
+        char *state = entry + agg.state_offset;
+        switch (agg.func) {
+        case AGG_COUNT: {
+            int64_t count = 0;
+            if (!inserted) {
+                memcpy(&count, state, sizeof(count));
+            }
+            count++;
+            memcpy(state, &count, sizeof(count));
+        } break;
+        case AGG_SUM:
+            if (agg.data_type == T_INT) {
+                int64_t sum = 0;
+                int32_t value;
+                if (!inserted) {
+                    memcpy(&sum, state, sizeof(sum));
+                }
+                memcpy(&value, row[agg.input].key(), sizeof(value));
+                sum += value;
+                memcpy(state, &sum, sizeof(sum));
+            } else {
+                double sum = 0;
+                float value;
+                if (!inserted) {
+                    memcpy(&sum, state, sizeof(sum));
+                }
+                memcpy(&value, row[agg.input].key(), sizeof(value));
+                sum += value;
+                memcpy(state, &sum, sizeof(sum));
+            }
+            break;
+        default: {
+            const TKeyView &value = row[agg.input];
+            TKeyView current(agg.data_type, state, value.length());
+            if (inserted || (agg.func == AGG_MIN ? value < current : value > current)) {
+                CopyValue(state, value);
+            }
+        } break;
+        }
+    }
+}
+
+void AggregateTable::Merge(const AggregateTable &other) {
+    for (size_t e = 0; e < other.size_; e++) {
+        const char *from = other.entry(e);
+        bool inserted;
+        char *entry = Find(from, HashKey(from, key_len_), &inserted);
+        if (inserted) {
+            memcpy(entry + key_len_, from + key_len_, entry_len_ - key_len_);
+            continue;
+        }
+        for (const AggregateSpec &agg : aggs_) {
+            char *state = entry + agg.state_offset;
+            const char *value = from + agg.state_offset;
+            if (agg.func == AGG_COUNT || (agg.func == AGG_SUM && agg.data_type == T_INT)) {
+                int64_t a, b;
+                memcpy(&a, state, sizeof(a));
+                memcpy(&b, value, sizeof(b));
+                a += b;
+                memcpy(state, &a, sizeof(a));
+            } else if (agg.func == AGG_SUM) {
+                double a, b;
+                memcpy(&a, state, sizeof(a));
+                memcpy(&b, value, sizeof(b));
+                a += b;
+                memcpy(state, &a, sizeof(a));
+            } else {
+                int length = KeyLength(agg.data_type, agg.length);
+                TKeyView current(agg.data_type, state, length);
+                TKeyView incoming(agg.data_type, value, length);
+                if (agg.func == AGG_MIN ? incoming < current : incoming > current) {
+                    memcpy(state, value, length);
+                }
+            }
+        }
+    }
+}
+
+/*=======================================HashAggregateCursor================================================ */
+HashAggregateCursor::HashAggregateCursor(const RowSchema &schema, const SQLSelect &st) : pos_(0), empty_row_(false) {
+    // 입력 행: GROUP BY 속성, 집계 대상 속성 순
+    std::vector<int> group_columns;
+    for (const std::string &name : st.group_by()) {
+        group_columns.push_back(schema.Find(name));
+        if (group_columns.back() < 0) {
+            throw AttributeNotExistException();
+        }
+    }
+    input_.columns = group_columns;
+    for (const SQLSelectItem &item : st.items()) {
+        int column = item.column.empty() ? -1 : schema.Find(item.column);
+        if (!item.column.empty() && column < 0) {
+            throw AttributeNotExistException();
+        }
+        if (item.aggregate == AGG_NONE) {
+            auto it = std::find(group_columns.begin(), group_columns.end(), column);
+            if (it == group_columns.end()) {
+                throw AttributeNotGroupedException();
+            }
+            outputs_.push_back({static_cast<int>(it - group_columns.begin()), -1});
+            schema_.push_back(schema.attrs()[column]);
+            continue;
+        }
+
+        AggregateSpec agg = {item.aggregate, -1, T_INT, 4, 0};
+        if (column >= 0) {
+            const Attribute &attr = schema.attrs()[column];
+            if (item.aggregate == AGG_SUM && attr.data_type() == T_CHAR) {
+                throw InvalidAggregateException();
+            }
+            agg.input = static_cast<int>(input_.columns.size());
+            agg.data_type = attr.data_type();
+            agg.length = attr.length();
+            input_.columns.push_back(column);
+        }
+        outputs_.push_back({-1, static_cast<int>(aggs_.size())});
+        aggs_.push_back(agg);
+
+        static const char *func_names[] = {"", "count", "sum", "min", "max"};
+        Attribute out;
+        out.set_attr_name(std::string(func_names[item.aggregate]) + "(" +
+                          (item.column.empty() ? "*" : item.column) + ")");
+        bool counted = item.aggregate == AGG_COUNT;
+        out.set_data_type(counted ? T_INT : agg.data_type);
+        out.set_length(counted ? 4 : agg.length);
+        schema_.push_back(out);
+    }
+
+    for (int column : input_.columns) {
+        input_.schema.push_back(schema.attrs()[column]);
+    }
+    group_.assign(input_.schema.begin(), input_.schema.begin() + group_columns.size());
+    values_.resize(schema_.size() * 4);
+}
+
+void HashAggregateCursor::Build(ResultCursor &input) {
+    partials_.clear();
+    partials_.emplace_back(new AggregateTable(group_, aggs_));
+    while (const std::vector<TKeyView> *row = input.Next()) {
+        partials_[0]->Add(*row);
+    }
+    MergePartials();
+}
+
+void HashAggregateCursor::Build(ParallelScanCursor &input, size_t slots) {
+    partials_.clear();
+    for (size_t i = 0; i < slots; i++) {
+        partials_.emplace_back(new AggregateTable(group_, aggs_));
+    }
+    input.ForEach([this](size_t slot, const std::vector<TKeyView> &row) {
+        partials_[slot]->Add(row);
+    });
+    MergePartials();
+}
+
+void HashAggregateCursor::MergePartials() {
+    // 가장 큰 부분 집계에 나머지를 합침
+    auto largest = std::max_element(partials_.begin(), partials_.end(),
+                                    [](const std::unique_ptr<AggregateTable> &a,
+                                       const std::unique_ptr<AggregateTable> &b) { return a->size() < b->size(); });
+    std::swap(partials_[0], *largest);
+    for (size_t i = 1; i < partials_.size(); i++) {
+        partials_[0]->Merge(*partials_[i]);
+    }
+    partials_.resize(1);
+    pos_ = 0;
+    empty_row_ = group_.empty() && partials_[0]->size() == 0;
+}
+
+const std::vector<TKeyView> *HashAggregateCursor::Emit(const char *entry) {
+    const AggregateTable &table = *partials_[0];
+    row_.resize(outputs_.size());
+    for (size_t k = 0; k < outputs_.size(); k++) {
+        const Attribute &attr = schema_[k];
+        int length = KeyLength(attr.data_type(), attr.length());
+        if (outputs_[k].group >= 0) {
+            row_[k] = TKeyView(attr.data_type(), entry + table.key_offsets()[outputs_[k].group], length);
+            continue;
+        }
+        const AggregateSpec &agg = table.aggs()[outputs_[k].agg];
+        char *value = values_.data() + k * 4;
+        if (agg.func == AGG_COUNT || (agg.func == AGG_SUM && agg.data_type == T_INT)) {
+            int64_t total = 0;
+            if (entry != nullptr) {
+                memcpy(&total, entry + agg.state_offset, sizeof(total));
+            }
+            if (total < std::numeric_limits<int32_t>::min() || total > std::numeric_limits<int32_t>::max()) {
+                throw AggregateOverflowException();
+            }
+            int32_t out = static_cast<int32_t>(total);
+            memcpy(value, &out, sizeof(out));
+            row_[k] = TKeyView(T_INT, value, 4);
+        } else if (agg.func == AGG_SUM) {
+            double total = 0;
+            if (entry != nullptr) {
+                memcpy(&total, entry + agg.state_offset, sizeof(total));
+            }
+            float out = static_cast<float>(total);
+            memcpy(value, &out, sizeof(out));
+            row_[k] = TKeyView(T_FLOAT, value, 4);
+        } else if (entry == nullptr) {
+            row_[k] = TKeyView();   // 빈 입력의 MIN/MAX (NULL)
+        } else {
+            row_[k] = TKeyView(attr.data_type(), entry + agg.state_offset, length);
+        }
+    }
+    return &row_;
+}
+
+const std::vector<TKeyView> *HashAggregateCursor::Next() {
+    if (partials_.empty()) {
+        return nullptr;     // Build 전
+    }
+    if (empty_row_) {
+        empty_row_ = false;
+        return Emit(nullptr);
+    }
+    if (pos_ >= partials_[0]->size()) {
+        return nullptr;
+    }
+    return Emit(partials_[0]->entry(pos_++));
+}
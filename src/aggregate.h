@@ -0,0 +1,148 @@
+#ifndef ABCDB_AGGREGATE_H_
+#define ABCDB_AGGREGATE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "catalog_manager.h"
+#include "sql_statement.h"
+#include "cursor.h"
+
+#define AGGREGATE_INITIAL_SLOTS 64  // AggregateTable의 처음 slot 수 (2의 거듭제곱)
+
+/**
+ * @brief 집계 하나의 입력과 그룹 entry 안의 상태 위치
+ * @details 상태는 8바이트 단위다. COUNT와 정수 SUM은 int64, 실수 SUM은 double, MIN/MAX는 값 바이트를 그대로 둔다.
+ */
+struct AggregateSpec {
+    int func;           // AGG_COUNT, AGG_SUM, AGG_MIN, AGG_MAX
+    int input;          // 입력 행의 속성 위치. COUNT(*)이면 -1
+    int data_type;      // 입력 속성 타입
+    int length;         // 입력 속성 길이
+    int state_offset;   // 그룹 entry 안의 상태 위치 (AggregateTable이 정함)
+};
+
+/**
+ * @brief GROUP BY 속성 바이트를 키로 하는 open addressing(linear probing) 해시 테이블과 그룹별 집계 상태
+ * @details 그룹 entry(키 + 집계 상태)는 entries_에 차례로 붙이고, slot 배열에는 해시 상위 32비트와 entry 번호만
+ *          8바이트로 담는다. 그래서 probe는 대개 캐시 라인 하나 안에서 끝나고, 키 바이트는 해시가 같을 때만 비교한다.
+ *          CHAR 키는 NULL 뒤를 0으로 채우고 실수 키의 -0은 0으로 바꿔 같은 값이 같은 바이트가 되게 한다.
+ *
+ *          입력 행은 앞의 group_count개 속성이 GROUP BY 속성이고, 그 뒤가 집계 대상 속성이다 (AggregateSpec::input).
+ *          스레드마다 하나씩 두고 부분 집계를 만든 뒤 Merge로 합친다.
+ */
+class AggregateTable {
+private:
+    std::vector<Attribute> group_;      // GROUP BY 속성 (키 순서)
+    std::vector<int> key_offsets_;      // entry 안의 GROUP BY 속성 위치
+    std::vector<AggregateSpec> aggs_;
+    size_t key_len_;
+    size_t entry_len_;                  // 키(8바이트 정렬) + 집계 상태
+    std::vector<char> entries_;
+    size_t size_;
+    std::vector<uint64_t> slots_;       // (해시 상위 32비트 << 32) | (entry 번호 + 1). 0이면 빈 slot
+    std::vector<char> key_;             // Add가 키를 만드는 작업 공간
+
+    /**
+     * @brief 키의 그룹 entry를 찾고, 없으면 키만 채운 entry를 새로 만듦
+     *
+     * @param inserted 새로 만들었으면 true. 상태는 호출한 쪽이 채움
+     * @return char* entry (다음 Find 전까지만 유효)
+     */
+    char *Find(const char *key, uint64_t hash, bool *inserted);
+
+    /**
+     * @brief slot 수를 두 배로 늘리고 모든 entry를 다시 넣음
+     */
+    void Grow();
+
+public:
+    AggregateTable(const std::vector<Attribute> &group, const std::vector<AggregateSpec> &aggs);
+
+    /**
+     * @brief 입력 행 하나를 그 그룹의 상태에 더함
+     */
+    void Add(const std::vector<TKeyView> &row);
+
+    /**
+     * @brief other(같은 GROUP BY·집계의 부분 집계)의 그룹을 합침
+     */
+    void Merge(const AggregateTable &other);
+
+    size_t size() const { return size_; }
+    const char *entry(size_t i) const { return entries_.data() + i * entry_len_; }
+    const std::vector<int> &key_offsets() const { return key_offsets_; }
+    const std::vector<AggregateSpec> &aggs() const { return aggs_; }
+};
+
+/**
+ * @brief WHERE를 만족하는 행을 GROUP BY 속성으로 묶어 COUNT/SUM/MIN/MAX를 계산하고 그룹마다 한 행을 돌려주는 커서
+ * @details 입력을 모두 읽어 AggregateTable에 모은 뒤 그룹을 처음 나온 순서대로 돌려준다. ParallelScanCursor를
+ *          입력으로 받으면 스레드(slot)마다 따로 부분 집계를 만들고 끝에 합치므로 행을 한 곳으로 모으지 않는다.
+ *          이때는 가장 큰 부분 집계의 그룹 순서 뒤에 나머지 부분 집계의 새 그룹이 붙으므로, 결과 순서는 입력 순서와
+ *          다를 수 있고 실행마다 달라질 수 있다 (순서가 필요하면 ORDER BY).
+ *          GROUP BY가 없으면 입력이 비어 있어도 한 행을 돌려주며, 이때 MIN/MAX는 NULL이다.
+ *
+ *          COUNT와 정수 SUM은 int64로 세고 int로 돌려주며, 실수 SUM은 double로 더해 float로 돌려준다.
+ */
+class HashAggregateCursor : public ResultCursor {
+private:
+    /**
+     * @brief 결과 행 속성 하나가 entry의 어디서 오는지
+     */
+    struct Output {
+        int group;      // GROUP BY 속성 위치, 집계이면 -1
+        int agg;        // 집계 위치, GROUP BY 속성이면 -1
+    };
+
+    std::vector<Attribute> schema_;
+    std::vector<Output> outputs_;
+    std::vector<Attribute> group_;
+    std::vector<AggregateSpec> aggs_;
+    Projection input_;
+    std::vector<std::unique_ptr<AggregateTable>> partials_;     // slot별 부분 집계. 합친 결과는 partials_[0]
+
+    size_t pos_;                // 다음에 돌려줄 그룹
+    bool empty_row_;            // GROUP BY 없이 입력이 비어 있을 때 돌려줄 한 행이 남음
+    std::vector<char> values_;  // 결과 행의 COUNT/SUM 값 (속성마다 4바이트)
+    std::vector<TKeyView> row_;
+
+    /**
+     * @brief 부분 집계를 가장 큰 것 하나로 합침 (옮기는 그룹 수를 줄임). 그룹 순서는 입력 순서를 따르지 않음
+     */
+    void MergePartials();
+    const std::vector<TKeyView> *Emit(const char *entry);
+
+public:
+    /**
+     * @brief SELECT 목록과 GROUP BY를 검사하고 결과 스키마를 만듦. 입력은 Build로 넣음
+     *
+     * @param schema 입력 커서가 읽을 수 있는 속성 (테이블 하나 또는 JOIN 결과)
+     * @throw AttributeNotExistException 없는 속성
+     * @throw AttributeNotGroupedException 집계하지 않는 속성이 GROUP BY에 없음
+     * @throw InvalidAggregateException CHAR 속성의 SUM
+     */
+    HashAggregateCursor(const RowSchema &schema, const SQLSelect &st);
+
+    /**
+     * @brief 입력 커서가 읽을 속성 (GROUP BY 속성, 집계 대상 속성 순). 위치는 schema 기준
+     */
+    const Projection &input() const { return input_; }
+
+    /**
+     * @brief 입력 커서의 행을 모두 한 스레드에서 집계
+     */
+    void Build(ResultCursor &input);
+
+    /**
+     * @brief 병렬 스캔의 행을 slot마다 따로 집계한 뒤 합침
+     */
+    void Build(ParallelScanCursor &input, size_t slots);
+
+    const std::vector<Attribute> &Schema() { return schema_; }
+    const std::vector<TKeyView> *Next();
+};
+
+#endif
@@ -1,59 +1,175 @@
+#include <chrono>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <stdexcept>
 #include <vector>
 #include <boost/filesystem.hpp>
 #include "api.h"
 #include "catalog_manager.h"
 #include "exceptions.h"
+#include "session_output.h"
 #include "execution_engine.h"
 #include "buffer_manager.h"
+#include "config.h"
+#include "spill_file.h"
+#include "metrics.h"
 
 using namespace std;
 
-API::API(std::string p) : path_(p)
+namespace {
+
+/**
+ * @brief 닫힐 때까지 statement latch를 shared로 잡고 있는 커서
+ */
+class LatchedCursor : public ResultCursor
+{
+private:
+  std::shared_lock<std::shared_mutex> latch_;
+  std::unique_ptr<ResultCursor> cursor_;  // latch_보다 먼저 소멸 (페이지 고정을 먼저 놓음)
+
+public:
+  LatchedCursor(std::shared_lock<std::shared_mutex> latch, std::unique_ptr<ResultCursor> cursor)
+      : latch_(std::move(latch)), cursor_(std::move(cursor)) {}
+
+  const std::vector<Attribute> &Schema() override { return cursor_->Schema(); }
+  const std::vector<TKeyView> *Next() override { return cursor_->Next(); }
+};
+
+/**
+ * @brief read_only 설정이면 데이터나 카탈로그를 바꾸는 문장을 거부
+ */
+void CheckWritable()
+{
+  if (Config::Instance().read_only())
+  {
+    throw ReadOnlyException();
+  }
+}
+
+}  // namespace
+
+API::API(std::string p) : path_(p), owner_(true)
 {
+  Config &config = Config::Instance();
+  config.Load(p);
+  // 읽기 전용이면 로그를 쓰거나 재생하지 않고 파일을 그대로 읽음. 재생하지 않은 로그가 있으면 테이블 파일에
+  // commit한 행이 빠져 있고 인덱스는 REINDEX 전이므로 열지 않음
+  if (config.read_only() && WriteAheadLog::HasRecords(p + WAL_FILE_NAME))
+  {
+    throw std::runtime_error("읽기 전용으로 열 수 없습니다: 재생하지 않은 로그가 있습니다 (" + p + WAL_FILE_NAME +
+                             "). read_only = off로 한 번 열어 복구한 뒤 다시 여세요.");
+  }
   cm_ = new CatalogManager(p);
-  bm_ = new BufferManager();
+  bool wal = config.wal() && !config.read_only();
+  bm_ = new BufferManager(config.replacement_policy(), config.buffer_pool_pages(),
+                          wal ? p + WAL_FILE_NAME : "", config.wal_commit_delay());
+  Recover();
+  boost::filesystem::remove_all(p + TEMP_DIR_NAME);  // 비정상 종료로 남은 JOIN spill 파일
+  bm_->EnablePrefetch(config.prefetch_pages());
+  bm_->EnableScanRing(config.scan_ring_pages());
+  bgw_ = nullptr;
+  if (config.bgwriter_delay() > 0 && !config.read_only())
+  {
+    bgw_ = new BackgroundWriter(bm_, config.bgwriter_delay(), config.bgwriter_max_pages(),
+                                config.checkpoint_interval(), config.checkpoint_wal_size());
+  }
+}
+
+void API::Recover()
+{
+  std::set<std::string> touched = bm_->Recover();
+  if (touched.empty())
+  {
+    return;
+  }
+  // 인덱스 페이지는 로그가 없으므로 로그에 나온 테이블의 인덱스를 다시 만들고 checkpoint
+  for (Database &db : cm_->dbs())
+  {
+    ExecutionEngine ee(cm_, db.db_name(), bm_);
+    for (Table &tb : db.tbs())
+    {
+      if (touched.count(tb.GetFile()) && !tb.ids().empty())
+      {
+        ee.RebuildIndexes(&tb);
+      }
+    }
+  }
+  bm_->Checkpoint();
+}
+
+API::API(const API *core)
+    : path_(core->path_), cm_(core->cm_), bm_(core->bm_), bgw_(nullptr), owner_(false)
+{
+}
+
+API *API::OpenSession() const
+{
+  return new API(this);
 }
 
 API::~API()
 {
+  if (!owner_)
+  {
+    return;
+  }
   // hdl_ is initialized in #Use#
   // delete hdl_;
-  std::cout << "API DIE" << std::endl;
+  SessionOut() << "API DIE" << std::endl;
+  delete bgw_;  // 남은 dirty 페이지는 bm_ 소멸자의 checkpoint가 씀
   delete cm_;
   delete bm_;
 }
 
 void API::Quit()
 {
-  // delete hdl_;
-  delete cm_;
-  delete bm_;
-  std::cout << "Quiting..." << std::endl;
+  if (owner_)
+  {
+    // delete hdl_;
+    delete bgw_;
+    bgw_ = nullptr;
+    delete cm_;
+    cm_ = nullptr;
+    delete bm_;
+    bm_ = nullptr;
+  }
+  SessionOut() << "Quiting..." << std::endl;
 }
 
 void API::Help()
 {
-  std::cout << "AbcDB 1.0.0" << std::endl;
-  std::cout << "Implemented SQL types:" << std::endl;
-  std::cout << "#QUIT#" << std::endl;
-  std::cout << "#HELP#" << std::endl;
-  std::cout << "#EXEC#" << std::endl;
-  std::cout << "#CREATE DATABASE#" << std::endl;
-  std::cout << "#SHOW DATABASES#" << std::endl;
-  std::cout << "#USE#" << std::endl;
-  std::cout << "#CREATE TABLE#" << std::endl;
-  std::cout << "#SHOW TABLES#" << std::endl;
-  std::cout << "#SELECT#" << std::endl;
-  std::cout << "#INSERT#" << std::endl;
+  SessionOut() << "AbcDB 1.0.0" << std::endl;
+  SessionOut() << "Implemented SQL types:" << std::endl;
+  SessionOut() << "#QUIT#" << std::endl;
+  SessionOut() << "#HELP#" << std::endl;
+  SessionOut() << "#EXEC#" << std::endl;
+  SessionOut() << "#CREATE DATABASE#" << std::endl;
+  SessionOut() << "#SHOW DATABASES#" << std::endl;
+  SessionOut() << "#USE#" << std::endl;
+  SessionOut() << "#CREATE TABLE# (USING ROW | PAX)" << std::endl;
+  SessionOut() << "#CREATE INDEX#" << std::endl;
+  SessionOut() << "#DROP INDEX#" << std::endl;
+  SessionOut() << "#SHOW TABLES#" << std::endl;
+  SessionOut() << "#SHOW STATS#" << std::endl;
+  SessionOut() << "#SELECT# (* | column, COUNT/SUM/MIN/MAX(column), ...) (JOIN table ON a.x = b.y) (GROUP BY column, ...) (ORDER BY column [ASC | DESC], ...) (LIMIT n)" << std::endl;
+  SessionOut() << "#EXPLAIN ANALYZE# SELECT ..." << std::endl;
+  SessionOut() << "#INSERT#" << std::endl;
+  SessionOut() << "#PREPARE#" << std::endl;
+  SessionOut() << "#EXECUTE#" << std::endl;
+  SessionOut() << "#DEALLOCATE#" << std::endl;
 }
 
 void API::CreateDatabase(SQLCreateDatabase &st)
 {
-  std::cout << "Creating database: " << st.db_name() << std::endl;
+  CheckWritable();
+  std::unique_lock<std::shared_mutex> latch(bm_->statement_latch());
+  SessionOut() << "Creating database: " << st.db_name() << std::endl;
   std::string folder_name(path_ + st.db_name());
-  std::cout<<path_<<std::endl;
+  SessionOut()<<path_<<std::endl;
   boost::filesystem::path folder_path(folder_name);
 
   folder_path.imbue(std::locale("en_US.UTF-8"));
@@ -66,30 +182,31 @@ void API::CreateDatabase(SQLCreateDatabase &st)
   if (boost::filesystem::exists(folder_path))
   {
     boost::filesystem::remove_all(folder_path);
-    std::cout << "Database folder exists and deleted!" << std::endl;
+    SessionOut() << "Database folder exists and deleted!" << std::endl;
   }
 
   boost::filesystem::create_directories(folder_path);
-  std::cout << "Database folder created!" << std::endl;
+  SessionOut() << "Database folder created!" << std::endl;
 
   cm_->CreateDatabase(st.db_name());
-  std::cout << "Catalog written!" << std::endl;
+  SessionOut() << "Catalog written!" << std::endl;
   cm_->WriteArchiveFile();
 }
 
 void API::ShowDatabases()
 {
-  std::vector<Database> dbs = cm_->dbs();
-  std::cout << "DATABASE LIST:" << std::endl;
+  std::shared_lock<std::shared_mutex> latch(bm_->statement_latch());
+  std::vector<Database> &dbs = cm_->dbs();
+  SessionOut() << "DATABASE LIST:" << std::endl;
   for (unsigned int i = 0; i < dbs.size(); ++i)
   {
-    Database db = dbs[i];
-    std::cout << "\t" << db.db_name() << std::endl;
+    SessionOut() << "\t" << dbs[i].db_name() << std::endl;
   }
 }
 
 void API::Use(SQLUse &st)
 {
+  std::unique_lock<std::shared_mutex> latch(bm_->statement_latch());
   Database *db = cm_->GetDB(st.db_name());
 
   if (db == NULL)
@@ -99,17 +216,23 @@ void API::Use(SQLUse &st)
 
   if (curr_db_.length() != 0)
   {
-    std::cout << "Closing the old database: " << curr_db_ << std::endl;
-    cm_->WriteArchiveFile();
+    SessionOut() << "Closing the old database: " << curr_db_ << std::endl;
+    if (!Config::Instance().read_only())
+    {
+      cm_->WriteDatabaseFile(curr_db_);
+    }
     // delete hdl_;
   }
   curr_db_ = st.db_name();
+  tables_.Reset(cm_, curr_db_);
   // hdl_ = new BufferManager(path_);
 }
 
 void API::CreateTable(SQLCreateTable &st)
 {
-  std::cout << "Creating table: " << st.tb_name() << std::endl;
+  CheckWritable();
+  std::unique_lock<std::shared_mutex> latch(bm_->statement_latch());
+  SessionOut() << "Creating table: " << st.tb_name() << std::endl;
   if (curr_db_.length() == 0)
   {
     throw NoDatabaseSelectedException();
@@ -132,20 +255,54 @@ void API::CreateTable(SQLCreateTable &st)
   if (boost::filesystem::exists(file_name))
   {
     boost::filesystem::remove(file_name);
-    std::cout << "Table file already exists and deleted!" << std::endl;
+    SessionOut() << "Table file already exists and deleted!" << std::endl;
   }
 
   ofstream ofs(file_name);
   ofs.close();
-  std::cout << "Table file created!" << std::endl;
+  SessionOut() << "Table file created!" << std::endl;
 
   db->CreateTable(st,file_name);
-  std::cout << "Catalog written!" << std::endl;
-  cm_->WriteArchiveFile();
+  cm_->Invalidate();  // tbs_가 다시 할당되었을 수 있음
+  SessionOut() << "Catalog written!" << std::endl;
+  cm_->WriteDatabaseFile(curr_db_);
+}
+
+void API::CreateIndex(SQLCreateIndex &st)
+{
+  CheckWritable();
+  std::unique_lock<std::shared_mutex> latch(bm_->statement_latch());
+  SessionOut() << "Creating index: " << st.index_name() << std::endl;
+  if (curr_db_.length() == 0)
+  {
+    throw NoDatabaseSelectedException();
+  }
+
+  ExecutionEngine ee(cm_, curr_db_, bm_, &tables_);
+  ee.CreateIndex(st);
+  SessionOut() << "Catalog written!" << std::endl;
+  cm_->WriteDatabaseFile(curr_db_);
+}
+
+void API::DropIndex(SQLDropIndex &st)
+{
+  CheckWritable();
+  std::unique_lock<std::shared_mutex> latch(bm_->statement_latch());
+  SessionOut() << "Dropping index: " << st.index_name() << std::endl;
+  if (curr_db_.length() == 0)
+  {
+    throw NoDatabaseSelectedException();
+  }
+
+  ExecutionEngine ee(cm_, curr_db_, bm_, &tables_);
+  ee.DropIndex(st);
+  SessionOut() << "Catalog written!" << std::endl;
+  cm_->WriteDatabaseFile(curr_db_);
 }
 
 void API::ShowTables()
 {
+  std::shared_lock<std::shared_mutex> latch(bm_->statement_latch());
   if (curr_db_.length() == 0)
   {
     throw NoDatabaseSelectedException();
@@ -156,49 +313,105 @@ void API::ShowTables()
   {
     throw DatabaseNotExistException();
   }
-  std::cout << "CURRENT DATABASE: " << curr_db_ << std::endl;
-  std::cout << "TABLE LIST:" << std::endl;
+  SessionOut() << "CURRENT DATABASE: " << curr_db_ << std::endl;
+  SessionOut() << "TABLE LIST:" << std::endl;
   for (int i = 0; i < db->tbs().size(); ++i)
   {
     Table &tb = db->tbs()[i];
-    std::cout << "\t" << tb.tb_name() << std::endl;
+    SessionOut() << "\t" << tb.tb_name() << std::endl;
   }
 }
 
 void API::Insert(SQLInsert &st)
 {
+  CheckWritable();
   if (curr_db_.length() == 0)
   {
     throw NoDatabaseSelectedException();
   }
 
-  Database *db = cm_->GetDB(curr_db_);
-  if (db == NULL)
   {
-    throw DatabaseNotExistException();
+    std::unique_lock<std::shared_mutex> latch(bm_->statement_latch());
+    Database *db = cm_->GetDB(curr_db_);
+    if (db == NULL)
+    {
+      throw DatabaseNotExistException();
+    }
+    ExecutionEngine ee(cm_, curr_db_, bm_, &tables_);
+    ee.Insert(st);
   }
-  ExecutionEngine *ee = new ExecutionEngine(cm_, curr_db_, bm_);
-  ee->Insert(st);
-  delete ee;
+  bm_->Commit();  // latch 밖에서 기다려 다른 세션의 commit과 fsync를 나눔
+}
+
+void API::CheckInsert(SQLInsert &st)
+{
+  if (curr_db_.length() == 0)
+  {
+    throw NoDatabaseSelectedException();
+  }
+
+  std::shared_lock<std::shared_mutex> latch(bm_->statement_latch());
+  ExecutionEngine ee(cm_, curr_db_, bm_, &tables_);
+  ee.CheckInsert(st);
 }
 
 void API::Select(SQLSelect &st)
 {
+  std::shared_lock<std::shared_mutex> latch(bm_->statement_latch());
   if (curr_db_.length() == 0)
   {
     throw NoDatabaseSelectedException();
   }
 
-  std::string file_name(path_ + curr_db_ + "/" + st.tb_name() + ".bin");
-  Table *tb = cm_->GetDB(curr_db_)->GetTable(file_name);
-  if (tb == NULL)
+  ExecutionEngine ee(cm_, curr_db_, bm_, &tables_);
+  ee.Select(st);  // 없는 테이블이면 TableNotExistException
+}
+
+void API::ExplainAnalyze(SQLSelect &st)
+{
+  Metrics::Snapshot before = Metrics::Instance().Take();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  size_t rows = 0;
   {
-    throw TableNotExistException();
+    std::unique_ptr<ResultCursor> cursor = OpenSelect(st);
+    while (cursor->Next())
+    {
+      rows++;
+    }
+  }
+  long elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  Metrics::Snapshot diff = Metrics::Instance().Take() - before;
+
+  SessionOut() << "EXPLAIN ANALYZE: " << st.tb_name() << std::endl;
+  SessionOut() << "\t" << std::setw(20) << std::left << "rows returned" << rows << std::endl;
+  SessionOut() << "\t" << std::setw(20) << std::left << "execution time" << elapsed_us << " us" << std::endl;
+  Metrics::PrintCounters(diff, SessionOut());
+  SessionOut() << std::endl;
+}
+
+void API::ShowStats()
+{
+  const BufferPool *pool = bm_->buffer_pool();
+  SessionOut() << "BUFFER POOL: " << pool->GetPolicyName() << ", " << pool->GetSize() << " / " << pool->GetCapacity()
+               << " frames" << std::endl;
+  SessionOut() << "COUNTERS:" << std::endl;
+  Metrics::PrintCounters(Metrics::Instance().Take(), SessionOut());
+  SessionOut() << "LATENCY:" << std::endl;
+  Metrics::Instance().PrintLatencies(SessionOut());
+  SessionOut() << std::endl;
+}
+
+std::unique_ptr<ResultCursor> API::OpenSelect(SQLSelect &st)
+{
+  if (curr_db_.length() == 0)
+  {
+    throw NoDatabaseSelectedException();
   }
 
-  ExecutionEngine *ee = new ExecutionEngine(cm_, curr_db_, bm_);
-  ee->Select(st);
-  delete ee;
+  std::shared_lock<std::shared_mutex> latch(bm_->statement_latch());
+  ExecutionEngine ee(cm_, curr_db_, bm_, &tables_);
+  std::unique_ptr<ResultCursor> cursor = ee.OpenSelect(st);
+  return std::unique_ptr<ResultCursor>(new LatchedCursor(std::move(latch), std::move(cursor)));
 }
 
 // void API::AddTestRecord(SQLTestRecord &st){
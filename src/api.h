@@ -1,32 +1,84 @@
 #ifndef ABCDB_API_H_
 #define ABCDB_API_H_
 
+#include <memory>
 #include <string>
 
 #include "catalog_manager.h"
 #include "buffer_manager.h"
 #include "sql_statement.h"
+#include "cursor.h"
+#include "background_writer.h"
 
+/**
+ * @brief SQL 문 단위 실행 진입점
+ * @details 카탈로그, 버퍼 매니저, background writer는 처음 만든 API가 소유하고, OpenSession으로 만든
+ *          세션은 이를 공유한 채 현재 데이터베이스만 따로 가진다. 각 함수는 BufferManager::statement_latch()를
+ *          읽기 문장은 shared, 쓰기 문장은 exclusive로 잡으므로 여러 스레드의 세션이 동시에 불러도 된다.
+ */
 class API
 {
 private:
   std::string path_;
   CatalogManager *cm_;
   BufferManager *bm_;
+  BackgroundWriter *bgw_;  // nullptr이면 dirty 페이지는 교체와 checkpoint 때만 쓰임
   std::string curr_db_;
+  bool owner_;             // false이면 다른 API의 카탈로그와 버퍼 매니저를 빌려 쓰는 세션
+  TableCache tables_;      // curr_db_에서 이 세션이 찾은 테이블
+
+  /**
+   * @brief 시작할 때 로그를 재생하고, 로그에 나온 테이블의 인덱스를 다시 만듦
+   */
+  void Recover();
+
+  explicit API(const API *core);
 
 public:
   API(std::string p);
   ~API();
+
+  /**
+   * @brief 같은 카탈로그와 버퍼 매니저를 쓰는 새 세션. 호출한 쪽이 delete하며, 이 API보다 먼저 지워야 함
+   */
+  API *OpenSession() const;
+
   void Quit();
   void Help();
   void CreateDatabase(SQLCreateDatabase &st);
   void ShowDatabases();
   void Use(SQLUse &st);
   void CreateTable(SQLCreateTable &st);
+  void CreateIndex(SQLCreateIndex &st);
+  void DropIndex(SQLDropIndex &st);
   void ShowTables();
   void Insert(SQLInsert &st);
+
+  /**
+   * @brief INSERT를 실행하지 않고 행마다 값 개수가 테이블과 맞는지만 확인 (EXEC가 INSERT를 묶기 전에 씀)
+   *
+   * @throw SyntaxErrorException 값 개수가 다른 행이 있음
+   */
+  void CheckInsert(SQLInsert &st);
   void Select(SQLSelect &st);
+
+  /**
+   * @brief SELECT를 끝까지 실행하고 결과 대신 행 수, 실행 시간, 그 동안 늘어난 실행 통계를 출력
+   * @details 통계는 프로세스 전체 값의 차이이므로 다른 세션이 동시에 실행한 작업도 포함됨
+   */
+  void ExplainAnalyze(SQLSelect &st);
+
+  /**
+   * @brief 시작한 뒤 누적된 버퍼 풀·페이지·행 통계와 파싱·실행 시간 분포를 출력
+   */
+  void ShowStats();
+
+  /**
+   * @brief SELECT 결과를 출력하지 않고 커서로 받음
+   * @details 커서는 닫힐 때까지 statement_latch()를 shared로 잡고 있으므로, 같은 스레드에서 다음 쓰기 문장을
+   *          실행하기 전에 닫아야 함
+   */
+  std::unique_ptr<ResultCursor> OpenSelect(SQLSelect &st);
   // void AddTestRecord(SQLTestRecord &st);
 };
 
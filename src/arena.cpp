@@ -0,0 +1,23 @@
+#include "arena.h"
+
+#include <algorithm>
+
+void Arena::NewChunk(size_t min) {
+    size_t size = std::max(next_size_, min);
+    chunks_.push_back({std::unique_ptr<char[]>(new char[size]), size});
+    cur_ = chunks_.back().data.get();
+    left_ = size;
+    reserved_ += size;
+    next_size_ = std::min<size_t>(next_size_ * 2, ARENA_MAX_CHUNK);
+}
+
+void Arena::Reset() {
+    if (chunks_.empty()) {
+        return;
+    }
+    chunks_.resize(1);
+    cur_ = chunks_[0].data.get();
+    left_ = chunks_[0].size;
+    reserved_ = chunks_[0].size;
+    next_size_ = std::min<size_t>(std::max<size_t>(chunks_[0].size, ARENA_MIN_CHUNK) * 2, ARENA_MAX_CHUNK);
+}
@@ -0,0 +1,69 @@
+#ifndef ABCDB_ARENA_H_
+#define ABCDB_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#define ARENA_MIN_CHUNK (64 * 1024)         // 첫 chunk 크기
+#define ARENA_MAX_CHUNK (4 * 1024 * 1024)   // chunk는 두 배씩 커지다 이 크기에서 멈춤
+
+/**
+ * @brief 질의 하나가 쓰는 행·키 메모리를 chunk로 잡아 두고 bump pointer로 나눠 주는 할당기
+ * @details 할당은 현재 chunk의 포인터를 옮기는 것뿐이고 따로 해제하지 않는다. 잡은 메모리는 Reset이나 소멸 때
+ *          한 번에 놓는다. chunk는 ARENA_MIN_CHUNK부터 두 배씩 ARENA_MAX_CHUNK까지 커지며, 그보다 큰 요청은
+ *          요청 크기의 chunk를 따로 잡는다. 소멸자가 없는 바이트(행, 키 값)만 담는다. 한 스레드에서만 쓴다.
+ */
+class Arena {
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks_;
+    char *cur_;             // 현재 chunk의 다음 빈 자리
+    size_t left_;           // 현재 chunk에 남은 bytes
+    size_t next_size_;      // 다음 chunk 크기
+    size_t reserved_;       // 잡은 chunk 크기 합
+
+    /**
+     * @brief min bytes 이상의 chunk를 새로 잡아 현재 chunk로 함
+     */
+    void NewChunk(size_t min);
+
+public:
+    Arena() : cur_(nullptr), left_(0), next_size_(ARENA_MIN_CHUNK), reserved_(0) {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /**
+     * @brief size bytes를 align 경계에 맞춰 잡음 (Reset이나 소멸 전까지 유효)
+     */
+    void *Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        size_t pad = (align - reinterpret_cast<uintptr_t>(cur_) % align) % align;
+        if (size + pad > left_) {
+            NewChunk(size + align);
+            pad = (align - reinterpret_cast<uintptr_t>(cur_) % align) % align;
+        }
+        char *p = cur_ + pad;
+        cur_ = p + size;
+        left_ -= size + pad;
+        return p;
+    }
+
+    char *AllocateBytes(size_t size) { return static_cast<char *>(Allocate(size, 1)); }
+
+    /**
+     * @brief 첫 chunk만 남기고 모두 놓음. 이전에 잡은 메모리는 모두 무효가 됨
+     */
+    void Reset();
+
+    /**
+     * @brief 지금 잡고 있는 chunk 크기 합 (bytes)
+     */
+    size_t reserved() const { return reserved_; }
+};
+
+#endif
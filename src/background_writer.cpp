@@ -0,0 +1,56 @@
+#include "background_writer.h"
+
+#include <iostream>
+#include <stdexcept>
+
+BackgroundWriter::BackgroundWriter(BufferManager *bm, long delay_ms, size_t max_pages, long checkpoint_interval_s,
+                                   size_t checkpoint_wal_size)
+    : bm_(bm), delay_(delay_ms), max_pages_(max_pages), checkpoint_interval_(checkpoint_interval_s),
+      checkpoint_wal_size_(checkpoint_wal_size), stop_(false), pages_written_(0), checkpoints_(0) {
+    thread_ = std::thread(&BackgroundWriter::Run, this);
+}
+
+BackgroundWriter::~BackgroundWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+bool BackgroundWriter::CheckpointDue(std::chrono::steady_clock::time_point last_checkpoint) {
+    WriteAheadLog *wal = bm_->wal();
+    if (wal != nullptr && wal->size() <= sizeof(WalFileHeader)) {
+        return false;   // checkpoint 뒤 로그에 쌓인 것이 없음
+    }
+    if (checkpoint_interval_.count() > 0 &&
+        std::chrono::steady_clock::now() - last_checkpoint >= checkpoint_interval_) {
+        return true;
+    }
+    return wal != nullptr && checkpoint_wal_size_ > 0 && wal->size() >= checkpoint_wal_size_;
+}
+
+void BackgroundWriter::Run() {
+    std::chrono::steady_clock::time_point last_checkpoint = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cv_.wait_for(lock, delay_, [this] { return stop_; })) {
+        lock.unlock();
+        try {
+            if (CheckpointDue(last_checkpoint)) {
+                std::shared_lock<std::shared_mutex> latch(bm_->statement_latch());  // 실행 중인 쓰기 문장이 끝날 때까지 기다림
+                bm_->Checkpoint();
+                last_checkpoint = std::chrono::steady_clock::now();
+                checkpoints_++;
+            } else {
+                std::shared_lock<std::shared_mutex> latch(bm_->statement_latch(), std::try_to_lock);
+                if (latch.owns_lock()) {
+                    pages_written_ += bm_->WriteDirtyPages(max_pages_);
+                }
+            }
+        } catch (const std::runtime_error &e) {
+            std::cerr << "[Background Writer] " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef ABCDB_BACKGROUND_WRITER_H_
+#define ABCDB_BACKGROUND_WRITER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include "buffer_manager.h"
+
+/**
+ * @brief dirty 페이지를 조금씩 디스크에 쓰고 주기적으로 checkpoint 하는 스레드
+ * @details delay마다 dirty 페이지를 파일 offset 순서로 최대 max_pages개 써서 clean 프레임을 확보한다.
+ *          버퍼 풀은 clean 프레임을 먼저 내보내므로 foreground의 교체 경로가 쓰기를 기다리지 않게 된다.
+ *          마지막 checkpoint 뒤 checkpoint_interval이 지났거나 로그가 checkpoint_wal_size를 넘으면
+ *          BufferManager::Checkpoint로 로그를 비워 복구 시간을 제한한다.
+ *
+ *          페이지 쓰기는 BufferManager::statement_latch()를 shared로 잡은 상태에서만 하므로 SELECT와는 함께 돌고,
+ *          INSERT 같은 쓰기 문장이 실행 중이면 그 회차는 건너뛴다. checkpoint 시점이 되면 쓰기 문장이 끝날 때까지 기다린다.
+ */
+class BackgroundWriter {
+private:
+    BufferManager *bm_;
+    std::chrono::milliseconds delay_;
+    size_t max_pages_;
+    std::chrono::seconds checkpoint_interval_;  // 0이면 시간으로는 checkpoint 하지 않음
+    size_t checkpoint_wal_size_;                // 0이면 로그 크기로는 checkpoint 하지 않음
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_;
+    std::thread thread_;
+
+    std::atomic<uint64_t> pages_written_;
+    std::atomic<uint64_t> checkpoints_;
+
+    void Run();
+
+    /**
+     * @brief 마지막 checkpoint 이후 checkpoint가 필요해졌는지
+     */
+    bool CheckpointDue(std::chrono::steady_clock::time_point last_checkpoint);
+
+public:
+    /**
+     * @brief 스레드를 시작함
+     *
+     * @param delay_ms 회차 사이 간격 (milliseconds)
+     * @param max_pages 회차마다 쓰는 최대 페이지 수
+     * @param checkpoint_interval_s checkpoint 간격 (seconds)
+     * @param checkpoint_wal_size checkpoint를 시작하는 로그 크기 (bytes)
+     */
+    BackgroundWriter(BufferManager *bm, long delay_ms, size_t max_pages, long checkpoint_interval_s,
+                     size_t checkpoint_wal_size);
+
+    /**
+     * @brief 스레드를 멈추고 끝날 때까지 기다림. 남은 dirty 페이지는 BufferManager 소멸자가 씀
+     */
+    ~BackgroundWriter();
+
+    uint64_t pages_written() const { return pages_written_; }
+    uint64_t checkpoints() const { return checkpoints_; }
+};
+
+#endif
@@ -0,0 +1,372 @@
+/**
+ * @brief 저장소·실행 경로 벤치마크 (make bench)
+ * @details 결과는 벤치마크마다 JSON 한 줄(JSON Lines)로 stdout에 쓴다. 릴리스 사이의 결과를 비교하는 데 쓴다.
+ *
+ *          {"benchmark":"page.insert_record","params":{"record_len":64},"iterations":...,"seconds":...,"ns_per_op":...}
+ *
+ *          스캔은 rows(읽은 결과 행 수)와 rows_per_sec도 쓴다. 엔진이 std::cout으로 쓰는 진행 메시지는 결과와 섞이지
+ *          않게 버린다. 설정(page_size, buffer_pool_pages, wal 등)은 엔진과 같이 설정 파일과 환경 변수에서 읽는다.
+ *
+ *          사용법: abc_bench [data path] [scale]
+ *          data path  벤치마크용 데이터 디렉토리 (기본 /tmp/abcdb_bench/, 시작과 끝에 지움)
+ *          scale      행·페이지 수에 곱하는 배수 (기본 1)
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include "api.h"
+#include "buffer_manager.h"
+#include "commons.h"
+#include "config.h"
+#include "file.h"
+#include "page.h"
+
+#define BENCH_DEFAULT_PATH "/tmp/abcdb_bench/"
+#define BENCH_RECORD_LEN 64         // page/file 벤치마크 레코드 길이
+#define BENCH_FILE_PAGES 2048       // file/buffer pool 벤치마크 파일 페이지 수 (scale 1)
+#define BENCH_POOL_PAGES 256        // buffer pool 벤치마크 프레임 수
+#define BENCH_INSERT_BATCH 1000     // 여러 행 INSERT 하나의 행 수
+
+namespace {
+
+/**
+ * @brief 쓰기를 모두 버리는 streambuf (엔진의 진행 메시지용)
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+class Clock {
+private:
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    Clock() : start_(std::chrono::steady_clock::now()) {}
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+};
+
+/**
+ * @brief 결과 한 줄을 씀
+ *
+ * @param params JSON 객체 문자열 (예: {"rows":1000})
+ * @param rows 0이 아니면 rows와 rows_per_sec도 씀
+ */
+void Report(std::ostream &out, const std::string &name, const std::string &params, size_t iterations,
+            double seconds, size_t rows = 0) {
+    char line[512];
+    int n = snprintf(line, sizeof(line),
+                     "{\"benchmark\":\"%s\",\"params\":%s,\"iterations\":%zu,\"seconds\":%.6f,\"ns_per_op\":%.1f",
+                     name.c_str(), params.c_str(), iterations, seconds,
+                     iterations > 0 ? seconds * 1e9 / iterations : 0.0);
+    if (rows > 0) {
+        n += snprintf(line + n, sizeof(line) - n, ",\"rows\":%zu,\"rows_per_sec\":%.0f", rows,
+                      seconds > 0 ? rows / seconds : 0.0);
+    }
+    snprintf(line + n, sizeof(line) - n, "}");
+    out << line << std::endl;
+}
+
+std::string Params(const std::vector<std::pair<std::string, size_t>> &values) {
+    std::ostringstream s;
+    s << "{";
+    for (size_t i = 0; i < values.size(); i++) {
+        s << (i > 0 ? "," : "") << "\"" << values[i].first << "\":" << values[i].second;
+    }
+    s << "}";
+    return s.str();
+}
+
+/**
+ * @brief 재현 가능한 의사 난수 (xorshift64)
+ */
+class Random {
+private:
+    uint64_t state_;
+
+public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+    uint64_t Next() {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 7;
+        state_ ^= state_ << 17;
+        return state_;
+    }
+};
+
+/*=======================================Page================================================ */
+void BenchPageInsert(std::ostream &out, size_t scale) {
+    std::vector<char> record(BENCH_RECORD_LEN, 'r');
+    size_t target = 2000000 * scale;
+    size_t count = 0;
+    double seconds = 0;
+    while (count < target) {
+        Page page("bench", 0);  // 페이지를 채우는 시간만 잼
+        Clock clock;
+        while (count < target && page.HasEnoughSpace(BENCH_RECORD_LEN)) {     // 엔진처럼 공간을 먼저 확인
+            page.InsertRecord(record.data(), BENCH_RECORD_LEN);
+            count++;
+        }
+        seconds += clock.seconds();
+    }
+    Report(out, "page.insert_record", Params({{"record_len", BENCH_RECORD_LEN}}), count, seconds);
+}
+
+/*=======================================File================================================ */
+/**
+ * @brief 파일의 모든 페이지 (dir idx, page idx)
+ */
+std::vector<std::pair<int, int>> PageList(File &file) {
+    std::vector<std::pair<int, int>> pages;
+    for (int d = 0; d < file.GetPageDirCount(); d++) {
+        for (int i = 0; i < file.GetPageDirByIdx(d)->GetSize(); i++) {
+            pages.push_back({d, i});
+        }
+    }
+    return pages;
+}
+
+void BenchFile(std::ostream &out, const std::string &path, size_t pages) {
+    std::vector<char> record(BENCH_RECORD_LEN, 'f');
+    File file(path);
+    Clock append;
+    for (size_t p = 0; p < pages; p++) {
+        Page page(path, 0);
+        while (page.HasEnoughSpace(BENCH_RECORD_LEN)) {
+            page.InsertRecord(record.data(), BENCH_RECORD_LEN);
+        }
+        file.AddPageToDirectory(page);
+    }
+    Report(out, "file.append_page", Params({{"pages", pages}}), pages, append.seconds());
+
+    std::vector<std::pair<int, int>> list = PageList(file);
+    std::vector<std::shared_ptr<Page>> images;
+    Random random(1);
+    std::vector<size_t> order(pages);
+    for (size_t i = 0; i < pages; i++) {
+        order[i] = random.Next() % list.size();
+    }
+
+    // OS page cache에 있는 파일의 임의 위치 읽기·쓰기 (pread/pwrite 한 번씩)
+    Clock read;
+    for (size_t i : order) {
+        images.push_back(file.GetPage(*file.GetPageDirByIdx(list[i].first), list[i].second));
+    }
+    Report(out, "file.read_page", Params({{"pages", pages}}), pages, read.seconds());
+
+    Clock write;
+    for (size_t k = 0; k < order.size(); k++) {
+        file.WritePageToFile(*file.GetPageDirByIdx(list[order[k]].first), *images[k]);
+    }
+    Report(out, "file.write_page", Params({{"pages", pages}}), pages, write.seconds());
+
+    Clock sync;
+    file.Sync();
+    Report(out, "file.sync", Params({{"pages", pages}}), 1, sync.seconds());
+}
+
+/*=======================================BufferPool================================================ */
+void BenchBufferPool(std::ostream &out, const std::string &path, size_t scale) {
+    const std::string policy = Config::Instance().replacement_policy();
+    std::vector<std::pair<int, int>> list;
+    {
+        File file(path);
+        list = PageList(file);
+    }
+    size_t rounds = 200 * scale;
+
+    // 모든 접근이 프레임에 있음
+    {
+        BufferManager bm(policy, BENCH_POOL_PAGES);
+        size_t hot = std::min<size_t>(BENCH_POOL_PAGES / 2, list.size());
+        for (size_t i = 0; i < hot; i++) {
+            bm.GetPage(path, list[i].first, list[i].second);
+        }
+        Clock clock;
+        for (size_t r = 0; r < rounds; r++) {
+            for (size_t i = 0; i < hot; i++) {
+                bm.GetPage(path, list[i].first, list[i].second);
+            }
+        }
+        Report(out, "buffer_pool.hit", Params({{"frames", BENCH_POOL_PAGES}, {"pages", hot}}), rounds * hot,
+               clock.seconds());
+    }
+
+    // 프레임이 남아 있어 내보내지 않는 miss (파일을 처음 한 번 읽음)
+    {
+        BufferManager bm(policy, list.size() + 1);
+        Clock clock;
+        for (const std::pair<int, int> &p : list) {
+            bm.GetPage(path, p.first, p.second);
+        }
+        Report(out, "buffer_pool.miss", Params({{"frames", list.size() + 1}, {"pages", list.size()}}), list.size(),
+               clock.seconds());
+    }
+
+    // 프레임보다 큰 파일을 반복해 읽음. 모든 접근이 miss이고 clean 프레임 하나를 내보냄
+    {
+        BufferManager bm(policy, BENCH_POOL_PAGES);
+        for (const std::pair<int, int> &p : list) {
+            bm.GetPage(path, p.first, p.second);
+        }
+        size_t passes = std::max<size_t>(1, scale * 4);
+        Clock clock;
+        for (size_t r = 0; r < passes; r++) {
+            for (const std::pair<int, int> &p : list) {
+                bm.GetPage(path, p.first, p.second);
+            }
+        }
+        Report(out, "buffer_pool.miss_evict", Params({{"frames", BENCH_POOL_PAGES}, {"pages", list.size()}}),
+               passes * list.size(), clock.seconds());
+    }
+}
+
+/*=======================================ExecutionEngine================================================ */
+void CreateTable(API &api, const std::string &name) {
+    SQLCreateTable st;
+    st.set_tb_name(name);
+    std::vector<Attribute> attrs(3);
+    attrs[0].set_attr_name("num");
+    attrs[0].set_data_type(T_INT);
+    attrs[0].set_length(4);
+    attrs[1].set_attr_name("val");
+    attrs[1].set_data_type(T_FLOAT);
+    attrs[1].set_length(4);
+    attrs[2].set_attr_name("name");
+    attrs[2].set_data_type(T_CHAR);
+    attrs[2].set_length(32);
+    st.set_attrs(attrs);
+    api.CreateTable(st);
+}
+
+std::vector<SQLValue> Row(Random &random, size_t i) {
+    return {{T_INT, std::to_string(random.Next() % 1000)},
+            {T_FLOAT, std::to_string((random.Next() % 100000) / 100.0)},
+            {T_CHAR, "name" + std::to_string(i)}};
+}
+
+/**
+ * @brief rows개 행을 BENCH_INSERT_BATCH개씩 여러 행 INSERT로 넣음
+ */
+void Load(API &api, const std::string &table, size_t rows, Random &random) {
+    for (size_t done = 0; done < rows;) {
+        SQLInsert st;
+        st.set_tb_name(table);
+        std::vector<std::vector<SQLValue>> batch;
+        for (; batch.size() < BENCH_INSERT_BATCH && done < rows; done++) {
+            batch.push_back(Row(random, done));
+        }
+        st.set_rows(batch);
+        api.Insert(st);
+    }
+}
+
+void BenchInsert(std::ostream &out, API &api, size_t scale) {
+    Random random(2);
+    size_t single = 500 * scale;
+    CreateTable(api, "insert_single");
+    Clock one;
+    for (size_t i = 0; i < single; i++) {
+        SQLInsert st;
+        st.set_tb_name("insert_single");
+        st.set_rows({Row(random, i)});
+        api.Insert(st);
+    }
+    Report(out, "engine.insert_single", Params({{"rows", single}}), single, one.seconds());
+
+    size_t bulk = 200000 * scale;
+    CreateTable(api, "insert_bulk");
+    Clock many;
+    Load(api, "insert_bulk", bulk, random);
+    Report(out, "engine.insert_bulk", Params({{"rows", bulk}, {"batch", BENCH_INSERT_BATCH}}), bulk, many.seconds());
+}
+
+/**
+ * @brief SELECT를 repeat번 실행해 결과 행을 모두 꺼냄
+ *
+ * @return 꺼낸 행 수 (repeat번 합)
+ */
+size_t RunSelect(API &api, const std::string &table, const std::vector<SQLWhere> &wheres, size_t repeat) {
+    size_t rows = 0;
+    for (size_t r = 0; r < repeat; r++) {
+        SQLSelect st;
+        st.set_tb_name(table);
+        st.set_wheres(wheres);
+        std::unique_ptr<ResultCursor> cursor = api.OpenSelect(st);
+        while (cursor->Next() != nullptr) {
+            rows++;
+        }
+    }
+    return rows;
+}
+
+void BenchSelect(std::ostream &out, API &api, size_t scale) {
+    Random random(3);
+    for (size_t rows : {1000, 10000, 100000}) {
+        rows *= scale;
+        std::string table = "scan" + std::to_string(rows);
+        CreateTable(api, table);
+        Load(api, table, rows, random);
+        size_t repeat = std::max<size_t>(3, 2000000 * scale / rows);
+        RunSelect(api, table, {}, 1);   // 버퍼 풀을 채움
+
+        Clock all;
+        size_t total = RunSelect(api, table, {}, repeat);
+        Report(out, "engine.select_scan", Params({{"rows", rows}}), repeat, all.seconds(), total);
+
+        Clock where;
+        total = RunSelect(api, table, {{"num", SIGN_LT, "100"}}, repeat);      // 약 10%
+        Report(out, "engine.select_where", Params({{"rows", rows}, {"selectivity_pct", 10}}), repeat,
+               where.seconds(), total);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::string path = argc > 1 ? argv[1] : BENCH_DEFAULT_PATH;
+    if (path.back() != '/') {
+        path += "/";
+    }
+    size_t scale = argc > 2 ? std::max(1, atoi(argv[2])) : 1;
+
+    std::ostream out(std::cout.rdbuf());
+    NullBuffer null;
+    std::cout.rdbuf(&null);     // 엔진의 진행 메시지를 버림
+
+    boost::filesystem::remove_all(path);
+    boost::filesystem::create_directories(path);
+    Config::Instance().Load(path);
+
+    BenchPageInsert(out, scale);
+    std::string file = path + "bench_file.bin";
+    BenchFile(out, file, BENCH_FILE_PAGES * scale);
+    BenchBufferPool(out, file, scale);
+    boost::filesystem::remove(file);
+
+    {
+        API api(path);
+        SQLCreateDatabase db;
+        db.set_db_name("bench");
+        api.CreateDatabase(db);
+        SQLUse use;
+        use.set_db_name("bench");
+        api.Use(use);
+        BenchInsert(out, api, scale);
+        BenchSelect(out, api, scale);
+    }
+    boost::filesystem::remove_all(path);
+    std::cout.rdbuf(out.rdbuf());
+    return 0;
+}
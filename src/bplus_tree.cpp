@@ -0,0 +1,326 @@
+#include "bplus_tree.h"
+
+#include <cstring>
+#include <vector>
+
+#include "sql_statement.h"
+
+#define NODE_HEADER_SIZE sizeof(NodeHeader)
+
+namespace {
+
+/**
+ * @brief 노드를 다루는 동안 페이지를 버퍼 풀에 고정하고, 끝나면 고정을 풂
+ */
+class NodePin {
+private:
+    std::shared_ptr<Page> page_;
+
+public:
+    explicit NodePin(const std::shared_ptr<Page> &page) : page_(page) {
+        page_->Pin();
+    }
+    ~NodePin() { page_->Unpin(); }
+};
+
+int64_t NodeNo(const Page &page) {
+    return static_cast<int64_t>(page.GetDirIdx()) * PageDirectory::MaxEntries() + page.GetPageIdx();
+}
+
+}  // namespace
+
+/*=======================================BPlusTree================================================ */
+BPlusTree::BPlusTree(BufferManager *bm, const std::string &file_name, int key_type, int key_len)
+    : bm_(bm), file_name_(file_name), key_type_(key_type), key_len_(key_len),
+      entry_size_(key_len + sizeof(RecordId)), root_(-1) {
+    size_t area = Config::Instance().page_size() - HEADER_SIZE - NODE_HEADER_SIZE;
+    leaf_max_ = static_cast<int>(area / entry_size_);
+    internal_max_ = static_cast<int>((area - sizeof(int64_t)) / (entry_size_ + sizeof(int64_t)));
+    if (leaf_max_ < 3 || internal_max_ < 3) {
+        throw BPlusTreeException();  // key가 너무 커서 노드에 엔트리 3개가 들어가지 않음
+    }
+
+    File *file = bm_->GetFile(file_name_);
+    if (file->GetPageDirByIdx(0)->GetSize() == 0) {
+        int64_t meta_no, root_no;
+        NodePin meta(NewNode(false, &meta_no));
+        NewNode(true, &root_no);
+        root_ = root_no;
+        WriteMeta();
+        return;
+    }
+
+    std::shared_ptr<Page> meta = bm_->GetPage(file_name_, 0, 0);
+    IndexMeta m;
+    std::memcpy(&m, meta->GetRawData() + HEADER_SIZE, sizeof(IndexMeta));
+    if (m.magic != INDEX_META_MAGIC || m.key_type != key_type_ || m.key_len != key_len_) {
+        throw BPlusTreeException();
+    }
+    root_ = m.root;
+}
+
+void BPlusTree::WriteMeta() {
+    std::shared_ptr<Page> meta = bm_->GetPage(file_name_, 0, 0);
+    IndexMeta m = {INDEX_META_MAGIC, key_type_, key_len_, 0, root_};
+    std::memcpy(meta->GetRawData() + HEADER_SIZE, &m, sizeof(IndexMeta));
+    meta->SetDirty(true);
+}
+
+std::shared_ptr<Page> BPlusTree::GetNode(int64_t node_no) const {
+    int dir_idx = static_cast<int>(node_no / PageDirectory::MaxEntries());
+    int page_idx = static_cast<int>(node_no % PageDirectory::MaxEntries());
+    std::shared_ptr<Page> page = bm_->GetPage(file_name_, dir_idx, page_idx);
+    if (page == nullptr || Header(*page)->magic != INDEX_NODE_MAGIC) {
+        throw BPlusTreeException();
+    }
+    return page;
+}
+
+std::shared_ptr<Page> BPlusTree::NewNode(bool leaf, int64_t *node_no) {
+    std::shared_ptr<Page> page = bm_->NewPage(file_name_);
+    NodeHeader header = {INDEX_NODE_MAGIC, static_cast<uint16_t>(leaf ? 1 : 0), 0, 0, 0, -1};
+    std::memcpy(page->GetRawData() + HEADER_SIZE, &header, sizeof(NodeHeader));
+    *node_no = NodeNo(*page);
+    return page;
+}
+
+NodeHeader *BPlusTree::Header(Page &page) {
+    return reinterpret_cast<NodeHeader *>(page.GetRawData() + HEADER_SIZE);
+}
+
+char *BPlusTree::LeafEntry(Page &page, int i) const {
+    return page.GetRawData() + HEADER_SIZE + NODE_HEADER_SIZE + i * entry_size_;
+}
+
+char *BPlusTree::InternalChild(Page &page, int i) const {
+    return page.GetRawData() + HEADER_SIZE + NODE_HEADER_SIZE + i * sizeof(int64_t);
+}
+
+char *BPlusTree::InternalKey(Page &page, int i) const {
+    return InternalChild(page, internal_max_ + 1) + i * entry_size_;
+}
+
+int64_t BPlusTree::ChildAt(Page &page, int i) const {
+    int64_t child;
+    std::memcpy(&child, InternalChild(page, i), sizeof(int64_t));
+    return child;
+}
+
+int BPlusTree::CompareKey(const char *a, const char *b) const {
+    TKeyView x(key_type_, a, key_len_), y(key_type_, b, key_len_);
+    if (x < y) return -1;
+    if (y < x) return 1;
+    return 0;
+}
+
+int BPlusTree::CompareEntry(const char *a, const char *b) const {
+    int c = CompareKey(a, b);
+    if (c != 0) {
+        return c;
+    }
+    RecordId x, y;
+    std::memcpy(&x, a + key_len_, sizeof(RecordId));
+    std::memcpy(&y, b + key_len_, sizeof(RecordId));
+    if (x.dir_idx != y.dir_idx) return x.dir_idx < y.dir_idx ? -1 : 1;
+    if (x.page_idx != y.page_idx) return x.page_idx < y.page_idx ? -1 : 1;
+    if (x.slot_no != y.slot_no) return x.slot_no < y.slot_no ? -1 : 1;
+    return 0;
+}
+
+bool BPlusTree::InsertInto(int64_t node_no, const char *entry, char *sep, int64_t *new_node) {
+    std::shared_ptr<Page> page = GetNode(node_no);
+    NodePin pin(page);
+    NodeHeader *header = Header(*page);
+    int count = header->count;
+
+    if (header->is_leaf) {
+        int lo = 0, hi = count;  // entry 이상인 첫 위치
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (CompareEntry(LeafEntry(*page, mid), entry) < 0) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo < count && CompareEntry(LeafEntry(*page, lo), entry) == 0) {
+            return false;
+        }
+        page->SetDirty(true);
+        if (count < leaf_max_) {
+            std::memmove(LeafEntry(*page, lo + 1), LeafEntry(*page, lo), (count - lo) * entry_size_);
+            std::memcpy(LeafEntry(*page, lo), entry, entry_size_);
+            header->count++;
+            return false;
+        }
+
+        // 분할: 엔트리 count + 1개를 반씩 나눔
+        std::vector<char> all((count + 1) * entry_size_);
+        std::memcpy(all.data(), LeafEntry(*page, 0), lo * entry_size_);
+        std::memcpy(all.data() + lo * entry_size_, entry, entry_size_);
+        std::memcpy(all.data() + (lo + 1) * entry_size_, LeafEntry(*page, lo), (count - lo) * entry_size_);
+        int total = count + 1;
+        int left = total / 2;
+
+        std::shared_ptr<Page> right = NewNode(true, new_node);
+        NodeHeader *right_header = Header(*right);
+        std::memcpy(LeafEntry(*page, 0), all.data(), left * entry_size_);
+        std::memcpy(LeafEntry(*right, 0), all.data() + left * entry_size_, (total - left) * entry_size_);
+        header->count = left;
+        right_header->count = total - left;
+        right_header->next = header->next;
+        header->next = *new_node;
+        std::memcpy(sep, LeafEntry(*right, 0), entry_size_);
+        return true;
+    }
+
+    int lo = 0, hi = count;  // entry보다 큰 첫 separator 위치 == 내려갈 child
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (CompareEntry(InternalKey(*page, mid), entry) <= 0) lo = mid + 1;
+        else hi = mid;
+    }
+    std::vector<char> child_sep(entry_size_);
+    int64_t child_new;
+    if (!InsertInto(ChildAt(*page, lo), entry, child_sep.data(), &child_new)) {
+        return false;
+    }
+
+    // child가 분할됨: separator를 lo에, 새 child를 lo + 1에 넣음
+    page->SetDirty(true);
+    if (count < internal_max_) {
+        std::memmove(InternalKey(*page, lo + 1), InternalKey(*page, lo), (count - lo) * entry_size_);
+        std::memcpy(InternalKey(*page, lo), child_sep.data(), entry_size_);
+        std::memmove(InternalChild(*page, lo + 2), InternalChild(*page, lo + 1), (count - lo) * sizeof(int64_t));
+        std::memcpy(InternalChild(*page, lo + 1), &child_new, sizeof(int64_t));
+        header->count++;
+        return false;
+    }
+
+    // 분할: separator count + 1개 중 가운데를 부모로 올림
+    int total = count + 1;
+    std::vector<char> keys(total * entry_size_);
+    std::vector<int64_t> children(total + 1);
+    std::memcpy(keys.data(), InternalKey(*page, 0), lo * entry_size_);
+    std::memcpy(keys.data() + lo * entry_size_, child_sep.data(), entry_size_);
+    std::memcpy(keys.data() + (lo + 1) * entry_size_, InternalKey(*page, lo), (count - lo) * entry_size_);
+    std::memcpy(children.data(), InternalChild(*page, 0), (lo + 1) * sizeof(int64_t));
+    children[lo + 1] = child_new;
+    std::memcpy(children.data() + lo + 2, InternalChild(*page, lo + 1), (count - lo) * sizeof(int64_t));
+    int mid = total / 2;
+
+    std::shared_ptr<Page> right = NewNode(false, new_node);
+    NodeHeader *right_header = Header(*right);
+    std::memcpy(InternalKey(*page, 0), keys.data(), mid * entry_size_);
+    std::memcpy(InternalChild(*page, 0), children.data(), (mid + 1) * sizeof(int64_t));
+    std::memcpy(InternalKey(*right, 0), keys.data() + (mid + 1) * entry_size_, (total - mid - 1) * entry_size_);
+    std::memcpy(InternalChild(*right, 0), children.data() + mid + 1, (total - mid) * sizeof(int64_t));
+    header->count = mid;
+    right_header->count = total - mid - 1;
+    std::memcpy(sep, keys.data() + mid * entry_size_, entry_size_);
+    return true;
+}
+
+void BPlusTree::Insert(const char *key, const RecordId &rid) {
+    std::vector<char> entry(entry_size_);
+    std::memcpy(entry.data(), key, key_len_);
+    std::memcpy(entry.data() + key_len_, &rid, sizeof(RecordId));
+
+    std::vector<char> sep(entry_size_);
+    int64_t new_node;
+    if (!InsertInto(root_, entry.data(), sep.data(), &new_node)) {
+        return;
+    }
+
+    // root가 분할됨: 높이가 1 늘어남
+    int64_t new_root;
+    std::shared_ptr<Page> page = NewNode(false, &new_root);
+    Header(*page)->count = 1;
+    std::memcpy(InternalChild(*page, 0), &root_, sizeof(int64_t));
+    std::memcpy(InternalChild(*page, 1), &new_node, sizeof(int64_t));
+    std::memcpy(InternalKey(*page, 0), sep.data(), entry_size_);
+    root_ = new_root;
+    WriteMeta();
+}
+
+void BPlusTree::Begin(BPlusTreeIterator *it) const {
+    std::shared_ptr<Page> page = GetNode(root_);
+    while (!Header(*page)->is_leaf) {
+        page = GetNode(ChildAt(*page, 0));
+    }
+    *it = BPlusTreeIterator();
+    it->tree_ = this;
+    it->leaf_ = page;
+    it->pos_ = 0;
+    page->Pin();
+    it->Settle();
+}
+
+void BPlusTree::LowerBound(const char *key, BPlusTreeIterator *it) const {
+    std::shared_ptr<Page> page = GetNode(root_);
+    while (!Header(*page)->is_leaf) {
+        int lo = 0, hi = Header(*page)->count;  // key 미만인 separator 수
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (CompareKey(InternalKey(*page, mid), key) < 0) lo = mid + 1;
+            else hi = mid;
+        }
+        page = GetNode(ChildAt(*page, lo));
+    }
+    int lo = 0, hi = Header(*page)->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (CompareKey(LeafEntry(*page, mid), key) < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    *it = BPlusTreeIterator();
+    it->tree_ = this;
+    it->leaf_ = page;
+    it->pos_ = lo;
+    page->Pin();
+    it->Settle();
+}
+
+/*=======================================BPlusTreeIterator================================================ */
+BPlusTreeIterator &BPlusTreeIterator::operator=(BPlusTreeIterator &&other) {
+    if (this != &other) {
+        Release();
+        tree_ = other.tree_;
+        leaf_ = std::move(other.leaf_);
+        pos_ = other.pos_;
+        other.leaf_.reset();
+    }
+    return *this;
+}
+
+void BPlusTreeIterator::Release() {
+    if (leaf_) {
+        leaf_->Unpin();
+        leaf_.reset();
+    }
+}
+
+void BPlusTreeIterator::Settle() {
+    while (leaf_ && pos_ >= BPlusTree::Header(*leaf_)->count) {
+        int64_t next = BPlusTree::Header(*leaf_)->next;
+        Release();
+        if (next < 0) {
+            return;
+        }
+        leaf_ = tree_->GetNode(next);
+        leaf_->Pin();
+        pos_ = 0;
+    }
+}
+
+const char *BPlusTreeIterator::key() const {
+    return tree_->LeafEntry(*leaf_, pos_);
+}
+
+RecordId BPlusTreeIterator::rid() const {
+    RecordId rid;
+    std::memcpy(&rid, tree_->LeafEntry(*leaf_, pos_) + tree_->key_len_, sizeof(RecordId));
+    return rid;
+}
+
+void BPlusTreeIterator::Next() {
+    pos_++;
+    Settle();
+}
@@ -0,0 +1,149 @@
+#ifndef ABCDB_BPLUS_TREE_H_
+#define ABCDB_BPLUS_TREE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "buffer_manager.h"
+#include "exceptions.h"
+
+#define INDEX_META_MAGIC 0x4d584449  // "IDXM"
+#define INDEX_NODE_MAGIC 0x4e584449  // "IDXN"
+
+/**
+ * @brief 레코드 위치. 테이블 파일의 (디렉토리 index, 페이지 index, 슬롯 번호)
+ */
+struct RecordId {
+    int32_t dir_idx;
+    int32_t page_idx;
+    int32_t slot_no;
+};
+
+/**
+ * @brief 인덱스 파일의 첫 노드(node 0)에 기록되는 메타 정보
+ */
+struct IndexMeta {
+    uint32_t magic;
+    int32_t key_type;
+    int32_t key_len;
+    int32_t reserved;
+    int64_t root;       // root 노드 번호
+};
+
+/**
+ * @brief 노드 헤더. 노드는 페이지 data_의 HEADER_SIZE 뒤에 저장됨
+ */
+struct NodeHeader {
+    uint32_t magic;
+    uint16_t is_leaf;
+    uint16_t reserved;
+    int32_t count;      // 엔트리(leaf) 또는 separator(internal) 수
+    int32_t reserved2;
+    int64_t next;       // 다음 leaf 노드 번호 (없으면 -1)
+};
+
+class BPlusTree;
+
+/**
+ * @brief leaf 노드를 key 순서대로 따라가는 iterator. 현재 leaf 페이지를 버퍼 풀에 고정함
+ */
+class BPlusTreeIterator {
+private:
+    friend class BPlusTree;
+
+    const BPlusTree *tree_;
+    std::shared_ptr<Page> leaf_;    // nullptr이면 끝
+    int pos_;
+
+    /**
+     * @brief pos_가 leaf 끝을 넘었으면 다음 leaf로 이동
+     */
+    void Settle();
+    void Release();
+
+public:
+    BPlusTreeIterator() : tree_(nullptr), pos_(0) {}
+    BPlusTreeIterator(const BPlusTreeIterator &) = delete;
+    BPlusTreeIterator &operator=(const BPlusTreeIterator &) = delete;
+    BPlusTreeIterator &operator=(BPlusTreeIterator &&other);
+    ~BPlusTreeIterator() { Release(); }
+
+    bool Valid() const { return leaf_ != nullptr; }
+    const char *key() const;
+    RecordId rid() const;
+    void Next();
+};
+
+/**
+ * @brief 인덱스 파일에 저장되는 B+Tree
+ * @details 노드 하나가 인덱스 파일의 페이지 하나이며, 노드 번호는 (dir idx * PageDirectory::MaxEntries() + page idx)이다.
+ *          노드는 BufferManager를 통해 읽고 쓰므로 테이블 페이지와 같은 버퍼 풀을 쓴다.
+ *
+ *          엔트리는 (key, RecordId)이고 이 둘을 합친 값으로 정렬하므로 같은 key가 여러 번 들어갈 수 있다.
+ *          internal 노드는 children[0..count]과 separator[0..count-1]를, leaf 노드는 엔트리 배열과 다음 leaf 번호를 가진다.
+ */
+class BPlusTree {
+private:
+    friend class BPlusTreeIterator;
+
+    BufferManager *bm_;
+    std::string file_name_;
+    int key_type_;
+    int key_len_;
+    size_t entry_size_;     // key_len + sizeof(RecordId)
+    int leaf_max_;          // leaf 노드 최대 엔트리 수
+    int internal_max_;      // internal 노드 최대 separator 수
+    int64_t root_;
+
+    std::shared_ptr<Page> GetNode(int64_t node_no) const;
+    std::shared_ptr<Page> NewNode(bool leaf, int64_t *node_no);
+    void WriteMeta();
+
+    static NodeHeader *Header(Page &page);
+    char *LeafEntry(Page &page, int i) const;
+    char *InternalKey(Page &page, int i) const;
+    char *InternalChild(Page &page, int i) const;
+    int64_t ChildAt(Page &page, int i) const;
+
+    int CompareKey(const char *a, const char *b) const;
+    int CompareEntry(const char *a, const char *b) const;
+
+    /**
+     * @brief node_no 아래에 entry 삽입
+     *
+     * @param sep 노드가 분할되면 새 노드의 첫 엔트리(separator)가 기록됨
+     * @param new_node 노드가 분할되면 새 노드 번호
+     * @return true 노드가 분할됨
+     */
+    bool InsertInto(int64_t node_no, const char *entry, char *sep, int64_t *new_node);
+
+public:
+    /**
+     * @brief 인덱스 파일을 열고, 비어 있으면 메타 노드와 빈 root leaf를 만듦
+     *
+     * @throw BPlusTreeException 파일의 메타 정보가 key 타입/길이와 맞지 않거나 노드 크기가 너무 작음
+     */
+    BPlusTree(BufferManager *bm, const std::string &file_name, int key_type, int key_len);
+
+    /**
+     * @brief (key, rid) 삽입. 이미 같은 엔트리가 있으면 무시
+     *
+     * @param key key_len 바이트 key (레코드 안의 값)
+     */
+    void Insert(const char *key, const RecordId &rid);
+
+    /**
+     * @brief 가장 작은 엔트리부터 순회
+     */
+    void Begin(BPlusTreeIterator *it) const;
+
+    /**
+     * @brief key 이상인 첫 엔트리부터 순회
+     */
+    void LowerBound(const char *key, BPlusTreeIterator *it) const;
+
+    int key_type() const { return key_type_; }
+    int key_len() const { return key_len_; }
+};
+
+#endif
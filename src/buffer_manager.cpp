@@ -1,43 +1,259 @@
 #include "buffer_manager.h"
+#include <algorithm>
+#include <cstdio>
 #include <string>
+#include <unistd.h>
+#include "metrics.h"
 /**
  * @brief 버퍼 매니저가 소멸할 때 디스크로 작성.
  */
 BufferManager::~BufferManager()
 {
-    
-    bufferPool->TraverseBufferPoolVoid([this](const std::shared_ptr<Page> &page) -> void {
+    prefetcher_.reset();    // I/O 스레드가 버퍼 풀을 쓰지 않게 먼저 멈춤
+    Checkpoint();
+    delete bufferPool;
+    files_.clear();
+}
+
+void BufferManager::SortByOffset(std::vector<std::shared_ptr<Page>> &pages)
+{
+    auto offset = [this](const std::shared_ptr<Page> &page) -> size_t {
+        std::shared_ptr<PageDirectory> dir = GetFile(page->GetFilename())->GetPageDirByIdx(page->GetDirIdx());
+        if (dir == nullptr || page->GetPageIdx() < 0 || page->GetPageIdx() >= dir->GetSize())
+        {
+            return 0;
+        }
+        return dir->GetEntries()[page->GetPageIdx()].offset;
+    };
+    std::vector<std::pair<std::pair<std::string, size_t>, std::shared_ptr<Page>>> keyed;
+    keyed.reserve(pages.size());
+    for (const std::shared_ptr<Page> &page : pages)
+    {
+        keyed.push_back({{page->GetFilename(), offset(page)}, page});
+    }
+    std::sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    for (size_t i = 0; i < keyed.size(); i++)
+    {
+        pages[i] = keyed[i].second;
+    }
+}
+
+size_t BufferManager::WriteDirtyPages(size_t max_pages, bool all)
+{
+    // 파일, 위치 순서로 써서 디스크 접근을 순차에 가깝게 하고, 로그는 가장 큰 페이지 LSN까지 한 번만 내림
+    std::vector<std::shared_ptr<Page>> dirty;
+    bufferPool->TraverseBufferPoolVoid([&](const std::shared_ptr<Page> &page) -> void {
         if (page->IsDirty())
         {
-            File file(page->GetFilename());
-            auto dir = file.GetPageDir(0); // TODO : DIR INDEX가 달라질 수도 있음
-            FlushPageToDisk(*dir, page); 
+            dirty.push_back(page);
         }
     });
-    delete bufferPool;
+    SortByOffset(dirty);
+    if (!all && dirty.size() > max_pages)
+    {
+        dirty.resize(max_pages);    // 파일 위치 순서로 앞에서부터 조금씩 씀
+    }
+    uint64_t max_lsn = 0;
+    for (const std::shared_ptr<Page> &page : dirty)
+    {
+        max_lsn = std::max(max_lsn, page->GetLsn());
+    }
+    if (wal_ && max_lsn > 0)
+    {
+        wal_->Flush(max_lsn);
+    }
+    for (const std::shared_ptr<Page> &page : dirty)
+    {
+        WritePage(page);    // 로그는 위에서 이미 내림
+    }
+    return dirty.size();
+}
+
+void BufferManager::Checkpoint()
+{
+    WriteDirtyPages(0, true);
+    if (!wal_)
+    {
+        return;
+    }
+    {
+        std::shared_lock<std::shared_mutex> lock(files_mutex_);
+        for (auto &file : files_)
+        {
+            file.second->Sync();
+        }
+    }
+    wal_->Truncate();
+}
+
+void BufferManager::Commit()
+{
+    if (wal_)
+    {
+        wal_->FlushAll();
+    }
+}
+
+void BufferManager::LogReindex(const std::string &fileName)
+{
+    if (wal_)
+    {
+        wal_->Flush(wal_->AppendReindex(fileName));
+    }
+}
+
+std::set<std::string> BufferManager::Recover()
+{
+    std::set<std::string> touched;
+    if (!wal_)
+    {
+        return touched;
+    }
+    wal_->Replay([&](const WalRecord &record) {
+        touched.insert(record.file);
+        if (record.type == WAL_INSERT)
+        {
+            RedoInsert(record);
+        }
+    });
+    if (!touched.empty())
+    {
+        std::cout << "[Recovery] replayed log up to LSN " << wal_->next_lsn() - 1 << std::endl;
+        Checkpoint();
+    }
+    return touched;
+}
+
+void BufferManager::RedoInsert(const WalRecord &record)
+{
+    if (access(record.file.c_str(), F_OK) != 0)
+    {
+        return; // 그 뒤에 삭제된 파일
+    }
+    File *file = GetFile(record.file);
+    std::shared_ptr<PageDirectory> dir = file->GetPageDirByIdx(record.dir_idx);
+    if (dir == nullptr || record.page_idx < 0 || record.page_idx >= dir->GetSize())
+    {
+        std::cerr << "[Recovery] page not found: " << record.file << " " << record.dir_idx << "/" << record.page_idx << std::endl;
+        return;
+    }
+    std::shared_ptr<Page> page = GetPage(record.file, record.dir_idx, record.page_idx);
+    if (page->GetLsn() >= record.lsn)
+    {
+        file->UpdateEntry(*page);   // 페이지는 디스크에 있지만 디렉토리 entry(zone map)는 이전 것일 수 있음
+        return; // 이미 디스크에 반영됨
+    }
+    if (page->GetSlotCount() != record.slot_no ||
+        !page->InsertRecord(record.data.data(), static_cast<int>(record.data.size())))
+    {
+        std::cerr << "[Recovery] cannot redo LSN " << record.lsn << " on " << record.file << std::endl;
+        return;
+    }
+    page->SetLsn(record.lsn);
+    page->SetDirty(true);
+    file->UpdateEntry(*page);
+}
+
+void BufferManager::EnablePrefetch(size_t distance)
+{
+    prefetch_distance_ = std::min(distance, bufferPool->GetCapacity() / 4);
+    if (prefetch_distance_ > 0 && !prefetcher_)
+    {
+        prefetcher_.reset(new Prefetcher(this, PREFETCH_THREADS));
+    }
+}
+
+void BufferManager::Prefetch(const std::string &fileName, const std::vector<std::pair<int, int>> &pages,
+                             const std::shared_ptr<ScanRing> &ring)
+{
+    if (!prefetcher_)
+    {
+        return;
+    }
+    std::vector<std::pair<int, int>> missing;   // 이미 있는 페이지는 I/O 스레드로 넘기지 않음
+    for (const std::pair<int, int> &page : pages)
+    {
+        if (!IsResident(fileName, page.first, page.second, ring.get()))
+        {
+            missing.push_back(page);
+        }
+    }
+    prefetcher_->Request(fileName, missing, ring);
+}
+
+bool BufferManager::IsResident(const std::string &fileName, int dirIdx, int pageIdx, ScanRing *ring)
+{
+    PageKey key{bufferPool->GetFileId(fileName), dirIdx, pageIdx};
+    return bufferPool->Contains(key) || (ring != nullptr && ring->Contains(key));
 }
+
+void BufferManager::EnableScanRing(size_t pages)
+{
+    scan_ring_pages_ = pages;
+}
+
+std::shared_ptr<ScanRing> BufferManager::ScanStrategy(size_t tablePages)
+{
+    if (scan_ring_pages_ == 0 || tablePages <= bufferPool->GetCapacity() / SCAN_RING_DIVISOR)
+    {
+        return nullptr;
+    }
+    // 미리 읽은 페이지가 스캔이 닿기 전에 밀려나지 않게 read-ahead 거리보다 크게 잡음
+    return std::make_shared<ScanRing>(std::max(scan_ring_pages_, 2 * prefetch_distance_));
+}
+
+File *BufferManager::GetFile(const std::string &fileName)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(files_mutex_);
+        auto it = files_.find(fileName);
+        if (it != files_.end())
+        {
+            return it->second.get();
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(files_mutex_);
+    auto it = files_.find(fileName);    // 다른 세션이 먼저 열었을 수 있음
+    if (it != files_.end())
+    {
+        return it->second.get();
+    }
+    File *file = new File(fileName, Config::Instance().read_only());
+    files_.emplace(fileName, std::unique_ptr<File>(file));
+    return file;
+}
+void BufferManager::DropFile(const std::string &fileName)
+{
+    bufferPool->RemoveFile(fileName);
+    {
+        std::unique_lock<std::shared_mutex> lock(files_mutex_);
+        files_.erase(fileName);
+    }
+    std::remove(fileName.c_str());
+}
+
 /**
  * @brief 디스크에서 페이지를 가져오고 버퍼 풀에 삽입하는 함수
  * 
  * @details 파일 내부 Page는 Page Directory로 관리되며 Page Directory는 배열로 이루어짐.
  *         배열은 Page Directory Entry로 이루어져 있으며 각 Page Directory Entry는 Page의 offset을 가지고 있음. 
  *         PageDirectory -> PageEntry -> Page로 접근 하는 과정을 거침.
+ * @param fileName 가져올 페이지가 속한 파일 이름
  * @param dir 가져올 페이지가 속한 디렉토리
  * @param pageIdx 가져올 페이지의 인덱스. Page Directory Entry의 인덱스
  * @return 디스크에서 가져온 페이지의 스마트 포인터
  */
-std::shared_ptr<Page> BufferManager::GetPageFromDisk(PageDirectory &dir,unsigned int pageIdx)
+std::shared_ptr<Page> BufferManager::GetPageFromDisk(const std::string &fileName, PageDirectory &dir, unsigned int pageIdx)
 {
-    std::cout<<"[Get Page From Disk]"<<std::endl;
-    if (pageIdx < 0)
+    std::shared_ptr<Page>diskPage=GetFile(fileName)->GetPage(dir,pageIdx);
+    std::shared_ptr<Page> evicted;
+    std::shared_ptr<Page> page = bufferPool->InsertPage(diskPage, &evicted); // 버퍼 풀에 페이지 삽입 (다른 세션이 먼저 넣었으면 그 프레임)
+    if (evicted && evicted->IsDirty()) // 내보낸 페이지가 변경되었으면 디스크에 반영
     {
-        std::cerr << "잘못된 페이지 인덱스" << std::endl;
-        return nullptr;
+        FlushPage(evicted);
+        bufferPool->FinishEviction(evicted);
     }
-    File file(file_);
-    std::shared_ptr<Page>diskPage=file.GetPage(dir,pageIdx);
-    bufferPool->InsertPage(diskPage); // 버퍼 풀에 페이지 삽입
-    return diskPage;
+    return page;
 }
 
 
@@ -45,49 +261,123 @@ std::shared_ptr<Page> BufferManager::GetPageFromDisk(PageDirectory &dir,unsigned
  * @brief 버퍼 풀에서 페이지를 가져오는 함수
  * 
  * @param fileName 가져올 페이지가 속한 파일 이름
+ * @param dirIdx 가져올 페이지가 속한 디렉토리의 인덱스
  * @param pageIdx 가져올 페이지의 인덱스
  */
-std::shared_ptr<Page> BufferManager::GetPageFromBufferPool(std::string fileName,unsigned int pageIdx)
+std::shared_ptr<Page> BufferManager::GetPageFromBufferPool(const std::string &fileName, int dirIdx, unsigned int pageIdx)
 {   
-    std::cout << "[Get Page From BufferPool]" << std::endl;
-    return bufferPool->TraverseBufferPool
-    ([=](std::shared_ptr<Page> page) -> std::shared_ptr<Page> 
+    PageKey key{bufferPool->GetFileId(fileName), dirIdx, static_cast<int>(pageIdx)};
+    return bufferPool->FindPage(key);
+}
+
+std::shared_ptr<Page> BufferManager::GetPage(const std::string &fileName, int dirIdx, unsigned int pageIdx)
+{
+    std::shared_ptr<Page> page = GetPageFromBufferPool(fileName, dirIdx, pageIdx);
+    if (page)
+    {
+        Metrics::Instance().Add(Metrics::BUFFER_HITS);
+        return page;
+    }
+    Metrics::Instance().Add(Metrics::BUFFER_MISSES);
+    std::shared_ptr<PageDirectory> dir = GetFile(fileName)->GetPageDirByIdx(dirIdx);
+    if (dir == nullptr)
     {
-        if (page->GetPageIdx() == pageIdx && page->GetFilename() == fileName)
-        {
-            return page;
-        }
         return nullptr;
-    });
+    }
+    return GetPageFromDisk(fileName, *dir, pageIdx);
 }
 
-/**
- * @brief 버퍼 풀에서 여유 공간이 있는 페이지를 가져오는 함수
- * 
- */
-std::shared_ptr<Page> BufferManager::GetEnoughSpacePage(std::string path, int length)
-{   
-    std::cout<<"[Get Enough Page From BufferPool]"<<std::endl;
-    return bufferPool->TraverseBufferPool
-    ([=](std::shared_ptr<Page> page) -> std::shared_ptr<Page> 
+std::shared_ptr<Page> BufferManager::GetPage(const std::string &fileName, int dirIdx, unsigned int pageIdx, ScanRing *ring)
+{
+    if (ring == nullptr)
+    {
+        return GetPage(fileName, dirIdx, pageIdx);
+    }
+    PageKey key{bufferPool->GetFileId(fileName), dirIdx, static_cast<int>(pageIdx)};
+    std::shared_ptr<Page> page = bufferPool->FindPage(key);    // dirty일 수 있으므로 버퍼 풀이 먼저
+    if (page)
+    {
+        Metrics::Instance().Add(Metrics::BUFFER_HITS);
+        return page;
+    }
+    page = ring->Get(key);
+    if (page)
+    {
+        Metrics::Instance().Add(Metrics::SCAN_RING_HITS);
+        return page;
+    }
+    Metrics::Instance().Add(Metrics::BUFFER_MISSES);
+    std::shared_ptr<PageDirectory> dir = GetFile(fileName)->GetPageDirByIdx(dirIdx);
+    if (dir == nullptr)
     {
-        if (page->HasEnoughSpace(length) && page->GetFilename() == path)
-        {
-            return page;
-        }
         return nullptr;
-    });
+    }
+    page = ReadIntoRing(fileName, *dir, key, ring);
+    if (page)
+    {
+        return page;
+    }
+    return GetFile(fileName)->GetPage(*dir, pageIdx);  // ring의 프레임이 모두 쓰이는 중. 스캔이 다음 페이지로 넘어가면 버려짐
 }
 
-/**
- * @brief page를 디스크로 내려 쓰게 하는 함수
- * @param dir 페이지가 속한 디렉토리
- * @param page 내려 쓸 페이지
-*/
-void BufferManager::FlushPageToDisk(PageDirectory dir, const std::shared_ptr<Page> &page)
+std::shared_ptr<Page> BufferManager::ReadIntoRing(const std::string &fileName, PageDirectory &dir, const PageKey &key, ScanRing *ring)
+{
+    File *file = GetFile(fileName);
+    return ring->Load(key, [file, &dir, &key](Page &frame) { file->ReadPage(dir, key.page_idx, frame); });
+}
+
+bool BufferManager::LoadIntoRing(const std::string &fileName, int dirIdx, int pageIdx, const std::shared_ptr<ScanRing> &ring)
+{
+    if (IsResident(fileName, dirIdx, pageIdx, ring.get()))
+    {
+        return false;
+    }
+    std::shared_ptr<PageDirectory> dir = GetFile(fileName)->GetPageDirByIdx(dirIdx);
+    if (dir == nullptr)
+    {
+        return false;
+    }
+    return ReadIntoRing(fileName, *dir, PageKey{bufferPool->GetFileId(fileName), dirIdx, pageIdx}, ring.get()) != nullptr;
+}
+
+std::shared_ptr<Page> BufferManager::NewPage(const std::string &fileName, const PageFormat &format)
+{
+    std::shared_ptr<Page> page = std::make_shared<Page>(fileName, 0);
+    page->SetFilename(fileName);
+    page->ApplyFormat(format);  // 복구가 디스크의 빈 페이지에 행을 다시 넣으므로 등록 전에 형식을 정함
+    GetFile(fileName)->AddPageToDirectory(*page);
+    page->SetDirty(true); // 아직 디스크에 내용이 기록되지 않음
+    std::shared_ptr<Page> evicted;
+    bufferPool->InsertPage(page, &evicted);
+    if (evicted && evicted->IsDirty())
+    {
+        FlushPage(evicted);
+        bufferPool->FinishEviction(evicted);
+    }
+    return page;
+}
+
+void BufferManager::WritePage(const std::shared_ptr<Page> &page)
+{
+    File *f = GetFile(page->GetFilename());
+    std::shared_ptr<PageDirectory> dir = f->GetPageDirByIdx(page->GetDirIdx());
+    if (dir == nullptr)
+    {
+        std::cerr << "페이지 디렉토리를 찾을 수 없습니다: " << page->GetFilename() << std::endl;
+        return;
+    }
+    std::shared_lock<std::shared_mutex> latch(page->Latch());   // 다른 세션도 같이 쓸 수 있지만 내용이 바뀌는 중에는 쓰지 않음
+    f->WritePageToFile(*dir, *page);
+    page->SetDirty(false);
+}
+
+void BufferManager::FlushPage(const std::shared_ptr<Page> &page)
 {
-    File f(file_);
-    f.WritePageToFile(dir,*page);
+    if (wal_ && page->GetLsn() > 0)
+    {
+        wal_->Flush(page->GetLsn()); // WAL 규칙: 페이지보다 로그가 먼저
+    }
+    WritePage(page);
 }
 
 /**
@@ -95,10 +385,23 @@ void BufferManager::FlushPageToDisk(PageDirectory dir, const std::shared_ptr<Pag
  * 
  * @param page 변경할 페이지
  */
-void BufferManager::WriteBlock(std::shared_ptr<Page> page,const char *content,int length)
+bool BufferManager::WriteBlock(std::shared_ptr<Page> page,const char *content,int length)
 {
-    page->SetDirty(true);
-    page->InsertRecord(content,length);
+    {
+        std::unique_lock<std::shared_mutex> latch(page->Latch());
+        if (!page->InsertRecord(content,length))
+        {
+            return false;
+        }
+        if (wal_)
+        {
+            page->SetLsn(wal_->AppendInsert(page->GetFilename(), page->GetDirIdx(), page->GetPageIdx(),
+                                            page->GetSlotCount() - 1, content, length));
+        }
+        page->SetDirty(true);
+    }
+    GetFile(page->GetFilename())->UpdateEntry(*page);
+    return true;
 }
 /**
  * @brief 버퍼풀에 있는 모든 데이터 출력
@@ -1,36 +1,237 @@
 #ifndef BUFFERMANAGER_H
 #define BUFFERMANAGER_H
 
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "buffer_pool.h"
 #include "file.h"
+#include "prefetcher.h"
+#include "scan_ring.h"
+#include "wal.h"
+
+#define PREFETCH_THREADS 4  // read-ahead I/O 스레드 수
+#define SCAN_RING_DIVISOR 4 // 버퍼 풀 프레임 수의 1/SCAN_RING_DIVISOR보다 큰 테이블의 스캔은 ScanRing을 씀
 /**
  * @brief Buffer Manager class
  * Buffer Manager class is a class that manages the buffer pool
  * It has a block handler class
  * It communicate with disk to read and write data
+ * It keeps every table file it has opened (descriptor and PageDirectory chain) until it is destroyed
+ * With a write-ahead log, every record insert is logged and stamped on the page (LSN), so dirty pages
+ * are written lazily: on eviction (after the log up to the page LSN) and at checkpoint
+ * Many sessions share one BufferManager: the buffer pool is partitioned and the file cache has its own lock,
+ * so concurrent readers (buffer hits and misses) do not serialize on a global mutex.
+ * Every statement holds statement_latch(): shared for readers (SELECT, SHOW) and the background writer,
+ * exclusive for statements that change pages, directories or the catalog (INSERT, CREATE, DROP).
+ * Pages are pinned (Page::Pin) while in use and latched (Page::Latch) while being changed or written
+ * Scans of large tables read missing pages into a private ScanRing instead of the buffer pool (ScanStrategy)
  */
 class BufferManager
 {
     private:
         BufferPool *bufferPool;
-        std::string file_;
+        std::unordered_map<std::string, std::unique_ptr<File>> files_;  // 열린 테이블 파일 캐시
+        std::unique_ptr<WriteAheadLog> wal_;                            // nullptr이면 로그 없이 동작
+        std::shared_mutex files_mutex_;                                 // 파일 캐시 보호
+        std::shared_mutex statement_latch_;                             // 문장 단위 reader/writer latch
+        std::unique_ptr<Prefetcher> prefetcher_;                        // nullptr이면 read-ahead 안 함
+        size_t prefetch_distance_;                                      // 스캔이 앞서 요청하는 페이지 수
+        size_t scan_ring_pages_;                                        // 0이면 큰 스캔도 버퍼 풀을 씀
+
+        /**
+         * @brief 페이지를 (파일, 파일 안의 offset) 순서로 정렬
+         */
+        void SortByOffset(std::vector<std::shared_ptr<Page>> &pages);
+
+        /**
+         * @brief 페이지가 속한 디렉토리를 찾아 파일에 쓰고 clean으로 표시 (FlushPage, WriteDirtyPages가 같이 씀)
+         * @details 로그는 내리지 않으므로 부르는 쪽이 페이지 LSN까지 먼저 내려야 한다.
+         */
+        void WritePage(const std::shared_ptr<Page> &page);
+
+        /**
+         * @brief 페이지를 ring의 빈 프레임에 읽어 넣음 (ScanRing::Load)
+         *
+         * @return 읽은 프레임. 다른 스레드가 읽는 중이거나 빈 프레임이 없으면 nullptr
+         */
+        std::shared_ptr<Page> ReadIntoRing(const std::string &fileName, PageDirectory &dir, const PageKey &key, ScanRing *ring);
+
+        /**
+         * @brief 로그의 레코드 삽입을 아직 반영되지 않은 페이지에 다시 적용
+         */
+        void RedoInsert(const WalRecord &record);
     public:
-        BufferManager()
-            :bufferPool(new BufferPool())
+        /**
+         * @param policy 버퍼 풀 교체 정책 이름 ("slru", "clock", "lru-k", "2q")
+         * @param capacity 버퍼 풀 프레임 수
+         * @param wal_path write-ahead log 파일 경로. 비어 있으면 로그를 쓰지 않음
+         * @param commit_delay_us group commit 대기 시간 (microseconds)
+         */
+        BufferManager(const std::string &policy = "slru", size_t capacity = DEFAULT_PAGE_AMOUNT,
+                      const std::string &wal_path = "", long commit_delay_us = 0)
+            :bufferPool(new BufferPool(policy, capacity)),
+             wal_(wal_path.empty() ? nullptr : new WriteAheadLog(wal_path, commit_delay_us)),
+             prefetch_distance_(0), scan_ring_pages_(0)
         {}
         ~BufferManager();
-        std::shared_ptr<Page> GetPageFromDisk(PageDirectory &dir,unsigned int pageIdx);
-        std::shared_ptr<Page> GetPageFromBufferPool(std::string fileName,unsigned int pageIdx);
-        std::shared_ptr<Page> GetEnoughSpacePage(std::string fileName,int length);
 
-        void WriteBlock(std::shared_ptr<Page> page,const char *content,int length);
-        void FlushPageToDisk(PageDirectory dir, const std::shared_ptr<Page> &page);
+        /**
+         * @brief 캐시된 File 반환. 처음 여는 파일이면 열어서 캐시에 넣음
+         * @details read_only 설정이면 파일을 mmap해 연다 (File::IsMapped).
+         * 
+         * @param fileName 테이블 파일 경로
+         */
+        File *GetFile(const std::string &fileName);
+
+        /**
+         * @brief 파일의 페이지를 버퍼 풀에서 버리고 파일을 닫은 뒤 삭제
+         * 
+         * @param fileName 삭제할 파일 경로
+         */
+        void DropFile(const std::string &fileName);
+
+        std::shared_ptr<Page> GetPageFromDisk(const std::string &fileName, PageDirectory &dir, unsigned int pageIdx);
+        std::shared_ptr<Page> GetPageFromBufferPool(const std::string &fileName, int dirIdx, unsigned int pageIdx);
+
+        /**
+         * @brief 페이지를 버퍼 풀에서 찾고, 없으면 디스크에서 읽어 버퍼 풀에 넣음
+         * 
+         * @param fileName 테이블 파일 경로
+         * @param dirIdx 페이지가 속한 디렉토리의 인덱스
+         * @param pageIdx 페이지의 인덱스
+         * @return 페이지, 해당 디렉토리가 없으면 nullptr
+         */
+        std::shared_ptr<Page> GetPage(const std::string &fileName, int dirIdx, unsigned int pageIdx);
+
+        /**
+         * @brief ring을 쓰는 스캔의 페이지 읽기. 버퍼 풀에 있으면 그 프레임을, ring에 읽어 둔 페이지가 있으면
+         *        그것을 쓰고 (SCAN_RING_HITS), 둘 다 없으면 ring의 프레임에 읽되 버퍼 풀에 넣지 않음 (교체 정책도 건드리지 않음)
+         *
+         * @param ring nullptr이면 GetPage(fileName, dirIdx, pageIdx)와 같음
+         * @return 페이지, 해당 디렉토리가 없으면 nullptr
+         */
+        std::shared_ptr<Page> GetPage(const std::string &fileName, int dirIdx, unsigned int pageIdx, ScanRing *ring);
+
+        /**
+         * @brief 페이지를 디스크에서 ring의 프레임에 읽어 둠 (read-ahead). 버퍼 풀이나 ring에 이미 있으면 읽지 않음
+         *
+         * @return 디스크에서 읽었으면 true
+         */
+        bool LoadIntoRing(const std::string &fileName, int dirIdx, int pageIdx, const std::shared_ptr<ScanRing> &ring);
+
+        /**
+         * @brief 파일 끝에 빈 페이지를 만들어 디렉토리에 등록하고 버퍼 풀에 넣음
+         * 
+         * @param fileName 테이블 파일 경로
+         * @param format PAX minipage, zone map 속성 (Table::GetPageFormat). 기본값은 slotted page
+         * @return 새 페이지 (dirty)
+         */
+        std::shared_ptr<Page> NewPage(const std::string &fileName, const PageFormat &format = PageFormat());
+
+        /**
+         * @brief 페이지에 레코드를 넣고 dirty로 표시한 뒤 남은 공간을 free space map에 반영
+         * @details 로그를 쓰면 삽입을 로그에 붙이고 받은 LSN을 페이지에 기록한다. 디스크에는 Commit 때 내려감
+         * 
+         * @return 공간이 부족해 넣지 못했으면 false
+         */
+        bool WriteBlock(std::shared_ptr<Page> page,const char *content,int length);
+
+        /**
+         * @brief 페이지가 속한 디렉토리를 찾아 디스크로 내려 씀. 먼저 페이지 LSN까지 로그를 내림
+         */
+        void FlushPage(const std::shared_ptr<Page> &page);
+
+        /**
+         * @brief 지금까지의 변경을 로그에 내림 (문장 commit). group commit으로 fsync 한 번이 여러 commit을 덮음
+         */
+        void Commit();
+
+        /**
+         * @brief 파일의 인덱스가 로그 없이 바뀌었음을 기록. 다음 checkpoint 전에 중단되면 복구 때 인덱스를 다시 만듦
+         *
+         * @param fileName 테이블 파일 경로
+         */
+        void LogReindex(const std::string &fileName);
+
+        /**
+         * @brief 시작할 때 로그를 재생해 디스크에 반영되지 않은 삽입을 다시 적용한 뒤 checkpoint
+         *
+         * @return std::set<std::string> 로그에 나온 테이블 파일 (인덱스를 다시 만들어야 함)
+         */
+        std::set<std::string> Recover();
+
+        /**
+         * @brief dirty 페이지를 파일 offset 순서로 최대 max_pages개 씀. 로그는 가장 큰 페이지 LSN까지 한 번만 내림
+         *
+         * @param all true면 max_pages와 관계없이 모두 씀
+         * @return size_t 쓴 페이지 수
+         */
+        size_t WriteDirtyPages(size_t max_pages, bool all = false);
+
+        /**
+         * @brief dirty 페이지를 파일 순서대로 모두 쓰고 fsync 한 뒤 로그를 비움
+         * @details statement_latch()를 잡은 상태(또는 다른 스레드가 없을 때)에서 불러야 함
+         */
+        void Checkpoint();
+
+        /**
+         * @brief 문장이 실행되는 동안 잡는 latch
+         * @details 페이지·디렉토리·카탈로그를 바꾸는 문장(INSERT, CREATE, DROP)은 exclusive로,
+         *          읽기만 하는 문장(SELECT, SHOW)과 background writer는 shared로 잡는다.
+         *          한 스레드가 shared로 잡은 채 exclusive를 기다리면 교착되므로 커서는 다음 문장 전에 닫아야 함
+         */
+        std::shared_mutex &statement_latch() {return statement_latch_;}
+
+        WriteAheadLog *wal() {return wal_.get();}
+        const BufferPool *buffer_pool() const {return bufferPool;}
+
+        /**
+         * @brief 순차 스캔의 read-ahead를 켬
+         *
+         * @param distance 스캔이 앞서 읽는 페이지 수. 프레임 수의 1/4을 넘지 않게 줄임. 0이면 켜지 않음
+         */
+        void EnablePrefetch(size_t distance);
+        size_t prefetch_distance() const {return prefetch_distance_;}
+        Prefetcher *prefetcher() {return prefetcher_.get();}
+
+        /**
+         * @brief 파일의 (dir idx, page idx) 페이지 중 버퍼 풀에 없는 것을 비동기로 미리 읽도록 요청. read-ahead가 꺼져 있으면 아무것도 안 함
+         *
+         * @param ring nullptr가 아니면 버퍼 풀 대신 ring에 읽어 둠
+         */
+        void Prefetch(const std::string &fileName, const std::vector<std::pair<int, int>> &pages,
+                      const std::shared_ptr<ScanRing> &ring = nullptr);
+
+        /**
+         * @brief 페이지가 버퍼 풀(ring을 주면 ring 포함)에 있는지 (교체 정책에 참조로 기록하지 않음)
+         */
+        bool IsResident(const std::string &fileName, int dirIdx, int pageIdx, ScanRing *ring = nullptr);
+
+        /**
+         * @brief 큰 테이블 스캔이 버퍼 풀을 밀어내지 않게 ScanRing을 씀
+         *
+         * @param pages ring에 둘 페이지 수. 0이면 쓰지 않음
+         */
+        void EnableScanRing(size_t pages);
+
+        /**
+         * @brief 스캔할 테이블 크기에 맞는 접근 방식
+         *
+         * @param tablePages 테이블 페이지 수
+         * @return 버퍼 풀 프레임 수의 1/SCAN_RING_DIVISOR보다 크면 새 ring, 아니면 nullptr (버퍼 풀을 씀)
+         */
+        std::shared_ptr<ScanRing> ScanStrategy(size_t tablePages);
 
         /**
          * @brief 페이지가 버퍼 풀에 다 찼을 때 last Page evicton 실시
          */
         void ReplacePage(Page *page);
-        void SetFile(std::string fileName){file_=fileName;}
         void DebugAllBufferPool();
         void DebugTableBufferPool(std::string fileName);
         void DebugTableBufferPool(std::string fileName,int pageIdx);
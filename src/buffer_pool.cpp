@@ -1,59 +1,195 @@
 #include "buffer_pool.h"
+#include "exceptions.h"
+#include "metrics.h"
 
-void BufferPool::InsertPage(std::shared_ptr<Page> page)
+int BufferPool::GetFileId(const std::string &filename)
 {
+    {
+        std::shared_lock<std::shared_mutex> lock(file_ids_mutex_);
+        auto it = file_ids_.find(filename);
+        if (it != file_ids_.end())
+        {
+            return it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(file_ids_mutex_);
+    auto it = file_ids_.find(filename);     // 다른 세션이 먼저 부여했을 수 있음
+    if (it != file_ids_.end())
+    {
+        return it->second;
+    }
+    int id = static_cast<int>(file_ids_.size());
+    file_ids_.emplace(filename, id);
+    return id;
+}
+
+PageKey BufferPool::MakeKey(const std::shared_ptr<Page> &page)
+{
+    return PageKey{GetFileId(page->GetFilename()), page->GetDirIdx(), page->GetPageIdx()};
+}
+
+std::shared_ptr<Page> BufferPool::Lookup(const PageKey &key)
+{
+    Partition &partition = PartitionOf(key);
+    std::shared_lock<std::shared_mutex> lock(partition.mutex);
+    auto it = partition.frames.find(key);
+    return it == partition.frames.end() ? nullptr : it->second;
+}
+
+void BufferPool::RemoveFrame(const PageKey &key)
+{
+    policy_->Remove(key);
+    Partition &partition = PartitionOf(key);
+    std::unique_lock<std::shared_mutex> lock(partition.mutex);
+    if (partition.frames.erase(key) > 0)
+    {
+        size_--;
+    }
+}
+
+std::shared_ptr<Page> BufferPool::InsertPage(std::shared_ptr<Page> page, std::shared_ptr<Page> *evicted)
+{
+    evicted->reset();
     if (!page)
     {
         std::cerr << "Error: Attempted to insert a null page." << std::endl;
-        return;
+        return nullptr;
     }
 
-    if (infreq.size() < MAX_INFREQ_SIZE) //infreq에 먼저 삽입 시도
+    PageKey key = MakeKey(page);
+    std::lock_guard<std::mutex> policy_lock(policy_mutex_);
+    std::shared_ptr<Page> resident = Lookup(key);
+    if (resident) // 이미 버퍼 풀에 있는 페이지 (다른 세션이 먼저 읽어 넣음)
     {
-        std::cout<<"[Insert Page] Insert Page to infreq"<<std::endl;
-        infreq.push_back(page);
+        policy_->RecordAccess(key);
+        return resident;
     }
-    else if (freq.size() < MAX_FREQ_SIZE) // infreq가 다 찼으면 freq로 삽입
+
+    if (size_ >= capacity_)
     {
-        std::cout<<"[Insert Page] Insert Page to freq"<<std::endl;
-        freq.push_front(page);
+        // background writer가 미리 써둔 clean 프레임을 먼저 내보내 교체 경로에서 쓰기를 기다리지 않게 함.
+        // 교체 순서상 앞쪽 dirty 프레임을 CLEAN_VICTIM_SEARCH개 넘게 지나치면 dirty 프레임이라도 내보냄
+        PageKey victim;
+        int dirty_seen = 0;
+        bool found = policy_->Victim([this, &dirty_seen](const PageKey &candidate) -> bool {
+            std::shared_ptr<Page> frame = Lookup(candidate);
+            if (!frame || frame->IsPinned())
+            {
+                return false;
+            }
+            return !frame->IsDirty() || ++dirty_seen > CLEAN_VICTIM_SEARCH;
+        }, &victim);
+        if (!found)
+        {
+            found = policy_->Victim([this](const PageKey &candidate) -> bool {
+                std::shared_ptr<Page> frame = Lookup(candidate);
+                return frame && !frame->IsPinned();
+            }, &victim);
+        }
+        if (!found)
+        {
+            throw BufferPoolFullException();
+        }
+        *evicted = Lookup(victim);
+        if ((*evicted)->IsDirty())
+        {
+            // frame table에서 빠진 뒤 디스크에 써질 때까지 FindPage가 찾을 수 있어야 함
+            std::lock_guard<std::mutex> lock(in_flight_mutex_);
+            in_flight_[victim] = *evicted;
+        }
+        RemoveFrame(victim);
+        Metrics::Instance().Add(Metrics::BUFFER_EVICTIONS);
     }
-    else // LRU 알고리즘 적용해서 inreq에서 tail에서 빼고 infreq 두 번째에 삽입 (첫 번째에는 infreqHead가 있음)
+
     {
-        infreq.pop_back();
-        auto it = infreq.begin();
-        if (it != infreq.end()) {
-            ++it; // 두 번째 위치로 이동
-        }
-        infreq.insert(it, page);
+        Partition &partition = PartitionOf(key);
+        std::unique_lock<std::shared_mutex> lock(partition.mutex);
+        partition.frames[key] = page;
     }
-    
+    size_++;
+    policy_->RecordInsert(key);
+    return page;
 }
 
-void BufferPool::PromotePage(std::shared_ptr<Page> page)
+void BufferPool::FinishEviction(const std::shared_ptr<Page> &page)
 {
-    if (!page)
+    PageKey key = MakeKey(page);
+    std::lock_guard<std::mutex> lock(in_flight_mutex_);
+    auto it = in_flight_.find(key);
+    if (it != in_flight_.end() && it->second == page)
     {
-        std::cerr << "Error: Attempted to promote a null page." << std::endl;
-        return;
+        in_flight_.erase(it);
     }
+}
 
-    if (infreq.size() < MAX_INFREQ_SIZE)
+void BufferPool::RemoveFile(const std::string &filename)
+{
+    int file_id = GetFileId(filename);
+    std::lock_guard<std::mutex> policy_lock(policy_mutex_);
+    std::vector<PageKey> keys;
+    for (Partition &partition : partitions_)
+    {
+        std::shared_lock<std::shared_mutex> lock(partition.mutex);
+        for (const auto &frame : partition.frames)
+        {
+            if (frame.first.file_id == file_id)
+            {
+                keys.push_back(frame.first);
+            }
+        }
+    }
+    for (const PageKey &key : keys)
     {
-        std::cerr << "Error: Attempted to promote a page in infreq." << std::endl;
-        return;
+        RemoveFrame(key);
     }
+}
 
-    if (freq.size() >= MAX_FREQ_SIZE)
+std::shared_ptr<Page> BufferPool::FindPage(const PageKey &key)
+{
     {
-        std::cerr << "Error: Attempted to promote a page in freq when freq is full." << std::endl;
-        return;
+        Partition &partition = PartitionOf(key);
+        std::shared_lock<std::shared_mutex> lock(partition.mutex);
+        auto it = partition.frames.find(key);
+        if (it != partition.frames.end())
+        {
+            // partition을 잡고 있는 동안은 이 프레임이 교체 정책에서 빠지지 않음
+            std::unique_lock<std::mutex> policy_lock(policy_mutex_, std::try_to_lock);
+            if (policy_lock.owns_lock())
+            {
+                policy_->RecordAccess(key);
+            }
+            return it->second;
+        }
     }
+    std::lock_guard<std::mutex> lock(in_flight_mutex_);
+    auto it = in_flight_.find(key);
+    return it == in_flight_.end() ? nullptr : it->second;
+}
 
-    infreq.remove(page);
-    freq.push_front(page);
+bool BufferPool::Contains(const PageKey &key)
+{
+    if (Lookup(key))
+    {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(in_flight_mutex_);
+    return in_flight_.count(key) > 0;
 }
 
+std::vector<std::shared_ptr<Page>> BufferPool::Snapshot()
+{
+    std::vector<std::shared_ptr<Page>> pages;
+    pages.reserve(size_);
+    for (Partition &partition : partitions_)
+    {
+        std::shared_lock<std::shared_mutex> lock(partition.mutex);
+        for (const auto &frame : partition.frames)
+        {
+            pages.push_back(frame.second);
+        }
+    }
+    return pages;
+}
 
 // void BufferPool::DebugBufferPool()
 // {
@@ -68,11 +204,7 @@ void BufferPool::PromotePage(std::shared_ptr<Page> page)
  */
 void BufferPool::TraverseBufferPoolVoid(std::function<void(const std::shared_ptr<Page>&)> callback)
 {
-    for (const auto &page : freq)
-    {
-        callback(page);
-    }
-    for (const auto &page : infreq)
+    for (const std::shared_ptr<Page> &page : Snapshot())
     {
         callback(page);
     }
@@ -83,15 +215,7 @@ void BufferPool::TraverseBufferPoolVoid(std::function<void(const std::shared_ptr
  */
 std::shared_ptr<Page> BufferPool::TraverseBufferPool(std::function<std::shared_ptr<Page>(std::shared_ptr<Page>)> callback)
 {
-    for (const auto &page : freq)
-    {
-        auto result = callback(page);
-        if (result != nullptr)
-        {
-            return result;
-        }
-    }
-    for (const auto &page : infreq)
+    for (const std::shared_ptr<Page> &page : Snapshot())
     {
         auto result = callback(page);
         if (result != nullptr)
@@ -100,4 +224,4 @@ std::shared_ptr<Page> BufferPool::TraverseBufferPool(std::function<std::shared_p
         }
     }
     return nullptr;
-}
\ No newline at end of file
+}
@@ -1,51 +1,126 @@
 #ifndef BUFFERPOOL_H
 #define BUFFERPOOL_H
 
-#include <list>
+#include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "page.h"
+#include "replacement_policy.h"
+
+#define CLEAN_VICTIM_SEARCH 16      // 교체할 때 clean 프레임을 찾으며 지나칠 수 있는 dirty 프레임 수
+#define BUFFER_POOL_PARTITIONS 16   // frame table 분할 수
 
-#define MAX_FREQ_SIZE (PAGE_AMOUNT*(5.0/8.0))
-#define MAX_INFREQ_SIZE (PAGE_AMOUNT*(3.0/8.0))
-#define PAGE_AMOUNT 80
 /**
- * @brief 버퍼 풀 클래스 [freq->tail]->[head->infreq]
+ * @brief 버퍼 풀 클래스
+ * @details 페이지 탐색은 frame table로 O(1)에 수행하고,
+ *          교체 순서는 시작할 때 선택한 ReplacementPolicy가 관리한다.
+ *
+ *          frame table은 PageKey hash로 BUFFER_POOL_PARTITIONS개로 나누고 partition마다 shared_mutex를 두어,
+ *          여러 세션의 buffer hit는 서로 다른 partition에서 (같은 partition이라도 shared로) 동시에 진행된다.
+ *          교체 정책은 policy_mutex_ 하나로 보호하며, hit의 참조 기록은 try_lock으로 잡힐 때만 남긴다
+ *          (경합 중인 참조 몇 개를 놓치는 대신 hit 경로가 전역 lock을 기다리지 않음).
+ *          lock 순서는 policy_mutex_ -> partition이다.
+ *
+ *          dirty 페이지를 내보내면 호출한 쪽이 디스크에 쓸 때까지 in_flight_에 남겨 두어,
+ *          그 사이 같은 페이지를 찾는 세션이 디스크의 옛 내용을 읽지 않게 한다.
  */
 class BufferPool
 {
 private:
-    std::list<std::shared_ptr<Page>> freq;
-    std::list<std::shared_ptr<Page>> infreq;
+    struct Partition
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<PageKey, std::shared_ptr<Page>, PageKeyHash> frames;
+    };
+
+    size_t capacity_;
+    std::unique_ptr<ReplacementPolicy> policy_;
+    std::mutex policy_mutex_;                   // policy_, 프레임 삽입/교체 보호
+    std::array<Partition, BUFFER_POOL_PARTITIONS> partitions_;  // frame table
+    std::atomic<size_t> size_;
+
+    std::shared_mutex file_ids_mutex_;
+    std::unordered_map<std::string, int> file_ids_;                                 // 파일 이름 -> file id
+
+    std::mutex in_flight_mutex_;
+    std::unordered_map<PageKey, std::shared_ptr<Page>, PageKeyHash> in_flight_;     // 내보냈지만 아직 쓰지 않은 dirty 페이지
+
+    PageKey MakeKey(const std::shared_ptr<Page> &page);
+    Partition &PartitionOf(const PageKey &key) {return partitions_[PageKeyHash()(key) % BUFFER_POOL_PARTITIONS];}
+
+    /**
+     * @brief frame table에서 페이지 탐색 (교체 정책에 기록하지 않음)
+     */
+    std::shared_ptr<Page> Lookup(const PageKey &key);
+
+    /**
+     * @brief 프레임 제거. policy_mutex_를 잡은 상태에서 부름
+     */
+    void RemoveFrame(const PageKey &key);
+
+    /**
+     * @brief 모든 프레임의 복사본 (순회하는 동안 partition lock을 잡지 않기 위함)
+     */
+    std::vector<std::shared_ptr<Page>> Snapshot();
 
 public:
-    BufferPool()
-    :freq(std::list<std::shared_ptr<Page>>()), infreq(std::list<std::shared_ptr<Page>>())
-    {   
-        std::shared_ptr<Page> freqTail = std::make_shared<Page>();
-        std::shared_ptr<Page> infreqHead = std::make_shared<Page>();
-        infreqHead->SetNext(NULL);
-
-        // freq : freqTail infreq : infreqHead
-        // freqTail <-> infreqHead
-        freqTail->SetFilename("freqTail");
-        infreqHead->SetFilename("infreqHead");
-        freq.push_back(freqTail);
-        infreq.push_back(infreqHead);
-        freq.back()->SetNext(infreq.front());
-        infreq.front()->SetPrev(freq.back());
-    }
+    /**
+     * @param policy 교체 정책 이름 ("slru", "clock", "lru-k", "2q")
+     * @param capacity 프레임 수
+     */
+    BufferPool(const std::string &policy = "slru", size_t capacity = DEFAULT_PAGE_AMOUNT)
+    :capacity_(capacity), policy_(CreateReplacementPolicy(policy, capacity)), size_(0)
+    {}
     ~BufferPool()
     {
-        freq.clear();
-        infreq.clear();
+        for (Partition &partition : partitions_)
+        {
+            partition.frames.clear();
+        }
     }
     /**
-     * @brief 버퍼 풀에 페이지를 삽입. infreq부터 삽입하고 다차면 freq로 넘어감
+     * @brief 버퍼 풀에 페이지를 삽입. 가득 찼으면 교체 정책이 고른 고정되지 않은 프레임을 내보냄 (clean 프레임 우선)
+     * @details 다른 세션이 같은 페이지를 먼저 넣었으면 page 대신 이미 있는 프레임을 돌려줌
+     *
+     * @param evicted 내보낸 페이지, 없으면 nullptr. dirty면 호출한 쪽에서 디스크에 쓴 뒤 FinishEviction을 불러야 함
+     * @return 버퍼 풀에 있는 페이지
+     * @throw BufferPoolFullException 모든 프레임이 고정되어 있음
+     */
+    std::shared_ptr<Page> InsertPage(std::shared_ptr<Page> page, std::shared_ptr<Page> *evicted);
+
+    /**
+     * @brief 내보낸 dirty 페이지를 디스크에 다 썼음을 알림. 이후 이 페이지는 디스크에서 다시 읽음
+     */
+    void FinishEviction(const std::shared_ptr<Page> &page);
+
+    /**
+     * @brief 파일 이름에 대응하는 file id 반환. 처음 보는 파일이면 새 id를 부여
+     */
+    int GetFileId(const std::string &filename);
+
+    /**
+     * @brief frame table에서 페이지 탐색. 찾은 페이지는 교체 정책에 참조로 기록됨
+     * @details frame table에 없어도 내보낸 뒤 아직 쓰는 중인 dirty 페이지면 그 페이지를 돌려줌
+     *
+     * @return 찾은 페이지, 없으면 nullptr
+     */
+    std::shared_ptr<Page> FindPage(const PageKey &key);
+
+    /**
+     * @brief 페이지가 버퍼 풀에 있는지 (내보내 쓰는 중인 페이지 포함). 교체 정책에 참조로 기록하지 않음
+     */
+    bool Contains(const PageKey &key);
+
+    /**
+     * @brief 파일의 페이지를 모두 버퍼 풀에서 버림 (디스크에 쓰지 않음)
      */
-    void InsertPage(std::shared_ptr<Page> page);
-    void PromotePage(std::shared_ptr<Page> page);
-    void ReplacePage(std::shared_ptr<Page> page);
-    
+    void RemoveFile(const std::string &filename);
 
     /**
      * @brief shraed_ptr<Page> 반환, shared_ptr<Page> 인자 전달형 버퍼풀 순회함수
@@ -58,9 +133,10 @@ public:
     void TraverseBufferPoolVoid(std::function<void(const std::shared_ptr<Page>&)> callback);
     void DebugBufferPool();
 
-    std::list<std::shared_ptr<Page>> GetFreq() { return freq; }
-    std::list<std::shared_ptr<Page>> GetInfreq() { return infreq; }
+    const char *GetPolicyName() const { return policy_->Name(); }
+    size_t GetCapacity() const { return capacity_; }
+    size_t GetSize() const { return size_.load(); }
 
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,65 @@
+#include "bulk_loader.h"
+
+#include "bplus_tree.h"
+
+bool BulkLoader::Add(const char *record, int length) {
+    if (pages_.empty() || !pages_.back()->HasEnoughSpace(length)) {
+        if (pages_.size() >= BULK_LOAD_FLUSH_PAGES) {
+            Flush();
+        }
+        std::shared_ptr<Page> page = std::make_shared<Page>(tbl_->GetFile(), 0);
+        page->SetFilename(tbl_->GetFile());
+        page->ApplyFormat(tbl_->GetPageFormat());
+        if (!page->HasEnoughSpace(length)) {
+            return false;
+        }
+        pages_.push_back(page);
+    }
+    return pages_.back()->InsertRecord(record, length);
+}
+
+void BulkLoader::Finish() {
+    if (!pages_.empty()) {
+        Flush();
+    }
+    if (written_ && bm_->wal() != nullptr) {
+        bm_->GetFile(tbl_->GetFile())->Sync();
+    }
+}
+
+void BulkLoader::Flush() {
+    if (!written_) {
+        bm_->LogReindex(tbl_->GetFile());
+        written_ = true;
+    }
+    bm_->GetFile(tbl_->GetFile())->AppendPages(pages_);
+
+    // 페이지 위치가 정해졌으므로 인덱스마다 한 번씩 트리를 열어 batch 전체를 삽입
+    for (const Index &idx : tbl_->ids()) {
+        BPlusTree tree(bm_, idx.file(), idx.key_type(), idx.key_len());
+        int attr_index = tbl_->GetAttributeIndex(idx.attr_name());
+        for (const std::shared_ptr<Page> &page : pages_) {
+            InsertKeys(tree, *tbl_, *page, attr_index);
+        }
+    }
+    pages_.clear();
+}
+
+void BulkLoader::InsertKeys(BPlusTree &tree, const Table &tbl, const Page &page, int attr_index) {
+    if (page.IsPax()) {
+        const char *column = page.GetColumn(attr_index);
+        int width = page.GetColumnWidth(attr_index);
+        for (int row = 0; row < page.GetSlotCount(); row++) {
+            tree.Insert(column + row * width, {page.GetDirIdx(), page.GetPageIdx(), row});
+        }
+        return;
+    }
+    int offset = tbl.GetAttributeOffset(attr_index);
+    for (const RecordRef &record : page.Records()) {
+        tree.Insert(record.data + offset, {page.GetDirIdx(), page.GetPageIdx(), record.slot_no});
+    }
+}
+
+int BulkLoader::RecordsPerPage(int length) {
+    return (static_cast<int>(Config::Instance().page_size()) - HEADER_SIZE) / (length + static_cast<int>(sizeof(Slot)));
+}
@@ -0,0 +1,59 @@
+#ifndef ABCDB_BULK_LOADER_H_
+#define ABCDB_BULK_LOADER_H_
+
+#include <memory>
+#include <vector>
+#include "catalog_manager.h"
+#include "buffer_manager.h"
+#include "page.h"
+
+class BPlusTree;
+
+#define BULK_LOAD_FLUSH_PAGES 64  // 메모리에 모아두는 최대 페이지 수
+
+/**
+ * @brief 여러 행을 새 페이지에 채워 파일 끝에 차례로 쓰는 적재기 (multi-row INSERT, EXEC용)
+ * @details 페이지를 버퍼 풀 밖에서 채우므로 행마다 free space map을 찾거나 frame을 교체하지 않는다.
+ *          BULK_LOAD_FLUSH_PAGES개가 모일 때마다 File::AppendPages로 한 번에 쓰고,
+ *          디렉토리 갱신과 인덱스 삽입도 그 단위로 한다. 기존 페이지의 빈 공간은 쓰지 않는다.
+ *          새 페이지는 Table::GetPageFormat 형식(PAX minipage, zone map)으로 만든다.
+ *
+ *          레코드는 WAL에 남기지 않는다. 대신 처음 쓰기 전에 WAL_REINDEX를 기록하고 Finish에서 파일을 fsync 하므로,
+ *          중간에 중단되면 복구할 때 디스크에 있는 행으로 인덱스를 다시 만든다.
+ */
+class BulkLoader {
+private:
+    BufferManager *bm_;
+    Table *tbl_;
+    std::vector<std::shared_ptr<Page>> pages_;  // 아직 쓰지 않은 페이지. 마지막 페이지를 채우는 중
+    bool written_;                              // 한 번이라도 파일에 썼음
+
+    void Flush();
+
+public:
+    BulkLoader(BufferManager *bm, Table *tbl) : bm_(bm), tbl_(tbl), written_(false) {}
+
+    /**
+     * @brief 레코드를 현재 페이지에 추가. 가득 찼으면 새 페이지를 시작
+     *
+     * @return false 빈 페이지에도 들어가지 않는 레코드
+     */
+    bool Add(const char *record, int length);
+
+    /**
+     * @brief 남은 페이지를 쓰고 인덱스를 갱신. 로그를 쓰면 테이블 파일을 디스크까지 내림
+     */
+    void Finish();
+
+    /**
+     * @brief length 길이의 레코드가 빈 (slotted) 페이지 하나에 몇 개 들어가는지
+     */
+    static int RecordsPerPage(int length);
+
+    /**
+     * @brief 페이지의 모든 행에서 attr_index 속성 값을 key로 인덱스에 넣음 (slotted, PAX 페이지 모두)
+     */
+    static void InsertKeys(BPlusTree &tree, const Table &tbl, const Page &page, int attr_index);
+};
+
+#endif
@@ -1,15 +1,38 @@
 #include "catalog_manager.h"
 
+#include <cstdio>
 #include <fstream>
 
 #include <boost/filesystem.hpp>
+#include "config.h"
+
+namespace {
+
+/**
+ * @brief 임시 파일에 쓴 뒤 rename으로 바꿈. 쓰는 중에 중단되어도 이전 카탈로그가 남음
+ */
+template <class T>
+void WriteArchive(const std::string &file_name, const T &object) {
+  std::string tmp_name = file_name + ".tmp";
+  {
+    std::ofstream ofs(tmp_name.c_str(), std::ios::binary);
+    boost::archive::binary_oarchive oar(ofs);
+    oar << object;
+  }
+  std::rename(tmp_name.c_str(), file_name.c_str());
+}
 
+}  // namespace
 
 /*=======================CatalogManager=======================*/
 
-CatalogManager::CatalogManager(std::string p) : path_(p) { ReadArchiveFile(); }
+CatalogManager::CatalogManager(std::string p) : path_(p), version_(0), legacy_format_(false) { ReadArchiveFile(); }
 
-CatalogManager::~CatalogManager() { WriteArchiveFile(); }
+CatalogManager::~CatalogManager() {
+  if (!Config::Instance().read_only()) {
+    WriteArchiveFile();
+  }
+}
 
 void CatalogManager::ReadArchiveFile() {
   std::string file_name = path_ + "catalog";
@@ -24,20 +47,47 @@ void CatalogManager::ReadArchiveFile() {
     iar >> (*this);
     ifs.close();
   }
+  if (legacy_format_) {
+    WriteArchiveFile();   // 이후 DDL은 데이터베이스별 파일만 씀
+    legacy_format_ = false;
+  }
+}
+
+void CatalogManager::ReadDatabaseFile(Database &db) {
+  std::string file_name = DatabaseFile(db.db_name());
+  std::ifstream ifs(file_name.c_str(), std::ios::binary);
+  if (!ifs) {
+    return;   // 테이블을 만들기 전의 데이터베이스
+  }
+  boost::archive::binary_iarchive iar(ifs);
+  iar >> db;
 }
 
 void CatalogManager::WriteArchiveFile() {
-  std::string file_name = path_ + "catalog";
+  for (const Database &db : dbs_) {
+    WriteDatabaseFile(db.db_name());
+  }
+  WriteArchive(path_ + "catalog", *this);
+}
 
-  std::ofstream ofs;
-  ofs.open(file_name.c_str(), std::ios::binary);
-  boost::archive::binary_oarchive oar(ofs);
-  oar << (*this);
-  ofs.close();
+void CatalogManager::WriteDatabaseFile(const std::string &db_name) {
+  Database *db = GetDB(db_name);
+  if (db != NULL) {
+    WriteArchive(DatabaseFile(db_name), *db);
+  }
+}
+
+void CatalogManager::RebuildIndex() {
+  db_pos_.clear();
+  for (size_t i = 0; i < dbs_.size(); i++) {
+    db_pos_[dbs_[i].db_name()] = i;
+  }
 }
 
 void CatalogManager::CreateDatabase(std::string dbname) {
   dbs_.push_back(Database(dbname));
+  db_pos_[dbname] = dbs_.size() - 1;
+  Invalidate();
 }
 
 void CatalogManager::DeleteDatabase(std::string dbname) {
@@ -46,15 +96,13 @@ void CatalogManager::DeleteDatabase(std::string dbname) {
       dbs_.erase(dbs_.begin() + i);
     }
   }
+  RebuildIndex();
+  Invalidate();
 }
 
-Database *CatalogManager::GetDB(std::string db_name) {
-  for (unsigned int i = 0; i < dbs_.size(); ++i) {
-    if (dbs_[i].db_name() == db_name) {
-      return &dbs_[i];
-    }
-  }
-  return NULL;
+Database *CatalogManager::GetDB(const std::string &db_name) {
+  auto it = db_pos_.find(db_name);
+  return it == db_pos_.end() ? NULL : &dbs_[it->second];
 }
 
 /*=======================Database=============================*/
@@ -72,7 +120,16 @@ void Database::CreateTable(SQLCreateTable &st, std::string file_name) {
     }
 
     tb.set_record_length(record_length);
+    tb.set_storage(st.storage());
     tbs_.push_back(std::move(tb));  
+    tb_pos_[file_name] = tbs_.size() - 1;
+}
+
+void Database::RebuildIndex() {
+  tb_pos_.clear();
+  for (size_t i = 0; i < tbs_.size(); i++) {
+    tb_pos_[tbs_[i].tb_name()] = i;
+  }
 }
 
 // void Database::DropTable(SQLDropTable &st) {
@@ -85,22 +142,108 @@ void Database::CreateTable(SQLCreateTable &st, std::string file_name) {
 //   }
 // }
 
-Table *Database::GetTable(std::string tb_name) {
-  for (unsigned int i = 0; i < tbs_.size(); ++i) {
-    if (tbs_[i].tb_name() == tb_name) {
-      return &tbs_[i];
-    }
-  }
-  return NULL;
+Table *Database::GetTable(const std::string &tb_name) {
+  auto it = tb_pos_.find(tb_name);
+  return it == tb_pos_.end() ? NULL : &tbs_[it->second];
 }
 
 /*=======================Table===============================*/
 
-Attribute *Table::GetAttribute(std::string name) {
+void Table::BuildLayout() {
+  attr_pos_.clear();
+  offsets_.clear();
+  record_length_ = 0;
   for (unsigned int i = 0; i < ats_.size(); ++i) {
-    if (ats_[i].attr_name() == name) {
-      return &ats_[i];
+    attr_pos_.emplace(ats_[i].attr_name(), i);   // 같은 이름이 여럿이면 앞의 속성
+    offsets_.push_back(record_length_);
+    record_length_ += ats_[i].length();
+  }
+}
+
+void Table::AddAttribute(const Attribute &attr) {
+  ats_.push_back(attr);
+  BuildLayout();
+}
+
+Attribute *Table::GetAttribute(const std::string &name) {
+  int i = GetAttributeIndex(name);
+  return i < 0 ? NULL : &ats_[i];
+}
+
+int Table::GetAttributeIndex(const std::string &name) const {
+  auto it = attr_pos_.find(name);
+  return it == attr_pos_.end() ? -1 : it->second;
+}
+
+int Table::GetAttributeOffset(const std::string &name) const {
+  int i = GetAttributeIndex(name);
+  return i < 0 ? -1 : offsets_[i];
+}
+
+PageFormat Table::GetPageFormat() const {
+  PageFormat format;
+  for (size_t i = 0; i < ats_.size(); i++) {
+    const Attribute &attr = ats_[i];
+    if (storage_ == STORAGE_PAX) {
+      format.pax_columns.push_back(attr.length());
+    }
+    if ((attr.data_type() == T_INT || attr.data_type() == T_FLOAT) &&
+        format.zone_columns.size() < ZONE_MAP_COLUMNS) {
+      format.zone_columns.push_back({offsets_[i], attr.data_type()});
+    }
+  }
+  return format;
+}
+
+Index *Table::GetIndex(const std::string &name) {
+  for (unsigned int i = 0; i < ids_.size(); ++i) {
+    if (ids_[i].name() == name) {
+      return &ids_[i];
     }
   }
   return NULL;
-}
\ No newline at end of file
+}
+
+Index *Table::GetIndexByAttr(const std::string &attr_name) {
+  for (unsigned int i = 0; i < ids_.size(); ++i) {
+    if (ids_[i].attr_name() == attr_name) {
+      return &ids_[i];
+    }
+  }
+  return NULL;
+}
+
+void Table::DropIndex(const std::string &name) {
+  for (std::vector<Index>::iterator i = ids_.begin(); i != ids_.end(); i++) {
+    if (i->name() == name) {
+      ids_.erase(i);
+      return;
+    }
+  }
+}
+
+/*=======================TableCache==========================*/
+
+void TableCache::Reset(CatalogManager *cm, const std::string &db_name) {
+  cm_ = cm;
+  db_name_ = db_name;
+  version_ = cm->version();
+  tables_.clear();
+}
+
+Table *TableCache::Get(const std::string &tb_name) {
+  if (cm_->version() != version_) {
+    version_ = cm_->version();
+    tables_.clear();
+  }
+  auto it = tables_.find(tb_name);
+  if (it != tables_.end()) {
+    return it->second;
+  }
+  Database *db = cm_->GetDB(db_name_);
+  Table *tbl = db == NULL ? NULL : db->GetTable(cm_->path() + db_name_ + "/" + tb_name + ".bin");
+  if (tbl != NULL) {
+    tables_[tb_name] = tbl;
+  }
+  return tbl;
+}
@@ -1,43 +1,84 @@
 #ifndef ABCDB_CATALOG_MANAGER_H_
 #define ABCDB_CATALOG_MANAGER_H_
 
+#include <atomic>
+#include <cstdint>
 #include<string>
+#include <unordered_map>
 #include <vector>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/string.hpp>
 #include <boost/serialization/utility.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 
+#include "commons.h"
 #include "file.h"
 #include "sql_statement.h"
 
 class Database;
 class Table;
 class Attribute;
+class Index;
 class SQLCreateTable;
 // class SQLDropTable;
 
+/**
+ * @brief 데이터베이스 목록과 각 데이터베이스의 카탈로그
+ * @details <path>/catalog에는 데이터베이스 이름만, 각 데이터베이스의 테이블·인덱스 정보는 <path>/<db>/catalog에
+ *          따로 저장하므로 DDL은 그 데이터베이스의 파일만 다시 쓴다 (version 0 형식은 읽을 때 바꿈).
+ *          이름으로 찾는 데이터베이스·테이블·속성은 hash map으로 찾는다.
+ *
+ *          Database, Table은 vector에 들어 있어 DDL 뒤에는 주소가 바뀔 수 있다. 포인터를 보관하는 쪽은
+ *          version()이 바뀌었는지 확인해야 한다 (TableCache).
+ */
 class CatalogManager {
 private:
   friend class boost::serialization::access;
 
   template <class Archive>
-  void serialize(Archive &ar, const unsigned int version) {
-    ar &dbs_;
-  }
+  void save(Archive &ar, const unsigned int version) const;
+  template <class Archive>
+  void load(Archive &ar, const unsigned int version);
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
   std::string path_;
   std::vector<Database> dbs_;
+  std::unordered_map<std::string, size_t> db_pos_;  // 이름 -> dbs_ 위치
+  std::atomic<uint64_t> version_;                   // 카탈로그 구조가 바뀔 때마다 증가
+  bool legacy_format_;                              // version 0 파일을 읽음 (바로 새 형식으로 다시 씀)
+
+  void RebuildIndex();
+  std::string DatabaseFile(const std::string &db_name) const { return path_ + db_name + "/catalog"; }
+  void ReadDatabaseFile(Database &db);
 
 public:
   CatalogManager(std::string p);
   ~CatalogManager();
   std::vector<Database> &dbs() { return dbs_; }
   std::string path() { return path_; }
-  Database *GetDB(std::string db_name);
+  Database *GetDB(const std::string &db_name);
   void ReadArchiveFile();
+
+  /**
+   * @brief 데이터베이스 목록과 모든 데이터베이스의 카탈로그를 씀
+   */
   void WriteArchiveFile();
+
+  /**
+   * @brief 데이터베이스 하나의 카탈로그만 씀 (CREATE TABLE/INDEX, DROP INDEX 뒤)
+   */
+  void WriteDatabaseFile(const std::string &db_name);
   void CreateDatabase(std::string dbname);
   void DeleteDatabase(std::string dbname);
+
+  /**
+   * @brief Database, Table 주소를 바꿀 수 있는 DDL 뒤에 부름. 세션의 TableCache가 다음 조회 때 비워짐
+   */
+  void Invalidate() { version_++; }
+  uint64_t version() const { return version_; }
 };
 
 class Database {
@@ -48,16 +89,22 @@ private:
   void serialize(Archive &ar, const unsigned int version) {
     ar &db_name_;
     ar &tbs_;
+    if (Archive::is_loading::value) {
+      RebuildIndex();
+    }
   }
   std::string db_name_;
   std::vector<Table> tbs_;
+  std::unordered_map<std::string, size_t> tb_pos_;  // 테이블 이름(파일 경로) -> tbs_ 위치
+
+  void RebuildIndex();
 
 public:
   Database() {}
   Database(std::string dbname);
   ~Database() {}
-  Table *GetTable(std::string tb_name);
-  std::string db_name() { return db_name_; }
+  Table *GetTable(const std::string &tb_name);
+  std::string db_name() const { return db_name_; }
   void CreateTable(SQLCreateTable &st,std::string file_name);
   // void DropTable(SQLDropTable &st);
   std::vector<Table> &tbs() { return tbs_; }
@@ -73,18 +120,36 @@ private:
     ar &tb_name_;
   
     ar &ats_;
+    if (version >= 1) {
+      ar &ids_;
+    }
+    if (version >= 2) {
+      ar &storage_;
+    }
+    if (Archive::is_loading::value) {
+      BuildLayout();
+    }
   }
 
   std::string file_;
   std::string tb_name_;
   int record_length_;
+  int storage_;     // STORAGE_ROW, STORAGE_PAX
 
   std::vector<Attribute> ats_;
+  std::vector<Index> ids_;
+  std::unordered_map<std::string, int> attr_pos_;   // 속성 이름 -> ats_ 위치
+  std::vector<int> offsets_;                        // 속성별 레코드 내 시작 위치
+
+  /**
+   * @brief 속성 위치·offset 표와 레코드 길이를 ats_로 다시 만듦
+   */
+  void BuildLayout();
 
 public:
-  Table() {}
+  Table() : record_length_(0), storage_(STORAGE_ROW) {}
   Table(std::string name)
-      : file_(name), tb_name_(name), record_length_(-1) {}
+      : file_(name), tb_name_(name), record_length_(-1), storage_(STORAGE_ROW) {}
   ~Table() {}
 
   std::string tb_name() { return tb_name_; }
@@ -95,11 +160,41 @@ public:
   int record_length() { return record_length_; }
   void set_record_length(int len) { record_length_ = len; }
 
+  int storage() const { return storage_; }
+  void set_storage(int storage) { storage_ = storage; }
+
+  /**
+   * @brief 새 페이지를 만들 때 쓰는 형식 (BufferManager::NewPage)
+   * @details PAX 테이블이면 속성별 길이로 minipage를 나누고, 앞쪽 INT/FLOAT 속성 ZONE_MAP_COLUMNS개는 zone map에 범위를 기록한다.
+   */
+  PageFormat GetPageFormat() const;
+
   std::vector<Attribute> &ats() { return ats_; }
-  Attribute *GetAttribute(std::string name);
+  Attribute *GetAttribute(const std::string &name);
   
   unsigned long GetAttributeNum() { return ats_.size(); }
-  void AddAttribute(const Attribute &attr) { ats_.push_back(attr); }
+  void AddAttribute(const Attribute &attr);
+
+  /**
+   * @brief 속성의 ats() 위치
+   *
+   * @return int 없는 속성이면 -1
+   */
+  int GetAttributeIndex(const std::string &name) const;
+
+  /**
+   * @brief 속성의 레코드 내 시작 위치 (bytes)
+   *
+   * @return int 없는 속성이면 -1
+   */
+  int GetAttributeOffset(const std::string &name) const;
+  int GetAttributeOffset(int attr_index) const { return offsets_[attr_index]; }
+
+  std::vector<Index> &ids() { return ids_; }
+  Index *GetIndex(const std::string &name);
+  Index *GetIndexByAttr(const std::string &attr_name);
+  void AddIndex(const Index &idx) { ids_.push_back(idx); }
+  void DropIndex(const std::string &name);
 };
 
 class Attribute {
@@ -123,18 +218,107 @@ public:
   Attribute() : attr_name_(""), data_type_(-1), length_(-1), attr_type_(0) {}
   ~Attribute() {}
 
-  std::string attr_name() { return attr_name_; }
+  std::string attr_name() const { return attr_name_; }
 
   void set_attr_name(std::string name) { attr_name_ = name; }
 
-  int attr_type() { return attr_type_; }
+  int attr_type() const { return attr_type_; }
   void set_attr_type(int type) { attr_type_ = type; }
 
-  int data_type() { return data_type_; }
+  int data_type() const { return data_type_; }
   void set_data_type(int type) { data_type_ = type; }
 
   void set_length(int length) { length_ = length; }
   int length() const { return length_; }
 };
 
+/**
+ * @brief 테이블 속성 하나에 만든 B+Tree 인덱스 정보. 노드는 file_(인덱스 파일)의 페이지에 저장됨
+ */
+class Index {
+private:
+  friend class boost::serialization::access;
+
+  template <class Archive>
+  void serialize(Archive &ar, const unsigned int version) {
+    ar &name_;
+    ar &attr_name_;
+    ar &key_type_;
+    ar &key_len_;
+    ar &file_;
+  }
+
+  std::string name_;
+  std::string attr_name_;
+  int key_type_;
+  int key_len_;
+  std::string file_;
+
+public:
+  Index() : key_type_(-1), key_len_(0) {}
+  Index(std::string name, std::string attr_name, int keytype, int keylen, std::string file)
+      : name_(name), attr_name_(attr_name), key_type_(keytype), key_len_(keylen), file_(file) {}
+
+  std::string name() const { return name_; }
+  std::string attr_name() const { return attr_name_; }
+  int key_type() const { return key_type_; }
+  int key_len() const { return key_len_; }
+  std::string file() const { return file_; }
+};
+
+/**
+ * @brief 세션이 이미 찾은 테이블 (테이블 이름 -> Table*)
+ * @details 한 세션(API)만 쓰므로 잠그지 않는다. 조회할 때 CatalogManager::version()이 바뀌었으면 비우고 다시 찾으며,
+ *          DDL은 statement latch를 exclusive로 잡으므로 문장 실행 중에 캐시된 포인터가 무효가 되지 않는다.
+ */
+class TableCache {
+private:
+  CatalogManager *cm_;
+  std::string db_name_;
+  uint64_t version_;
+  std::unordered_map<std::string, Table *> tables_;
+
+public:
+  TableCache() : cm_(nullptr), version_(0) {}
+
+  /**
+   * @brief 현재 데이터베이스를 바꾸고 비움
+   */
+  void Reset(CatalogManager *cm, const std::string &db_name);
+
+  /**
+   * @return Table* 없는 테이블이면 NULL
+   */
+  Table *Get(const std::string &tb_name);
+};
+
+template <class Archive>
+void CatalogManager::save(Archive &ar, const unsigned int version) const {
+  std::vector<std::string> names;
+  for (const Database &db : dbs_) {
+    names.push_back(db.db_name());
+  }
+  ar &names;
+}
+
+template <class Archive>
+void CatalogManager::load(Archive &ar, const unsigned int version) {
+  if (version == 0) {
+    ar &dbs_;   // 예전 형식: 모든 데이터베이스를 한 파일에
+    legacy_format_ = true;
+  } else {
+    std::vector<std::string> names;
+    ar &names;
+    dbs_.clear();
+    for (const std::string &name : names) {
+      dbs_.push_back(Database(name));
+      ReadDatabaseFile(dbs_.back());
+    }
+  }
+  RebuildIndex();
+}
+
+BOOST_CLASS_VERSION(CatalogManager, 1)
+BOOST_CLASS_VERSION(Table, 2)
+
 #endif
\ No newline at end of file
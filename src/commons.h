@@ -5,6 +5,10 @@
 #define FORMAT_RECORD 0
 #define FORMAT_INDEX 1
 
+// Table Storage
+#define STORAGE_ROW 0
+#define STORAGE_PAX 1
+
 // Data Type
 #define T_INT 0
 #define T_FLOAT 1
@@ -18,4 +22,11 @@
 #define SIGN_LE 4
 #define SIGN_GE 5
 
+// Aggregate (SELECT 목록 항목)
+#define AGG_NONE 0      // 집계하지 않는 속성 (GROUP BY 속성이어야 함)
+#define AGG_COUNT 1
+#define AGG_SUM 2
+#define AGG_MIN 3
+#define AGG_MAX 4
+
 #endif
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "config.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include <boost/algorithm/string.hpp>
+
+namespace {
+
+struct EnvOverride {
+  const char *env;
+  const char *key;
+};
+
+const EnvOverride kEnvOverrides[] = {
+    {"ABCDB_PAGE_SIZE", "page_size"},
+    {"ABCDB_BUFFER_POOL_SIZE", "buffer_pool_size"},
+    {"ABCDB_BUFFER_POOL_PAGES", "buffer_pool_pages"},
+    {"ABCDB_REPLACEMENT_POLICY", "replacement_policy"},
+    {"ABCDB_WAL", "wal"},
+    {"ABCDB_WAL_COMMIT_DELAY", "wal_commit_delay"},
+    {"ABCDB_BGWRITER_DELAY", "bgwriter_delay"},
+    {"ABCDB_BGWRITER_MAX_PAGES", "bgwriter_max_pages"},
+    {"ABCDB_CHECKPOINT_INTERVAL", "checkpoint_interval"},
+    {"ABCDB_CHECKPOINT_WAL_SIZE", "checkpoint_wal_size"},
+    {"ABCDB_SERVER_PORT", "server_port"},
+    {"ABCDB_SERVER_WORKERS", "server_workers"},
+    {"ABCDB_PARALLEL_WORKERS", "parallel_workers"},
+    {"ABCDB_PREFETCH_PAGES", "prefetch_pages"},
+    {"ABCDB_SCAN_RING_PAGES", "scan_ring_pages"},
+    {"ABCDB_WORK_MEM", "work_mem"},
+    {"ABCDB_READ_ONLY", "read_only"},
+};
+
+/**
+ * @brief 0 이상의 정수
+ */
+bool ParseCount(const std::string &value, long *out) {
+  std::string v = boost::algorithm::trim_copy(value);
+  if (v.empty() || !std::all_of(v.begin(), v.end(), ::isdigit)) {
+    return false;
+  }
+  *out = std::atol(v.c_str());
+  return true;
+}
+
+}  // namespace
+
+Config::Config()
+    : page_size_(DEFAULT_PAGE_SIZE), buffer_pool_pages_(DEFAULT_PAGE_AMOUNT),
+      buffer_pool_bytes_(0), buffer_pool_pages_set_(false), replacement_policy_("slru"), wal_(true), wal_commit_delay_(0),
+      bgwriter_delay_(200), bgwriter_max_pages_(64), checkpoint_interval_(60), checkpoint_wal_size_(16 << 20),
+      server_port_(7070), server_workers_(0), parallel_workers_(0),
+      prefetch_pages_(32), scan_ring_pages_(32), work_mem_(16 << 20), read_only_(false) {}
+
+Config &Config::Instance() {
+  static Config instance;
+  return instance;
+}
+
+std::size_t Config::ParseSize(const std::string &value) {
+  std::string v = boost::algorithm::trim_copy(value);
+  if (v.empty() || !std::isdigit(static_cast<unsigned char>(v[0]))) {
+    return 0;
+  }
+  char *end = nullptr;
+  unsigned long long n = std::strtoull(v.c_str(), &end, 10);
+  std::string suffix = boost::algorithm::to_upper_copy(std::string(end));
+  if (suffix == "" || suffix == "B") {
+    return n;
+  } else if (suffix == "K" || suffix == "KB") {
+    return n << 10;
+  } else if (suffix == "M" || suffix == "MB") {
+    return n << 20;
+  } else if (suffix == "G" || suffix == "GB") {
+    return n << 30;
+  }
+  return 0;
+}
+
+void Config::Set(const std::string &key, const std::string &value) {
+  if (key == "page_size") {
+    std::size_t size = ParseSize(value);
+    bool power_of_two = size != 0 && (size & (size - 1)) == 0;
+    if (!power_of_two || size < MIN_PAGE_SIZE || size > MAX_PAGE_SIZE) {
+      std::cerr << "Invalid page_size '" << value << "', keeping " << page_size_ << std::endl;
+      return;
+    }
+    page_size_ = size;
+  } else if (key == "buffer_pool_size") {
+    std::size_t size = ParseSize(value);
+    if (size == 0) {
+      std::cerr << "Invalid buffer_pool_size '" << value << "'" << std::endl;
+      return;
+    }
+    buffer_pool_bytes_ = size;
+  } else if (key == "buffer_pool_pages") {
+    std::size_t pages = ParseSize(value);
+    if (pages == 0) {
+      std::cerr << "Invalid buffer_pool_pages '" << value << "'" << std::endl;
+      return;
+    }
+    buffer_pool_pages_ = pages;
+    buffer_pool_pages_set_ = true;
+  } else if (key == "replacement_policy") {
+    replacement_policy_ = boost::algorithm::to_lower_copy(value);
+  } else if (key == "wal" || key == "read_only") {
+    std::string v = boost::algorithm::to_lower_copy(value);
+    bool &flag = key == "wal" ? wal_ : read_only_;
+    if (v == "on" || v == "true" || v == "1") {
+      flag = true;
+    } else if (v == "off" || v == "false" || v == "0") {
+      flag = false;
+    } else {
+      std::cerr << "Invalid " << key << " '" << value << "', expected on or off" << std::endl;
+    }
+  } else if (key == "wal_commit_delay" || key == "bgwriter_delay" || key == "checkpoint_interval" ||
+             key == "server_workers" || key == "parallel_workers" || key == "prefetch_pages" ||
+             key == "scan_ring_pages") {
+    long n;
+    if (!ParseCount(value, &n)) {
+      std::cerr << "Invalid " << key << " '" << value << "'" << std::endl;
+      return;
+    }
+    if (key == "wal_commit_delay") {
+      wal_commit_delay_ = n;
+    } else if (key == "bgwriter_delay") {
+      bgwriter_delay_ = n;
+    } else if (key == "server_workers") {
+      server_workers_ = n;
+    } else if (key == "parallel_workers") {
+      parallel_workers_ = n;
+    } else if (key == "prefetch_pages") {
+      prefetch_pages_ = n;
+    } else if (key == "scan_ring_pages") {
+      scan_ring_pages_ = n;
+    } else {
+      checkpoint_interval_ = n;
+    }
+  } else if (key == "bgwriter_max_pages") {
+    std::size_t pages = ParseSize(value);
+    if (pages == 0) {
+      std::cerr << "Invalid bgwriter_max_pages '" << value << "'" << std::endl;
+      return;
+    }
+    bgwriter_max_pages_ = pages;
+  } else if (key == "work_mem") {
+    std::size_t size = ParseSize(value);
+    if (size == 0) {
+      std::cerr << "Invalid work_mem '" << value << "'" << std::endl;
+      return;
+    }
+    work_mem_ = size;
+  } else if (key == "server_port") {
+    long n;
+    if (!ParseCount(value, &n) || n == 0 || n > 65535) {
+      std::cerr << "Invalid server_port '" << value << "'" << std::endl;
+      return;
+    }
+    server_port_ = n;
+  } else if (key == "checkpoint_wal_size") {
+    long n;
+    std::size_t size = ParseSize(value);
+    if (size == 0 && !(ParseCount(value, &n) && n == 0)) {
+      std::cerr << "Invalid checkpoint_wal_size '" << value << "'" << std::endl;
+      return;
+    }
+    checkpoint_wal_size_ = size;
+  } else {
+    std::cerr << "Unknown config key '" << key << "'" << std::endl;
+  }
+}
+
+void Config::ReadFile(const std::string &file_name) {
+  std::ifstream in(file_name);
+  if (!in) {
+    return;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    std::size_t comment = line.find('#');
+    if (comment != std::string::npos) {
+      line.erase(comment);
+    }
+    std::size_t eq = line.find('=');
+    if (eq == std::string::npos) {
+      continue;
+    }
+    std::string key = boost::algorithm::trim_copy(line.substr(0, eq));
+    std::string value = boost::algorithm::trim_copy(line.substr(eq + 1));
+    if (!key.empty()) {
+      Set(boost::algorithm::to_lower_copy(key), value);
+    }
+  }
+}
+
+void Config::Load(const std::string &data_path) {
+  const char *config_file = getenv("ABCDB_CONFIG");
+  ReadFile(config_file ? std::string(config_file) : data_path + CONFIG_FILE_NAME);
+
+  for (const EnvOverride &o : kEnvOverrides) {
+    const char *value = getenv(o.env);
+    if (value != nullptr) {
+      Set(o.key, value);
+    }
+  }
+}
+
+std::size_t Config::buffer_pool_pages() const {
+  if (buffer_pool_pages_set_ || buffer_pool_bytes_ == 0) {
+    return buffer_pool_pages_;
+  }
+  std::size_t pages = buffer_pool_bytes_ / page_size_;
+  return pages > 0 ? pages : 1;
+}
+
+std::size_t Config::parallel_workers() const {
+  if (parallel_workers_ > 0) {
+    return static_cast<std::size_t>(parallel_workers_);
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
@@ -0,0 +1,98 @@
+#ifndef ABCDB_CONFIG_H_
+#define ABCDB_CONFIG_H_
+
+#include <cstddef>
+#include <string>
+
+#define DEFAULT_PAGE_SIZE (4 * 1024)
+#define DEFAULT_PAGE_AMOUNT 80
+#define MIN_PAGE_SIZE 1024
+#define MAX_PAGE_SIZE (64 * 1024)
+#define CONFIG_FILE_NAME "abcdb.conf"
+
+/**
+ * @brief 시작할 때 한 번 읽는 실행 설정
+ * @details 설정 파일($ABCDB_CONFIG, 없으면 <data path>/abcdb.conf)의 "key = value" 줄을 읽고,
+ *          같은 이름의 환경 변수(ABCDB_PAGE_SIZE 등)가 있으면 파일 값을 덮어쓴다.
+ *
+ *          page_size           페이지 크기 (bytes, 2의 거듭제곱, 1K ~ 64K)
+ *          buffer_pool_size    버퍼 풀 크기 (bytes, K/M/G 접미사 허용)
+ *          buffer_pool_pages   버퍼 풀 프레임 수 (buffer_pool_size보다 우선)
+ *          replacement_policy  버퍼 교체 정책 (slru, clock, lru-k, 2q)
+ *          wal                 write-ahead log 사용 여부 (on/off)
+ *          wal_commit_delay    group commit leader가 commit을 모으는 시간 (microseconds)
+ *          bgwriter_delay      background writer 회차 간격 (milliseconds, 0이면 스레드를 띄우지 않음)
+ *          bgwriter_max_pages  background writer가 회차마다 쓰는 최대 페이지 수
+ *          checkpoint_interval checkpoint 간격 (seconds, 0이면 사용 안 함)
+ *          checkpoint_wal_size checkpoint를 시작하는 로그 크기 (bytes, K/M/G 접미사 허용, 0이면 사용 안 함)
+ *          server_port         --server로 띄울 때 세션을 받는 TCP 포트
+ *          server_workers      세션을 실행하는 worker 스레드 수 (0이면 CPU 코어 수)
+ *          parallel_workers    병렬 스캔에 쓰는 스레드 수 (질의한 스레드 포함, 0이면 CPU 코어 수, 1이면 병렬 스캔 안 함)
+ *          prefetch_pages      순차 스캔이 미리 읽는 페이지 수 (0이면 read-ahead 안 함, 버퍼 풀 프레임 수의 1/4까지)
+ *          scan_ring_pages     버퍼 풀 프레임 수의 1/4보다 큰 테이블 스캔이 버퍼 풀 대신 쓰는 ring 크기 (0이면 안 씀)
+ *          work_mem            JOIN·ORDER BY가 메모리에 두는 최대 크기 (bytes, K/M/G 접미사 허용, 넘으면 파일로 나눔)
+ *          read_only           테이블 파일을 mmap해 스캔하고 쓰는 문장은 거부 (on/off, 읽기 전용 복제본용)
+ *
+ *          page_size는 첫 Page가 만들어지기 전에 정해져야 하므로 API 생성자에서 Load를 호출한다.
+ */
+class Config {
+private:
+  std::size_t page_size_;
+  std::size_t buffer_pool_pages_;
+  std::size_t buffer_pool_bytes_;  // 0이면 buffer_pool_pages_ 사용
+  bool buffer_pool_pages_set_;     // buffer_pool_pages를 설정함 (buffer_pool_size는 무시, 설정 순서와 무관)
+  std::string replacement_policy_;
+  bool wal_;
+  long wal_commit_delay_;
+  long bgwriter_delay_;
+  std::size_t bgwriter_max_pages_;
+  long checkpoint_interval_;
+  std::size_t checkpoint_wal_size_;
+  long server_port_;
+  long server_workers_;
+  long parallel_workers_;
+  long prefetch_pages_;
+  long scan_ring_pages_;
+  std::size_t work_mem_;
+  bool read_only_;
+
+  Config();
+  void Set(const std::string &key, const std::string &value);
+  void ReadFile(const std::string &file_name);
+
+public:
+  static Config &Instance();
+
+  /**
+   * @brief 설정 파일과 환경 변수를 읽음
+   *
+   * @param data_path 데이터 디렉토리 (기본 설정 파일 위치)
+   */
+  void Load(const std::string &data_path);
+
+  /**
+   * @brief "64M", "1G" 같은 크기 문자열을 bytes로 변환
+   *
+   * @return std::size_t 잘못된 형식이면 0
+   */
+  static std::size_t ParseSize(const std::string &value);
+
+  std::size_t page_size() const { return page_size_; }
+  std::size_t buffer_pool_pages() const;
+  std::string replacement_policy() const { return replacement_policy_; }
+  bool wal() const { return wal_; }
+  long wal_commit_delay() const { return wal_commit_delay_; }
+  long bgwriter_delay() const { return bgwriter_delay_; }
+  std::size_t bgwriter_max_pages() const { return bgwriter_max_pages_; }
+  long checkpoint_interval() const { return checkpoint_interval_; }
+  std::size_t checkpoint_wal_size() const { return checkpoint_wal_size_; }
+  long server_port() const { return server_port_; }
+  long server_workers() const { return server_workers_; }
+  std::size_t parallel_workers() const;
+  std::size_t prefetch_pages() const { return static_cast<std::size_t>(prefetch_pages_); }
+  std::size_t scan_ring_pages() const { return static_cast<std::size_t>(scan_ring_pages_); }
+  std::size_t work_mem() const { return work_mem_; }
+  bool read_only() const { return read_only_; }
+};
+
+#endif
@@ -0,0 +1,639 @@
+#include "cursor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "exceptions.h"
+#include "metrics.h"
+
+namespace {
+
+/**
+ * @brief 속성 값의 TKeyView 길이 (TKey(keytype, length)와 같은 규칙)
+ */
+int KeyLength(const Attribute &attr) {
+    return attr.data_type() == T_CHAR ? attr.length() : 4;
+}
+
+/**
+ * @brief 페이지 하나에서 조건을 검사한 행 수와 걸러진 행 수를 Metrics에 더함
+ */
+void CountFiltered(size_t rows, const std::vector<uint64_t> &selection) {
+    size_t matched = 0;
+    for (uint64_t word : selection) {
+        matched += __builtin_popcountll(word);
+    }
+    Metrics &metrics = Metrics::Instance();
+    metrics.Add(Metrics::ROWS_SCANNED, rows);
+    metrics.Add(Metrics::ROWS_FILTERED, rows - matched);
+}
+
+/**
+ * @brief 페이지의 레코드 주소를 모으고 조건을 한 번에 적용. 페이지는 고정되어 있어야 함
+ * @details PAX 페이지는 레코드 주소 대신 minipage로 거르며 records는 비어 있다.
+ *
+ * @return size_t 페이지의 행 수 (selection의 bit 수)
+ */
+size_t FilterPage(const Page &page, const Predicate &predicate, std::vector<const char *> &records,
+                  std::vector<uint64_t> &selection, BatchScratch &scratch) {
+    records.clear();
+    if (page.IsPax()) {
+        scratch.columns.clear();
+        scratch.widths.clear();
+        for (int c = 0; c < page.GetColumnCount(); c++) {
+            scratch.columns.push_back(page.GetColumn(c));
+            scratch.widths.push_back(page.GetColumnWidth(c));
+        }
+        size_t n = static_cast<size_t>(page.GetSlotCount());
+        predicate.MatchColumns(scratch.columns.data(), scratch.widths.data(), n, selection);
+        CountFiltered(n, selection);
+        return n;
+    }
+    for (const RecordRef &record : page.Records()) {
+        records.push_back(record.data);
+    }
+    predicate.MatchBatch(records.data(), records.size(), selection, scratch);
+    CountFiltered(records.size(), selection);
+    return records.size();
+}
+
+/**
+ * @brief PAX 페이지의 행 하나를 projection 속성별 TKeyView로 나눔. view는 각 minipage 안을 가리킴
+ */
+void ParseColumns(const Projection &projection, const Page &page, int row_no, std::vector<TKeyView> &row) {
+    row.resize(projection.columns.size());
+    for (size_t k = 0; k < projection.columns.size(); k++) {
+        const Attribute &attr = projection.schema[k];
+        int c = projection.columns[k];
+        row[k] = TKeyView(attr.data_type(), page.GetColumn(c) + row_no * page.GetColumnWidth(c), KeyLength(attr));
+    }
+}
+
+/**
+ * @brief 디렉토리 entry의 zone map으로 보아 조건을 만족하는 행이 없는 페이지인지 (페이지는 읽지 않음)
+ */
+bool Prunable(const Predicate &predicate, PageDirectory &dir, int page_idx) {
+    return predicate.UsesZoneMap() && !predicate.MayMatch(dir.GetEntries()[page_idx].zone);
+}
+
+/**
+ * @brief 범위를 벗어날 때 고정을 풂
+ */
+class PagePin {
+private:
+    std::shared_ptr<Page> page_;
+
+public:
+    explicit PagePin(const std::shared_ptr<Page> &page) : page_(page) { page_->Pin(); }
+    ~PagePin() { page_->Unpin(); }
+};
+
+}  // namespace
+
+/*=======================================RowSchema================================================ */
+void RowSchema::Append(Table *tbl) {
+    // Table::tb_name()은 파일 경로 (<path>/<db>/<table>.bin)
+    std::string name = tbl->tb_name();
+    name = name.substr(name.find_last_of('/') + 1);
+    name = name.substr(0, name.rfind(".bin"));
+    for (const Attribute &attr : tbl->ats()) {
+        attrs_.push_back(attr);
+        tables_.push_back(name);
+    }
+}
+
+int RowSchema::Find(const std::string &name) const {
+    size_t dot = name.find('.');
+    std::string table = dot == std::string::npos ? "" : name.substr(0, dot);
+    std::string attr = dot == std::string::npos ? name : name.substr(dot + 1);
+    int found = -1;
+    for (size_t i = 0; i < attrs_.size(); i++) {
+        if (attrs_[i].attr_name() != attr || (!table.empty() && tables_[i] != table)) {
+            continue;
+        }
+        if (found >= 0) {
+            throw AmbiguousAttributeException();
+        }
+        found = static_cast<int>(i);
+    }
+    return found;
+}
+
+Projection RowSchema::Project(const std::vector<std::string> &names) const {
+    Projection projection;
+    projection.all = names.empty();
+    if (projection.all) {
+        for (size_t i = 0; i < attrs_.size(); i++) {
+            projection.columns.push_back(static_cast<int>(i));
+        }
+        projection.schema = attrs_;
+        return projection;
+    }
+    for (const std::string &name : names) {
+        int i = Find(name);
+        if (i < 0) {
+            throw AttributeNotExistException();
+        }
+        projection.columns.push_back(i);
+        projection.schema.push_back(attrs_[i]);
+    }
+    return projection;
+}
+
+/*=======================================SeqScanCursor================================================ */
+SeqScanCursor::SeqScanCursor(BufferManager *bm, Table *tbl, Predicate predicate, Projection projection)
+    : bm_(bm), tbl_(tbl), file_(bm->GetFile(tbl->GetFile())), predicate_(std::move(predicate)),
+      projection_(std::move(projection)), ring_(file_->IsMapped() ? nullptr : bm->ScanStrategy(file_->GetPageCount())), dir_idx_(0), page_idx_(0), rows_(0), pos_(0), ahead_dir_(0), ahead_page_(0), ahead_count_(0) {
+    if (file_->IsMapped()) {
+        view_ = std::make_shared<Page>();
+        file_->AdviseSequential();
+    }
+}
+
+SeqScanCursor::~SeqScanCursor() {
+    ReleasePage();
+}
+
+void SeqScanCursor::ReleasePage() {
+    if (page_) {
+        page_->Unpin();
+        page_.reset();
+    }
+}
+
+bool SeqScanCursor::NextPage() {
+    ReleasePage();
+    while (dir_idx_ < file_->GetPageDirCount()) {
+        std::shared_ptr<PageDirectory> dir = file_->GetPageDirByIdx(dir_idx_);
+        if (page_idx_ >= dir->GetSize()) {
+            dir_idx_++;
+            page_idx_ = 0;
+            continue;
+        }
+        if (Prunable(predicate_, *dir, page_idx_)) {
+            page_idx_++;
+            continue;
+        }
+        if (view_) {
+            file_->ViewPage(*dir, page_idx_++, *view_);    // read-ahead는 커널이 함
+            page_ = view_;
+        } else {
+            ReadAhead(dir_idx_, page_idx_);
+            page_ = bm_->GetPage(tbl_->GetFile(), dir_idx_, page_idx_++, ring_.get());
+        }
+        page_->Pin();
+        rows_ = FilterPage(*page_, predicate_, records_, selection_, scratch_);
+        pos_ = 0;
+        return true;
+    }
+    return false;
+}
+
+void SeqScanCursor::ReadAhead(int dir_idx, int page_idx) {
+    size_t distance = bm_->prefetch_distance();
+    if (distance == 0) {
+        return;
+    }
+    if (ahead_dir_ < dir_idx || (ahead_dir_ == dir_idx && ahead_page_ <= page_idx)) {
+        // 요청한 범위를 지나침 (또는 처음). 버퍼 풀에서 읽히는 동안은 미리 읽지 않고, 처음 miss에서 시작
+        if (bm_->IsResident(tbl_->GetFile(), dir_idx, page_idx, ring_.get())) {
+            return;
+        }
+        ahead_dir_ = dir_idx;
+        ahead_page_ = page_idx + 1;
+        ahead_count_ = 0;
+    } else if (ahead_count_ > 0) {
+        ahead_count_--;          // 요청해 둔 페이지를 읽음
+    }
+    if (ahead_count_ > distance / 2) {
+        return;
+    }
+    std::vector<std::pair<int, int>> pages;
+    while (ahead_count_ < distance && ahead_dir_ < file_->GetPageDirCount()) {
+        std::shared_ptr<PageDirectory> dir = file_->GetPageDirByIdx(ahead_dir_);
+        if (ahead_page_ >= dir->GetSize()) {
+            ahead_dir_++;
+            ahead_page_ = 0;
+            continue;
+        }
+        if (Prunable(predicate_, *dir, ahead_page_)) {
+            ahead_page_++;
+            continue;
+        }
+        pages.push_back({ahead_dir_, ahead_page_++});
+        ahead_count_++;
+    }
+    bm_->Prefetch(tbl_->GetFile(), pages, ring_);
+}
+
+const std::vector<TKeyView> *SeqScanCursor::Next() {
+    while (true) {
+        while (page_ && pos_ < rows_) {
+            uint64_t word = selection_[pos_ >> 6] >> (pos_ & 63);
+            if (word == 0) {
+                pos_ = (pos_ | 63) + 1;  // 이 word에 남은 행 없음
+                continue;
+            }
+            pos_ += __builtin_ctzll(word);
+            if (page_->IsPax()) {
+                ParseColumns(projection_, *page_, static_cast<int>(pos_++), row_);
+            } else {
+                ParseRecord(tbl_, projection_, records_[pos_++], row_);
+            }
+            return &row_;
+        }
+        if (!NextPage()) {
+            return nullptr;
+        }
+    }
+}
+
+void ParseRecord(Table *tbl, const Projection &projection, const char *record, std::vector<TKeyView> &row) {
+    row.resize(projection.columns.size());
+    for (size_t k = 0; k < projection.columns.size(); k++) {
+        const Attribute &attr = projection.schema[k];
+        row[k] = TKeyView(attr.data_type(), record + tbl->GetAttributeOffset(projection.columns[k]), KeyLength(attr));
+    }
+}
+
+/*=======================================ProjectCursor================================================ */
+const std::vector<TKeyView> *ProjectCursor::Next() {
+    const std::vector<TKeyView> *input = input_->Next();
+    if (input == nullptr) {
+        return nullptr;
+    }
+    row_.resize(projection_.columns.size());
+    for (size_t k = 0; k < projection_.columns.size(); k++) {
+        row_[k] = (*input)[projection_.columns[k]];
+    }
+    return &row_;
+}
+
+/*=======================================RowBuffer================================================ */
+RowBuffer::RowBuffer(const std::vector<Attribute> &schema, Arena *arena)
+    : schema_(schema), row_len_(0), arena_(arena), chunk_shift_(0), size_(0) {
+    for (const Attribute &attr : schema_) {
+        offsets_.push_back(static_cast<int>(row_len_));
+        row_len_ += attr.length();
+    }
+    if (arena_ == nullptr) {
+        own_arena_.reset(new Arena());
+        arena_ = own_arena_.get();
+    }
+    while ((row_len_ << (chunk_shift_ + 1)) <= ROW_BUFFER_CHUNK_BYTES && chunk_shift_ < 16) {
+        chunk_shift_++;
+    }
+}
+
+char *RowBuffer::NextRow() {
+    if ((size_ >> chunk_shift_) >= chunks_.size()) {
+        chunks_.push_back(arena_->AllocateBytes(row_len_ << chunk_shift_));
+    }
+    char *dst = const_cast<char *>(row(size_));
+    size_++;
+    return dst;
+}
+
+void RowBuffer::Append(const std::vector<TKeyView> &row) {
+    Write(NextRow(), row);
+}
+
+void RowBuffer::Replace(size_t i, const std::vector<TKeyView> &row) {
+    Write(const_cast<char *>(this->row(i)), row);
+}
+
+void RowBuffer::Write(char *dst, const std::vector<TKeyView> &row) const {
+    for (size_t k = 0; k < schema_.size(); k++) {
+        const TKeyView &value = row[k];
+        if (value.key_type() == T_CHAR) {
+            size_t n = strnlen(value.key(), value.length());
+            memcpy(dst + offsets_[k], value.key(), n);
+            memset(dst + offsets_[k] + n, 0, schema_[k].length() - n);
+        } else {
+            memcpy(dst + offsets_[k], value.key(), schema_[k].length());
+        }
+    }
+}
+
+void RowBuffer::AppendRaw(const char *row) {
+    memcpy(NextRow(), row, row_len_);
+}
+
+TKeyView RowBuffer::Value(size_t i, size_t k) const {
+    const Attribute &attr = schema_[k];
+    return TKeyView(attr.data_type(), row(i) + offsets_[k], KeyLength(attr));
+}
+
+void RowBuffer::View(const char *row, std::vector<TKeyView> &out, size_t first) const {
+    out.resize(std::max(out.size(), first + schema_.size()));
+    for (size_t k = 0; k < schema_.size(); k++) {
+        const Attribute &attr = schema_[k];
+        out[first + k] = TKeyView(attr.data_type(), row + offsets_[k], KeyLength(attr));
+    }
+}
+
+/*=======================================BufferCursor================================================ */
+const std::vector<TKeyView> *BufferCursor::Next() {
+    size_t n = order_.empty() ? rows_->size() : order_.size();
+    if (pos_ >= n) {
+        return nullptr;
+    }
+    size_t i = order_.empty() ? pos_ : order_[pos_];
+    pos_++;
+    rows_->View(rows_->row(i), row_);
+    return &row_;
+}
+
+/*=======================================LimitCursor================================================ */
+const std::vector<TKeyView> *LimitCursor::Next() {
+    if (count_ >= limit_) {
+        return nullptr;
+    }
+    const std::vector<TKeyView> *row = input_->Next();
+    if (row != nullptr) {
+        count_++;
+    }
+    return row;
+}
+
+/*=======================================ParallelScanCursor================================================ */
+ParallelScanCursor::ParallelScanCursor(BufferManager *bm, Table *tbl, Predicate predicate, Projection projection,
+                                       WorkStealingPool &pool, bool limited)
+    : bm_(bm), tbl_(tbl), predicate_(std::move(predicate)), projection_(std::move(projection)), pool_(pool),
+      record_len_(0), row_len_(0), next_morsel_(0),
+      batch_morsels_(limited ? pool.slots() : pool.slots() * MORSELS_PER_SLOT),
+      slots_(pool.slots()), result_idx_(0), pos_(0) {
+    for (Attribute &attr : tbl_->ats()) {
+        record_len_ += attr.length();
+    }
+    for (const Attribute &attr : projection_.schema) {
+        row_offsets_.push_back(static_cast<int>(row_len_));
+        row_len_ += attr.length();
+    }
+    File *file = bm_->GetFile(tbl_->GetFile());
+    for (int d = 0; d < file->GetPageDirCount(); d++) {
+        int size = file->GetPageDirByIdx(d)->GetSize();
+        for (int begin = 0; begin < size; begin += MORSEL_PAGES) {
+            morsels_.push_back({d, begin, std::min(begin + MORSEL_PAGES, size)});
+        }
+    }
+    mapped_ = file->IsMapped();
+    if (mapped_) {
+        file->AdviseSequential();
+    } else {
+        ring_ = bm_->ScanStrategy(file->GetPageCount());
+    }
+}
+
+template <typename Emit>
+void ParallelScanCursor::ScanPages(const Morsel &morsel, SlotState &slot, Emit emit) {
+    File *file = bm_->GetFile(tbl_->GetFile());
+    std::shared_ptr<PageDirectory> dir = file->GetPageDirByIdx(morsel.dir_idx);
+    for (int i = morsel.page_begin; i < morsel.page_end; i++) {
+        if (Prunable(predicate_, *dir, i)) {
+            continue;
+        }
+        std::shared_ptr<Page> page;
+        if (mapped_) {
+            if (!slot.view) {
+                slot.view = std::make_shared<Page>();
+            }
+            file->ViewPage(*dir, i, *slot.view);
+            page = slot.view;
+        } else {
+            page = bm_->GetPage(tbl_->GetFile(), morsel.dir_idx, i, ring_.get());
+        }
+        if (page == nullptr) {
+            continue;
+        }
+        PagePin pin(page);
+        FilterPage(*page, predicate_, slot.records, slot.selection, slot.scratch);
+        bool pax = page->IsPax();
+        for (size_t w = 0; w < slot.selection.size(); w++) {
+            uint64_t word = slot.selection[w];
+            while (word != 0) {
+                size_t row = w * 64 + __builtin_ctzll(word);
+                emit(*page, row, pax ? nullptr : slot.records[row]);
+                word &= word - 1;
+            }
+        }
+    }
+}
+
+void ParallelScanCursor::Scan(const Morsel &morsel, SlotState &slot, MorselResult &result) {
+    result.data.clear();
+    result.count = 0;
+    ScanPages(morsel, slot, [this, &result](const Page &page, size_t row, const char *record) {
+        size_t end = result.data.size();
+        if (record == nullptr) {
+            result.data.resize(end + row_len_);
+            if (projection_.all) {
+                page.CopyRecord(static_cast<int>(row), result.data.data() + end);
+            } else {
+                for (size_t k = 0; k < projection_.columns.size(); k++) {
+                    int c = projection_.columns[k];
+                    memcpy(result.data.data() + end + row_offsets_[k],
+                           page.GetColumn(c) + row * page.GetColumnWidth(c), projection_.schema[k].length());
+                }
+            }
+        } else if (projection_.all) {
+            result.data.insert(result.data.end(), record, record + record_len_);
+        } else {
+            // 결과에 나갈 속성만 복사
+            result.data.resize(end + row_len_);
+            for (size_t k = 0; k < projection_.columns.size(); k++) {
+                memcpy(result.data.data() + end + row_offsets_[k],
+                       record + tbl_->GetAttributeOffset(projection_.columns[k]), projection_.schema[k].length());
+            }
+        }
+        result.count++;
+    });
+}
+
+size_t ParallelScanCursor::PlanBatch() {
+    size_t count = std::min(batch_morsels_, morsels_.size() - next_morsel_);
+    batch_morsels_ = std::min(batch_morsels_ * 2, pool_.slots() * MORSELS_PER_SLOT);
+    if (mapped_) {
+        return count;   // read-ahead는 커널이 함
+    }
+
+    // 이 묶음을 거르는 동안 다음 묶음의 앞 페이지를 읽어 둠
+    std::vector<std::pair<int, int>> ahead;
+    File *file = bm_->GetFile(tbl_->GetFile());
+    for (size_t m = next_morsel_ + count; m < morsels_.size() && ahead.size() < bm_->prefetch_distance(); m++) {
+        std::shared_ptr<PageDirectory> dir = file->GetPageDirByIdx(morsels_[m].dir_idx);
+        for (int i = morsels_[m].page_begin; i < morsels_[m].page_end && ahead.size() < bm_->prefetch_distance(); i++) {
+            if (!Prunable(predicate_, *dir, i)) {
+                ahead.push_back({morsels_[m].dir_idx, i});
+            }
+        }
+    }
+    bm_->Prefetch(tbl_->GetFile(), ahead, ring_);
+    return count;
+}
+
+bool ParallelScanCursor::NextBatch() {
+    if (next_morsel_ >= morsels_.size()) {
+        return false;
+    }
+    size_t count = PlanBatch();
+    size_t first = next_morsel_;
+    results_.resize(count);
+    pool_.ParallelFor(count, [this, first](size_t task, size_t slot) {
+        Scan(morsels_[first + task], slots_[slot], results_[task]);
+    });
+    next_morsel_ += count;
+    result_idx_ = 0;
+    pos_ = 0;
+    return true;
+}
+
+void ParallelScanCursor::ForEach(const std::function<void(size_t slot, const std::vector<TKeyView> &row)> &fn) {
+    while (next_morsel_ < morsels_.size()) {
+        size_t count = PlanBatch();
+        size_t first = next_morsel_;
+        pool_.ParallelFor(count, [this, first, &fn](size_t task, size_t slot) {
+            SlotState &state = slots_[slot];
+            ScanPages(morsels_[first + task], state, [this, &fn, &state, slot](const Page &page, size_t row,
+                                                                        const char *record) {
+                if (record == nullptr) {
+                    ParseColumns(projection_, page, static_cast<int>(row), state.row);
+                } else {
+                    ParseRecord(tbl_, projection_, record, state.row);
+                }
+                fn(slot, state.row);
+            });
+        });
+        next_morsel_ += count;
+    }
+    results_.clear();
+}
+
+const std::vector<TKeyView> *ParallelScanCursor::Next() {
+    while (true) {
+        while (result_idx_ < results_.size()) {
+            const MorselResult &result = results_[result_idx_];
+            if (pos_ < result.count) {
+                const char *data = result.data.data() + pos_++ * row_len_;
+                row_.resize(row_offsets_.size());
+                for (size_t k = 0; k < row_offsets_.size(); k++) {
+                    const Attribute &attr = projection_.schema[k];
+                    row_[k] = TKeyView(attr.data_type(), data + row_offsets_[k], KeyLength(attr));
+                }
+                return &row_;
+            }
+            result_idx_++;
+            pos_ = 0;
+        }
+        if (!NextBatch()) {
+            return nullptr;
+        }
+    }
+}
+
+/*=======================================IndexScanCursor================================================ */
+IndexScanCursor::IndexScanCursor(BufferManager *bm, Table *tbl, const Index &idx, Predicate predicate,
+                                 Projection projection)
+    : bm_(bm), tbl_(tbl), predicate_(std::move(predicate)), projection_(std::move(projection)),
+      tree_(bm, idx.file(), idx.key_type(), idx.key_len()),
+      has_upper_(false), upper_inclusive_(false) {
+    // 인덱스 속성에 걸린 조건 중 가장 좁은 범위를 고름
+    int offset = tbl->GetAttributeOffset(idx.attr_name());
+    const char *lower = nullptr;
+    for (const PredicateTerm &term : predicate_.terms()) {
+        if (term.offset != offset) continue;
+        TKeyView value(idx.key_type(), term.literal(), idx.key_len());
+        bool sets_lower = term.sign_type == SIGN_EQ || term.sign_type == SIGN_GT || term.sign_type == SIGN_GE;
+        bool sets_upper = term.sign_type == SIGN_EQ || term.sign_type == SIGN_LT || term.sign_type == SIGN_LE;
+        if (sets_lower && (lower == nullptr || TKeyView(idx.key_type(), lower, idx.key_len()) < value)) {
+            lower = term.literal();
+        }
+        if (sets_upper) {
+            bool inclusive = term.sign_type != SIGN_LT;
+            TKeyView upper(idx.key_type(), upper_.data(), idx.key_len());
+            if (!has_upper_ || value < upper || (value == upper && !inclusive)) {
+                upper_.assign(term.literal(), term.literal() + idx.key_len());
+                has_upper_ = true;
+                upper_inclusive_ = inclusive;
+            }
+        }
+    }
+
+    if (lower != nullptr) {
+        tree_.LowerBound(lower, &it_);
+    } else {
+        tree_.Begin(&it_);
+    }
+}
+
+IndexScanCursor::~IndexScanCursor() {
+    ReleasePage();
+}
+
+void IndexScanCursor::ReleasePage() {
+    if (page_) {
+        page_->Unpin();
+        page_.reset();
+    }
+}
+
+const std::vector<TKeyView> *IndexScanCursor::Next() {
+    ReleasePage();
+    while (it_.Valid()) {
+        if (has_upper_) {
+            TKeyView key(tree_.key_type(), it_.key(), tree_.key_len());
+            TKeyView upper(tree_.key_type(), upper_.data(), tree_.key_len());
+            if (upper < key || (!upper_inclusive_ && key == upper)) {
+                break;
+            }
+        }
+        RecordId rid = it_.rid();
+        it_.Next();
+
+        std::shared_ptr<Page> page = bm_->GetPage(tbl_->GetFile(), rid.dir_idx, rid.page_idx);
+        if (page == nullptr) {
+            continue;
+        }
+        const char *data;
+        RecordRef record;
+        if (page->IsPax()) {
+            record_.resize(tbl_->record_length());   // 행을 이어 붙인 복사본을 돌려줌
+            if (!page->CopyRecord(rid.slot_no, record_.data())) {
+                continue;
+            }
+            data = record_.data();
+        } else if (page->GetRecord(rid.slot_no, &record)) {
+            data = record.data;
+        } else {
+            continue;
+        }
+        Metrics::Instance().Add(Metrics::ROWS_SCANNED);
+        if (!predicate_.Match(data)) {
+            Metrics::Instance().Add(Metrics::ROWS_FILTERED);
+            continue;
+        }
+        page_ = page;
+        page_->Pin();
+        ParseRecord(tbl_, projection_, data, row_);
+        return &row_;
+    }
+    it_ = BPlusTreeIterator();  // leaf 고정 해제
+    return nullptr;
+}
+
+void PrintCursor(ResultCursor &cursor, std::ostream &out) {
+    for (const Attribute &attr : cursor.Schema()) {
+        out << std::setw(9) << std::left << attr.attr_name();
+    }
+    out << std::endl;
+
+    while (const std::vector<TKeyView> *row = cursor.Next()) {
+        for (const TKeyView &key : *row) {
+            out << key;
+        }
+        out << std::endl;
+    }
+    out << std::endl;
+}
@@ -0,0 +1,418 @@
+#ifndef ABCDB_CURSOR_H_
+#define ABCDB_CURSOR_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "catalog_manager.h"
+#include "sql_statement.h"
+#include "buffer_manager.h"
+#include "predicate.h"
+#include "bplus_tree.h"
+#include "work_stealing_pool.h"
+#include "arena.h"
+
+#define MORSEL_PAGES 16             // 병렬 스캔에서 task 하나가 읽는 페이지 수
+#define MORSELS_PER_SLOT 4          // 병렬 스캔이 한 번에 처리하는 morsel 수 = 스레드 수 * MORSELS_PER_SLOT
+#define PARALLEL_SCAN_MIN_PAGES 64  // 이보다 페이지가 적은 테이블은 한 스레드로 읽음
+#define ROW_BUFFER_CHUNK_BYTES (32 * 1024)  // RowBuffer가 arena에서 한 번에 잡는 크기
+
+/**
+ * @brief 결과 행을 하나씩 꺼내는 pull 방식(Volcano) 커서
+ * @details 행은 TKeyView 배열이며 페이지 프레임을 직접 가리킨다. 반환된 행은 다음 Next() 호출이나
+ *          커서가 소멸될 때까지만 유효하므로, 보관하려면 TKey로 복사해야 한다.
+ */
+class ResultCursor {
+public:
+    virtual ~ResultCursor() {}
+
+    /**
+     * @brief 결과 행의 속성 목록
+     */
+    virtual const std::vector<Attribute> &Schema() = 0;
+
+    /**
+     * @brief 다음 결과 행
+     *
+     * @return const std::vector<TKeyView>* 결과 행, 더 이상 없으면 nullptr
+     */
+    virtual const std::vector<TKeyView> *Next() = 0;
+};
+
+/**
+ * @brief 결과 행에 담을 속성 (SELECT 목록)
+ * @details 커서는 이 속성들의 TKeyView만 만들고, ParallelScanCursor는 이 속성 값만 복사한다.
+ */
+struct Projection {
+    std::vector<int> columns;           // 결과 순서의 Table::ats() 위치
+    std::vector<Attribute> schema;      // 결과 행의 속성
+    bool all = false;                   // 모든 속성을 입력 순서대로 (SELECT *)
+};
+
+/**
+ * @brief 입력 행의 속성을 이름("속성" 또는 "테이블.속성")으로 찾음
+ * @details 테이블 하나를 읽으면 그 테이블의 속성이고, JOIN이면 왼쪽 테이블 속성 뒤에 오른쪽 테이블 속성이 온다.
+ */
+class RowSchema {
+private:
+    std::vector<Attribute> attrs_;
+    std::vector<std::string> tables_;   // 속성별 테이블 이름
+
+public:
+    explicit RowSchema(Table *tbl) { Append(tbl); }
+
+    /**
+     * @brief 테이블의 속성을 뒤에 붙임 (JOIN의 오른쪽 테이블)
+     */
+    void Append(Table *tbl);
+
+    const std::vector<Attribute> &attrs() const { return attrs_; }
+    const std::string &table(int i) const { return tables_[i]; }
+
+    /**
+     * @brief 속성 위치
+     *
+     * @return int 없으면 -1
+     * @throw AmbiguousAttributeException 테이블 이름 없이 쓴 속성이 두 테이블에 모두 있음
+     */
+    int Find(const std::string &name) const;
+
+    /**
+     * @brief SELECT 목록으로 projection을 만듦. 비어 있으면 SELECT *
+     *
+     * @throw AttributeNotExistException 없는 속성
+     */
+    Projection Project(const std::vector<std::string> &names) const;
+};
+
+/**
+ * @brief 테이블 파일의 페이지를 디렉토리 순서대로 읽으며 WHERE 조건을 만족하는 행을 돌려주는 커서
+ * @details 현재 읽고 있는 페이지 하나만 버퍼 풀에 고정한다. 페이지를 고정할 때 페이지의 모든 레코드에
+ *          Predicate::MatchBatch를 한 번에 적용하고, Next()는 selection bitmap에서 다음 행을 꺼낸다.
+ *          PAX 페이지는 Predicate::MatchColumns로 조건에 쓰인 minipage만 읽고, 행은 minipage를 직접 가리킨다.
+ *          디렉토리 entry의 zone map으로 조건을 만족할 수 없는 페이지(Predicate::MayMatch)는 읽지도 미리 읽지도 않는다.
+ *          버퍼 풀에 없는 페이지를 만나면 BufferManager::prefetch_distance()만큼 앞의 페이지를 미리 읽도록 요청해,
+ *          현재 페이지를 거르는 동안 다음 페이지의 I/O가 진행되게 한다.
+ *          큰 테이블(BufferManager::ScanStrategy)은 버퍼 풀에 없는 페이지를 ScanRing으로 읽어 버퍼 풀을 밀어내지 않는다.
+ *          read_only 설정으로 파일을 mmap했으면 버퍼 풀과 read-ahead 대신 File::ViewPage로 블록을 복사 없이 가리킨다.
+ */
+class SeqScanCursor : public ResultCursor {
+private:
+    BufferManager *bm_;
+    Table *tbl_;
+    File *file_;
+    Predicate predicate_;
+    Projection projection_;
+    std::shared_ptr<ScanRing> ring_;    // nullptr이면 버퍼 풀로 읽음
+    std::shared_ptr<Page> view_;        // 파일을 mmap했으면 버퍼 풀 대신 블록을 가리키는 페이지
+
+    int dir_idx_;                   // 다음에 읽을 페이지의 디렉토리 index
+    int page_idx_;                  // 다음에 읽을 페이지 index
+    std::shared_ptr<Page> page_;    // 현재 고정 중인 페이지
+    std::vector<const char *> records_; // 현재 페이지의 레코드 시작 주소
+    std::vector<uint64_t> selection_;   // 현재 페이지 행 중 조건을 만족한 행의 bitmap
+    BatchScratch scratch_;
+    size_t rows_;                       // 현재 페이지의 행 수 (PAX 페이지는 records_가 비어 있음)
+    size_t pos_;                        // 다음에 확인할 행 번호
+    std::vector<TKeyView> row_;
+
+    int ahead_dir_;                     // 다음에 미리 읽기를 요청할 페이지
+    int ahead_page_;
+    size_t ahead_count_;                // 요청했지만 아직 스캔이 닿지 않은 페이지 수
+
+    /**
+     * @brief 읽을 페이지 뒤로 prefetch_distance만큼 요청되어 있게 함 (절반 넘게 남았으면 다음에)
+     */
+    void ReadAhead(int dir_idx, int page_idx);
+
+    /**
+     * @brief 현재 페이지의 고정을 풀고 다음 페이지를 고정
+     *
+     * @return false 더 읽을 페이지 없음
+     */
+    bool NextPage();
+    void ReleasePage();
+
+public:
+    SeqScanCursor(BufferManager *bm, Table *tbl, Predicate predicate, Projection projection);
+    ~SeqScanCursor();
+
+    const std::vector<Attribute> &Schema() { return projection_.schema; }
+    const std::vector<TKeyView> *Next();
+};
+
+/**
+ * @brief 테이블 페이지를 morsel(한 디렉토리 안의 연속된 MORSEL_PAGES개 페이지) 단위로 나눠 여러 스레드에서 읽는 커서
+ * @details 열 때 PageDirectory 체인을 morsel 목록으로 나누고, Next()가 현재 묶음을 다 꺼내면 다음
+ *          (스레드 수 * MORSELS_PER_SLOT)개 morsel을 WorkStealingPool::ParallelFor로 한 번에 처리한다.
+ *          각 스레드는 페이지를 고정한 채 Predicate::MatchBatch로 거르고, 조건을 만족한 행의 projection 속성만 morsel별 버퍼에 복사한다.
+ *          결과는 morsel 순서로 이어 붙이므로 SeqScanCursor와 같은 순서로 나오며, 메모리는 묶음 하나의 결과만큼만 쓴다.
+ *          묶음을 처리하기 전에 다음 묶음의 앞 페이지들(prefetch_distance개)을 미리 읽도록 요청한다.
+ *          SeqScanCursor처럼 큰 테이블은 ScanRing으로 읽고 (스레드들이 ring 하나를 같이 씀), zone map으로 거른 페이지는 건너뛴다.
+ *          파일을 mmap했으면 스레드마다 페이지 하나로 블록을 가리킨다 (File::ViewPage).
+ *
+ *          스레드들은 커서를 연 스레드가 잡은 statement latch(shared) 아래에서 버퍼 풀을 읽는다.
+ */
+class ParallelScanCursor : public ResultCursor {
+private:
+    struct Morsel {
+        int dir_idx;
+        int page_begin;
+        int page_end;       // 포함하지 않음
+    };
+
+    /**
+     * @brief morsel 하나에서 조건을 만족한 행의 복사본 (행마다 projection 속성을 이어 붙임)
+     */
+    struct MorselResult {
+        std::vector<char> data;
+        size_t count;
+    };
+
+    /**
+     * @brief 스레드(slot)마다 재사용하는 작업 공간
+     */
+    struct SlotState {
+        std::vector<const char *> records;
+        std::vector<uint64_t> selection;
+        BatchScratch scratch;
+        std::vector<TKeyView> row;      // ForEach에 넘기는 행
+        std::shared_ptr<Page> view;     // 파일을 mmap했을 때 블록을 가리키는 페이지
+    };
+
+    BufferManager *bm_;
+    Table *tbl_;
+    Predicate predicate_;
+    Projection projection_;
+    WorkStealingPool &pool_;
+    size_t record_len_;
+    size_t row_len_;                    // 결과 버퍼의 행 길이 (projection 속성 길이의 합)
+    std::vector<int> row_offsets_;      // 결과 버퍼 행 안의 projection 속성 위치
+    std::shared_ptr<ScanRing> ring_;
+    bool mapped_;                       // 테이블 파일을 mmap해 버퍼 풀 없이 읽음
+
+    std::vector<Morsel> morsels_;
+    size_t next_morsel_;                // 다음 묶음의 첫 morsel
+    size_t batch_morsels_;              // 다음 묶음의 morsel 수
+    std::vector<MorselResult> results_; // 현재 묶음의 morsel별 결과
+    std::vector<SlotState> slots_;
+    size_t result_idx_;                 // 꺼내는 중인 results_ 위치
+    size_t pos_;                        // results_[result_idx_]에서 다음 행
+    std::vector<TKeyView> row_;
+
+    /**
+     * @brief morsel의 페이지를 고정한 채 거르고, 조건을 만족한 행마다 emit(page, row 번호, 레코드)를 부름
+     * @details 레코드는 slotted 페이지에서만 주어지며 PAX 페이지면 nullptr이다.
+     */
+    template <typename Emit>
+    void ScanPages(const Morsel &morsel, SlotState &slot, Emit emit);
+
+    void Scan(const Morsel &morsel, SlotState &slot, MorselResult &result);
+
+    /**
+     * @brief 다음 묶음의 morsel 수를 정하고 그 다음 묶음의 앞 페이지를 미리 읽도록 요청
+     */
+    size_t PlanBatch();
+
+    /**
+     * @brief 다음 묶음의 morsel을 병렬로 처리
+     *
+     * @return false 남은 morsel 없음
+     */
+    bool NextBatch();
+
+public:
+    /**
+     * @param limited LIMIT가 있음. 묶음을 스레드당 morsel 하나로 시작해 두 배씩 늘리므로 적은 행만 필요하면 덜 읽음
+     */
+    ParallelScanCursor(BufferManager *bm, Table *tbl, Predicate predicate, Projection projection,
+                       WorkStealingPool &pool, bool limited = false);
+
+    const std::vector<Attribute> &Schema() { return projection_.schema; }
+    const std::vector<TKeyView> *Next();
+
+    /**
+     * @brief 남은 행을 모아 두지 않고 스레드마다 fn(slot, row)로 넘김 (Next 대신 씀)
+     * @details row는 고정된 페이지 안을 가리키며 fn이 돌아온 뒤에는 유효하지 않다. 같은 slot으로 fn이 동시에
+     *          불리지 않으므로 slot별 상태(예: 부분 집계)를 잠금 없이 갱신할 수 있다. slot은 0..pool.slots()-1.
+     *
+     * @throw fn이 던진 첫 예외
+     */
+    void ForEach(const std::function<void(size_t slot, const std::vector<TKeyView> &row)> &fn);
+};
+
+/**
+ * @brief B+Tree 인덱스로 key 범위의 레코드 id를 찾아 레코드를 읽는 커서
+ * @details 인덱스 속성에 걸린 =, <, <=, >, >= 조건으로 범위를 정하고, 읽은 레코드에는 전체 조건을 다시 적용한다.
+ *          결과는 인덱스 key 순서로 나온다. 현재 leaf 노드와 현재 행이 있는 페이지를 고정한다.
+ */
+class IndexScanCursor : public ResultCursor {
+private:
+    BufferManager *bm_;
+    Table *tbl_;
+    Predicate predicate_;
+    Projection projection_;
+    BPlusTree tree_;
+    BPlusTreeIterator it_;
+
+    bool has_upper_;
+    bool upper_inclusive_;
+    std::vector<char> upper_;       // 범위의 끝 key
+
+    std::shared_ptr<Page> page_;    // 현재 행이 있는 페이지 (고정)
+    std::vector<char> record_;      // PAX 페이지에서 복사한 현재 행
+    std::vector<TKeyView> row_;
+
+    void ReleasePage();
+
+public:
+    IndexScanCursor(BufferManager *bm, Table *tbl, const Index &idx, Predicate predicate, Projection projection);
+    ~IndexScanCursor();
+
+    const std::vector<Attribute> &Schema() { return projection_.schema; }
+    const std::vector<TKeyView> *Next();
+};
+
+/**
+ * @brief 입력 커서의 앞 limit개 행만 돌려줌 (LIMIT n)
+ * @details limit개를 꺼낸 뒤에는 입력 커서의 Next()를 부르지 않으므로 남은 페이지는 읽지 않는다.
+ */
+class LimitCursor : public ResultCursor {
+private:
+    std::unique_ptr<ResultCursor> input_;
+    size_t limit_;
+    size_t count_;
+
+public:
+    LimitCursor(std::unique_ptr<ResultCursor> input, size_t limit) : input_(std::move(input)), limit_(limit), count_(0) {}
+
+    const std::vector<Attribute> &Schema() { return input_->Schema(); }
+    const std::vector<TKeyView> *Next();
+};
+
+/**
+ * @brief 입력 커서 행에서 projection 속성만 골라 돌려줌 (JOIN 결과의 SELECT 목록)
+ */
+class ProjectCursor : public ResultCursor {
+private:
+    std::unique_ptr<ResultCursor> input_;
+    Projection projection_;
+    std::vector<TKeyView> row_;
+
+public:
+    ProjectCursor(std::unique_ptr<ResultCursor> input, Projection projection)
+        : input_(std::move(input)), projection_(std::move(projection)) {}
+
+    const std::vector<Attribute> &Schema() { return projection_.schema; }
+    const std::vector<TKeyView> *Next();
+};
+
+/**
+ * @brief 질의의 커서 트리와 그 트리가 쓰는 Arena를 같이 들고 있는 커서
+ * @details 커서가 먼저 소멸한 뒤 arena가 잡은 메모리를 한 번에 놓는다 (행마다 따로 해제하지 않음).
+ */
+class ArenaCursor : public ResultCursor {
+private:
+    std::unique_ptr<Arena> arena_;      // input_보다 먼저 선언해 나중에 소멸
+    std::unique_ptr<ResultCursor> input_;
+
+public:
+    ArenaCursor(std::unique_ptr<Arena> arena, std::unique_ptr<ResultCursor> input)
+        : arena_(std::move(arena)), input_(std::move(input)) {}
+
+    const std::vector<Attribute> &Schema() { return input_->Schema(); }
+    const std::vector<TKeyView> *Next() { return input_->Next(); }
+};
+
+/**
+ * @brief 행을 복사해 모아 두는 버퍼. 행마다 속성 값을 이어 붙이며 CHAR 값은 NULL 뒤를 0으로 채움
+ * @details 행은 Arena에서 잡은 chunk(2의 거듭제곱 개 행, 약 ROW_BUFFER_CHUNK_BYTES)에 담는다. 행이 늘어도 이미 넣은
+ *          행을 옮겨 복사하지 않으며 row(i)의 주소는 Clear 전까지 그대로다. Clear는 chunk를 놓지 않고 처음부터 다시 채운다.
+ */
+class RowBuffer {
+private:
+    std::vector<Attribute> schema_;
+    std::vector<int> offsets_;          // 행 안의 속성 위치
+    size_t row_len_;
+    std::unique_ptr<Arena> own_arena_;  // arena를 받지 않았을 때만
+    Arena *arena_;
+    std::vector<char *> chunks_;
+    size_t chunk_shift_;                // chunk 하나의 행 수 = 1 << chunk_shift_
+    size_t size_;
+
+    void Write(char *dst, const std::vector<TKeyView> &row) const;
+
+    /**
+     * @brief 다음 행 자리 (chunk가 모자라면 arena에서 잡음)
+     */
+    char *NextRow();
+
+public:
+    /**
+     * @param arena 행을 담을 arena. nullptr이면 버퍼가 따로 잡음
+     */
+    explicit RowBuffer(const std::vector<Attribute> &schema, Arena *arena = nullptr);
+
+    void Append(const std::vector<TKeyView> &row);
+
+    /**
+     * @brief i번째 행을 row로 덮어씀
+     */
+    void Replace(size_t i, const std::vector<TKeyView> &row);
+
+    /**
+     * @brief 행 바이트(row_len() 길이)를 그대로 붙임
+     */
+    void AppendRaw(const char *row);
+    void Clear() { size_ = 0; }
+
+    size_t size() const { return size_; }
+    size_t bytes() const { return size_ * row_len_; }
+    size_t row_len() const { return row_len_; }
+    const std::vector<Attribute> &schema() const { return schema_; }
+    const char *row(size_t i) const {
+        return chunks_[i >> chunk_shift_] + (i & ((static_cast<size_t>(1) << chunk_shift_) - 1)) * row_len_;
+    }
+
+    /**
+     * @brief i번째 행의 속성 k
+     */
+    TKeyView Value(size_t i, size_t k) const;
+
+    /**
+     * @brief 행 바이트를 속성별 TKeyView로 나눔. out[first..]에 씀
+     */
+    void View(const char *row, std::vector<TKeyView> &out, size_t first = 0) const;
+};
+
+/**
+ * @brief RowBuffer의 행을 order 순서로 돌려주는 커서 (order가 비어 있으면 넣은 순서)
+ */
+class BufferCursor : public ResultCursor {
+private:
+    std::shared_ptr<RowBuffer> rows_;
+    std::vector<uint32_t> order_;
+    size_t pos_;
+    std::vector<TKeyView> row_;
+
+public:
+    BufferCursor(std::shared_ptr<RowBuffer> rows, std::vector<uint32_t> order)
+        : rows_(std::move(rows)), order_(std::move(order)), pos_(0) {}
+
+    const std::vector<Attribute> &Schema() { return rows_->schema(); }
+    const std::vector<TKeyView> *Next();
+};
+
+/**
+ * @brief 레코드를 projection 속성별 TKeyView로 나눔. 할당 없이 row를 재사용하며 view는 레코드 안을 가리킴
+ */
+void ParseRecord(Table *tbl, const Projection &projection, const char *record, std::vector<TKeyView> &row);
+
+/**
+ * @brief 커서의 남은 행을 표 형태로 출력
+ */
+void PrintCursor(ResultCursor &cursor, std::ostream &out);
+
+#endif
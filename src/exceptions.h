@@ -19,6 +19,8 @@ class IndexAlreadyExistsException : public std::exception {};
 
 class IndexNotExistException : public std::exception {};
 
+class AttributeNotExistException : public std::exception {};
+
 class OneIndexEachTableException : public std::exception {};
 
 class BPlusTreeException : public std::exception {};
@@ -27,4 +29,24 @@ class IndexMustBeCreatedOnPKException : public std::exception {};
 
 class PrimaryKeyConflictException : public std::exception {};
 
+class BufferPoolFullException : public std::exception {};
+
+class InvalidFileFormatException : public std::exception {};
+
+class PreparedStatementNotExistException : public std::exception {};
+
+class AttributeNotGroupedException : public std::exception {};
+
+class InvalidAggregateException : public std::exception {};
+
+class AggregateOverflowException : public std::exception {};
+
+class AmbiguousAttributeException : public std::exception {};
+
+class InvalidJoinException : public std::exception {};
+
+class RowTooLargeException : public std::exception {};
+
+class ReadOnlyException : public std::exception {};
+
 #endif
\ No newline at end of file
@@ -1,167 +1,434 @@
 #include "execution_engine.h"
 
 #include<iomanip>
+#include <algorithm>
+#include <atomic>
 #include <string>
+#include <boost/filesystem.hpp>
+#include "aggregate.h"
+#include "sort.h"
+#include "config.h"
+#include "session_output.h"
+
+namespace {
+
+std::atomic<unsigned long> spill_sequence(0);   // 동시에 실행되는 JOIN·정렬의 spill 파일 이름을 나눔
+
+/**
+ * @brief 연산자 하나의 spill 파일 경로 앞부분. <data path>/.tmp/를 만듦
+ */
+std::string NewSpillPrefix(const std::string &path, const std::string &op) {
+    std::string dir = path + TEMP_DIR_NAME;
+    boost::filesystem::create_directories(dir);
+    return dir + op + std::to_string(spill_sequence.fetch_add(1)) + "_";
+}
+
+/**
+ * @brief 테이블 형식의 빈 페이지에도 들어가지 않는 레코드면 거부 (새 페이지를 잡기 전에 확인)
+ *
+ * @throw RowTooLargeException
+ */
+void CheckRecordFits(Table *tbl, int content_len) {
+    Page empty(tbl->GetFile(), 0);
+    empty.ApplyFormat(tbl->GetPageFormat());
+    if (!empty.HasEnoughSpace(content_len)) {
+        throw RowTooLargeException();
+    }
+}
+
+/**
+ * @brief 조건의 속성 이름을 schema에서 찾아 "테이블.속성"을 속성 이름만으로 바꿈
+ *
+ * @throw AttributeNotExistException 없는 속성
+ */
+std::vector<SQLWhere> ResolveWheres(const RowSchema &schema, const std::vector<SQLWhere> &wheres) {
+    std::vector<SQLWhere> resolved;
+    for (const SQLWhere &where : wheres) {
+        int i = schema.Find(where.key);
+        if (i < 0) {
+            throw AttributeNotExistException();
+        }
+        resolved.push_back(where);
+        resolved.back().key = schema.attrs()[i].attr_name();
+    }
+    return resolved;
+}
+
+}  // namespace
 
 /*=======================================ExecutionEngine================================================ */
-void ExecutionEngine::Insert(SQLInsert &st){
-    unsigned long values_size = st.values().size();
-    std::string file_name( cm_->path() +db_name_+ "/" + st.tb_name() + ".bin");
-    Table *tbl = cm_->GetDB(db_name_)->GetTable(file_name);
-    
+Table *ExecutionEngine::GetTable(const std::string &tb_name) {
+    Table *tbl = NULL;
+    if (tables_ != nullptr) {
+        tbl = tables_->Get(tb_name);
+    } else {
+        Database *db = cm_->GetDB(db_name_);
+        if (db == NULL) {
+            throw DatabaseNotExistException();
+        }
+        tbl = db->GetTable(cm_->path() + db_name_ + "/" + tb_name + ".bin");
+    }
     if (tbl == NULL) {
         throw TableNotExistException();
     }
+    return tbl;
+}
 
-    int content_len = 0;
-    std::vector<TKey> tkey_values;
-    for (int i = 0; i < values_size; i++) {
-        int value_type = st.values()[i].data_type;
-        std::string value = st.values()[i].value;
+void ExecutionEngine::EncodeRow(Table *tbl, const std::vector<SQLValue> &values, std::vector<char> &content,
+                                Arena &arena) {
+    if (values.size() != tbl->ats().size()) {
+        throw SyntaxErrorException();
+    }
+    arena.Reset();
+    content.clear();
+    for (size_t i = 0; i < values.size(); i++) {
         int length = tbl->ats()[i].length();
-        content_len += length;
+        TKey tmp(values[i].data_type, length, arena);
+        tmp.ReadValue(values[i].value.c_str());
+        content.insert(content.end(), tmp.key(), tmp.key() + tmp.length());
+    }
+}
 
-        TKey tmp(value_type, length);
-        tmp.ReadValue(value.c_str());
-        tkey_values.push_back(tmp);
+void ExecutionEngine::InsertRecord(Table *tbl, const char *content, int content_len) {
+    // free space map이 알려준 페이지를 읽어 실제 공간을 확인. 힌트가 틀렸으면 FSM을 고치고 다시 찾음
+    File *file = bm_->GetFile(tbl->GetFile());
+    std::shared_ptr<Page> page;
+    int dir_idx, page_idx;
+    while (file->FindPageWithSpace(content_len, tbl->storage() == STORAGE_PAX, &dir_idx, &page_idx)) {
+        std::shared_ptr<Page> candidate = bm_->GetPage(tbl->GetFile(), dir_idx, page_idx);
+        if (candidate && candidate->HasEnoughSpace(content_len)) {
+            page = candidate;
+            break;
+        }
+        if (!candidate) {
+            break;
+        }
+        file->UpdateEntry(*candidate);
     }
-    
-    char* content = new char[content_len+1];
-    char* content_ptr = content;
-    for (std::vector<TKey>::iterator iter = tkey_values.begin(); iter != tkey_values.end(); ++iter) {
-        std::memcpy(content_ptr, iter->key(), iter->length());
-        content_ptr += iter->length();
+    if (!page) {
+        CheckRecordFits(tbl, content_len);
+        page = bm_->NewPage(tbl->GetFile(), tbl->GetPageFormat());
+        new_pages_ = true;
+    }
+    if (!bm_->WriteBlock(page, content, content_len)) {
+        throw RowTooLargeException();
     }
 
-    std::shared_ptr<Page> bPage = bm_->GetEnoughSpacePage(tbl->GetFile(), content_len);
-    
-    if(!bPage) {
-        File file(tbl->GetFile());
-        std::shared_ptr<PageDirectory> dir = file.GetPageDir(0);
-        std::shared_ptr<Page> page = file.GetEnoughSpacePage(content_len);
-        
-        if(page == nullptr){
-            std::shared_ptr<Page> new_page = std::make_shared<Page>(tbl->GetFile(), dir->GetIdx());
-            new_page->SetFilename(tbl->GetFile());
-            dir = file.AddPageToDirectory(*dir, *new_page);
-            new_page->InsertRecord(content, content_len);
-            file.WritePageToFile(*dir, *new_page);
-        } else {
-            page->InsertRecord(content, content_len);
-            file.WritePageToFile(*dir, *page);
+    // 테이블의 모든 인덱스에 (key, 레코드 id) 추가
+    RecordId rid = {page->GetDirIdx(), page->GetPageIdx(), page->GetSlotCount() - 1};
+    for (const Index &idx : tbl->ids()) {
+        BPlusTree tree(bm_, idx.file(), idx.key_type(), idx.key_len());
+        tree.Insert(content + tbl->GetAttributeOffset(idx.attr_name()), rid);
+    }
+}
+
+void ExecutionEngine::Insert(SQLInsert &st){
+    Table *tbl = GetTable(st.tb_name());
+
+    std::vector<std::vector<SQLValue>> &rows = st.rows();
+    std::vector<char> content;
+    Arena arena;
+    if (rows.size() <= 1) {
+        for (const std::vector<SQLValue> &row : rows) {
+            EncodeRow(tbl, row, content, arena);
+            InsertRecord(tbl, content.data(), static_cast<int>(content.size()));
         }
-        file.WritePageDirToFile(*dir);
-        cm_->WriteArchiveFile();
-    } else {
-        bPage->SetFilename(tbl->GetFile());
-        bm_->WriteBlock(bPage, content, content_len);
+        SyncNewPages(tbl);
+        return;
+    }
+
+    // 행을 모두 검사한 뒤 적재 (중간에 잘못된 행이 있으면 아무것도 쓰지 않음)
+    std::vector<char> records;
+    int record_len = 0;
+    for (const std::vector<SQLValue> &row : rows) {
+        EncodeRow(tbl, row, content, arena);
+        record_len = static_cast<int>(content.size());
+        records.insert(records.end(), content.begin(), content.end());
+    }
+    CheckRecordFits(tbl, record_len);  // 레코드는 고정 길이라 한 번만 확인
+
+    // 빈 페이지 하나를 채우지 못하는 batch는 기존 페이지의 빈 공간에 넣음
+    if (static_cast<int>(rows.size()) < BulkLoader::RecordsPerPage(record_len)) {
+        for (size_t i = 0; i < rows.size(); i++) {
+            InsertRecord(tbl, records.data() + i * record_len, record_len);
+        }
+        SyncNewPages(tbl);
+        return;
     }
+    BulkLoader loader(bm_, tbl);
+    for (size_t i = 0; i < rows.size(); i++) {
+        if (!loader.Add(records.data() + i * record_len, record_len)) {
+            throw RowTooLargeException();
+        }
+    }
+    loader.Finish();
 }
 
-void ExecutionEngine::Select(SQLSelect &st) {
-    std::string file_name(cm_->path() + db_name_ + "/" + st.tb_name() + ".bin");
-    Table *tbl = cm_->GetDB(db_name_)->GetTable(file_name);
+void ExecutionEngine::SyncNewPages(Table *tbl) {
+    if (new_pages_ && bm_->wal() != nullptr) {
+        bm_->GetFile(tbl->GetFile())->Sync();   // BulkLoader::Finish와 같이 commit 전에 페이지 등록을 내림
+    }
+    new_pages_ = false;
+}
+
+void ExecutionEngine::CheckInsert(SQLInsert &st) {
+    Table *tbl = GetTable(st.tb_name());
+    for (const std::vector<SQLValue> &row : st.rows()) {
+        if (row.size() != tbl->ats().size()) {
+            throw SyntaxErrorException();
+        }
+    }
+}
+
+void ExecutionEngine::CreateIndex(SQLCreateIndex &st) {
+    Database *db = cm_->GetDB(db_name_);
+    if (db == NULL) {
+        throw DatabaseNotExistException();
+    }
+    Table *tbl = GetTable(st.tb_name());
+    for (Table &t : db->tbs()) {
+        if (t.GetIndex(st.index_name()) != NULL) {
+            throw IndexAlreadyExistsException();
+        }
+    }
+    Attribute *attr = tbl->GetAttribute(st.col_name());
+    if (attr == NULL) {
+        throw AttributeNotExistException();
+    }
+    if (tbl->GetIndexByAttr(st.col_name()) != NULL) {
+        throw IndexAlreadyExistsException();
+    }
+
+    int key_len = attr->data_type() == T_CHAR ? attr->length() : 4;
+    Index idx(st.index_name(), st.col_name(), attr->data_type(), key_len,
+              cm_->path() + db_name_ + "/" + st.index_name() + ".idx");
+    bm_->LogReindex(tbl->GetFile());  // 인덱스 페이지는 로그가 없으므로 중단되면 복구할 때 다시 만듦
+    BuildIndex(tbl, idx);
+    tbl->AddIndex(idx);
+}
 
-    for (int i = 0; i < tbl->GetAttributeNum(); ++i) {
-        std::cout << std::setw(9) << std::left << tbl->ats()[i].attr_name();
+void ExecutionEngine::RebuildIndexes(Table *tbl) {
+    for (const Index &idx : tbl->ids()) {
+        BuildIndex(tbl, idx);
     }
-    std::cout << std::endl;
+}
 
-    File file(tbl->GetFile());
-    std::shared_ptr<PageDirectory> dir = file.GetPageDir(0);
-    std::vector<std::vector<TKey>> tkey_values;
-    bm_->SetFile(file_name);
-    do {
+void ExecutionEngine::BuildIndex(Table *tbl, const Index &idx) {
+    bm_->DropFile(idx.file());  // 이전에 남은 같은 이름의 인덱스 파일 제거
+    BPlusTree tree(bm_, idx.file(), idx.key_type(), idx.key_len());
+
+    int attr_index = tbl->GetAttributeIndex(idx.attr_name());
+    File *file = bm_->GetFile(tbl->GetFile());
+    for (int d = 0; d < file->GetPageDirCount(); d++) {
+        std::shared_ptr<PageDirectory> dir = file->GetPageDirByIdx(d);
         for (int i = 0; i < dir->GetSize(); i++) {
-            std::shared_ptr<Page> page = bm_->GetPageFromBufferPool(tbl->GetFile(), i);
-            if (!page) {
-                page = bm_->GetPageFromDisk(*dir, i);
+            std::shared_ptr<Page> page = bm_->GetPage(tbl->GetFile(), dir->GetIdx(), i);
+            page->Pin();
+            BulkLoader::InsertKeys(tree, *tbl, *page, attr_index);
+            page->Unpin();
+        }
+    }
+}
+
+void ExecutionEngine::DropIndex(SQLDropIndex &st) {
+    Database *db = cm_->GetDB(db_name_);
+    if (db == NULL) {
+        throw DatabaseNotExistException();
+    }
+    for (Table &t : db->tbs()) {
+        Index *idx = t.GetIndex(st.index_name());
+        if (idx != NULL) {
+            bm_->DropFile(idx->file());
+            t.DropIndex(st.index_name());
+            return;
+        }
+    }
+    throw IndexNotExistException();
+}
+
+void ExecutionEngine::Select(SQLSelect &st) {
+    std::unique_ptr<ResultCursor> cursor = OpenSelect(st);
+    PrintCursor(*cursor, SessionOut());
+}
+
+std::unique_ptr<ResultCursor> ExecutionEngine::OpenSelect(SQLSelect &st) {
+    Table *tbl = GetTable(st.tb_name());
+    Table *right = st.HasJoin() ? GetTable(st.join().tb_name) : NULL;
+    RowSchema schema(tbl);
+    if (right != NULL) {
+        if (right->GetFile() == tbl->GetFile()) {
+            throw InvalidJoinException();   // 테이블 별칭이 없어 자기 자신과의 JOIN은 속성을 구분할 수 없음
+        }
+        schema.Append(right);
+    }
+
+    std::unique_ptr<Arena> arena(new Arena());     // 질의가 메모리에 모으는 행. 결과 커서가 소멸할 때 한 번에 놓음
+    std::unique_ptr<ResultCursor> cursor;
+    std::vector<SortKey> order;
+    size_t width = 0;       // ORDER BY 때문에 붙인 속성을 정렬 뒤 뺄 때 남길 속성 수 (0이면 그대로)
+    if (st.IsAggregate()) {
+        std::unique_ptr<HashAggregateCursor> aggregate(new HashAggregateCursor(schema, st));
+        // 집계 결과는 SELECT 목록의 GROUP BY 속성으로만 정렬
+        for (const SQLOrderItem &item : st.order_by()) {
+            int i = schema.Find(item.column);
+            if (i < 0) {
+                throw AttributeNotExistException();
             }
-            
-            std::vector<char> data = page->GetData();
-            int offset = page->GetSlotOffset();
-            for (int j = HEADER_SIZE; j < offset; j += sizeof(Slot)) {
-                std::vector<TKey> tkey_value = ParseRecord(tbl, data, j);
-                
-                if (EvaluateConditions(tkey_value, tbl, st.wheres())) {
-                    tkey_values.push_back(tkey_value);
+            int position = -1;
+            for (size_t k = 0; k < st.items().size() && position < 0; k++) {
+                if (st.items()[k].aggregate == AGG_NONE && schema.Find(st.items()[k].column) == i) {
+                    position = static_cast<int>(k);
                 }
             }
+            if (position < 0) {
+                throw AttributeNotGroupedException();
+            }
+            order.push_back({position, item.desc});
+        }
+        std::unique_ptr<ResultCursor> input;
+        if (right != NULL) {
+            input.reset(new ProjectCursor(OpenJoin(tbl, right, schema, st, arena.get()), aggregate->input()));
+        } else {
+            input = OpenScan(tbl, ResolveWheres(schema, st.wheres()), aggregate->input(), false);
+        }
+        // 병렬 스캔이면 스레드마다 부분 집계를 만들어 합침
+        if (ParallelScanCursor *scan = dynamic_cast<ParallelScanCursor *>(input.get())) {
+            aggregate->Build(*scan, WorkStealingPool::Instance().slots());
+        } else {
+            aggregate->Build(*input);
+        }
+        cursor = std::move(aggregate);
+    } else {
+        Projection projection = schema.Project(st.columns());
+        for (const SQLOrderItem &item : st.order_by()) {
+            int i = schema.Find(item.column);
+            if (i < 0) {
+                throw AttributeNotExistException();
+            }
+            auto it = std::find(projection.columns.begin(), projection.columns.end(), i);
+            if (it == projection.columns.end()) {
+                // SELECT 목록에 없는 속성은 같이 읽어 정렬한 뒤 뺌
+                width = width == 0 ? projection.columns.size() : width;
+                projection.columns.push_back(i);
+                projection.schema.push_back(schema.attrs()[i]);
+                it = projection.columns.end() - 1;
+            }
+            order.push_back({static_cast<int>(it - projection.columns.begin()), item.desc});
         }
-    } while (dir->GetNext());
+        if (right != NULL) {
+            cursor = OpenJoin(tbl, right, schema, st, arena.get());
+            if (!projection.all) {
+                cursor.reset(new ProjectCursor(std::move(cursor), std::move(projection)));
+            }
+        } else {
+            bool limited = st.limit() >= 0 && order.empty();
+            cursor = OpenScan(tbl, ResolveWheres(schema, st.wheres()), std::move(projection), limited);
+        }
+    }
 
-    for (const auto &row : tkey_values) {
-        for (const auto &key : row) {
-            std::cout << key;
+    if (!order.empty()) {
+        cursor.reset(new ExternalSortCursor(std::move(cursor), std::move(order), st.limit(),
+                                            Config::Instance().work_mem(), NewSpillPrefix(cm_->path(), "sort"),
+                                            arena.get()));
+        if (width > 0) {
+            Projection visible;
+            for (size_t k = 0; k < width; k++) {
+                visible.columns.push_back(static_cast<int>(k));
+                visible.schema.push_back(cursor->Schema()[k]);
+            }
+            cursor.reset(new ProjectCursor(std::move(cursor), std::move(visible)));
         }
-        std::cout << std::endl;
     }
-    std::cout << std::endl;
+    if (st.limit() >= 0) {
+        cursor.reset(new LimitCursor(std::move(cursor), static_cast<size_t>(st.limit())));
+    }
+    return std::unique_ptr<ResultCursor>(new ArenaCursor(std::move(arena), std::move(cursor)));
 }
 
-bool ExecutionEngine::EvaluateConditions(const std::vector<TKey> &record, Table *tbl, const std::vector<SQLWhere> &wheres) {
-    for (const auto &where : wheres) {
-        bool condition_met = false;
-        int attr_index = -1;
-        
-        for (int i = 0; i < tbl->GetAttributeNum(); ++i) {
-            if (tbl->ats()[i].attr_name() == where.key) {
-                attr_index = i;
-                break;
-            }
+std::unique_ptr<ResultCursor> ExecutionEngine::OpenJoin(Table *left, Table *right, const RowSchema &schema,
+                                                        SQLSelect &st, Arena *arena) {
+    int left_key = schema.Find(st.join().left_key);
+    int right_key = schema.Find(st.join().right_key);
+    if (left_key < 0 || right_key < 0) {
+        throw AttributeNotExistException();
+    }
+    int left_width = left->GetAttributeNum();
+    if (left_key >= left_width && right_key < left_width) {
+        std::swap(left_key, right_key);     // ON b.y = a.x
+    }
+    if (left_key >= left_width || right_key < left_width ||
+        schema.attrs()[left_key].data_type() != schema.attrs()[right_key].data_type()) {
+        throw InvalidJoinException();
+    }
+    right_key -= left_width;
+
+    // 조건을 속성이 속한 테이블의 스캔으로 내려 보냄
+    std::vector<SQLWhere> left_wheres;
+    std::vector<SQLWhere> right_wheres;
+    for (const SQLWhere &where : st.wheres()) {
+        int i = schema.Find(where.key);
+        if (i < 0) {
+            throw AttributeNotExistException();
         }
-        if (attr_index == -1) continue;
-
-        const TKey &value = record[attr_index];
-        TKey where_value(tbl->ats()[attr_index].data_type(), tbl->ats()[attr_index].length());
-        where_value.ReadValue(where.value);
-
-        switch (where.sign_type) {
-            case SIGN_EQ:
-                condition_met = (value == where_value);
-                break;
-            case SIGN_NE:
-                condition_met = (value != where_value);
-                break;
-            case SIGN_LT:
-                condition_met = (value < where_value);
-                break;
-            case SIGN_LE:
-                condition_met = (value <= where_value);
-                break;
-            case SIGN_GT:
-                condition_met = (value > where_value);
-                break;
-            case SIGN_GE:
-                condition_met = (value >= where_value);
-                break;
-            default:
-                break;
-        }
-        if (!condition_met) return false;
-    }
-    return true;
-}
-
-std::vector<TKey> ExecutionEngine::ParseRecord(Table *tbl, std::vector<char> &data, int offset) {
-    std::vector<TKey> keys;
-    Slot slot;
-    std::memcpy(&slot, &data[offset], sizeof(Slot));
-    char* record = new char[slot.GetLength()];
-    std::memcpy(record, &data[slot.GetOffset()], slot.GetLength());
-    
-    int idx = 0;
-    for (int i = 0; i < tbl->GetAttributeNum(); i++) {
-        int value_type = tbl->ats()[i].data_type();
-        int length = tbl->ats()[i].length();
-        TKey tmp(value_type, length);
-        std::memcpy(tmp.key(), &record[idx], length);
-        idx += length;
-        keys.push_back(tmp);
+        std::vector<SQLWhere> &side = i < left_width ? left_wheres : right_wheres;
+        side.push_back(where);
+        side.back().key = schema.attrs()[i].attr_name();
+    }
+    Projection left_all = RowSchema(left).Project({});
+    Projection right_all = RowSchema(right).Project({});
+
+    Config &config = Config::Instance();
+    size_t left_bytes = bm_->GetFile(left->GetFile())->GetPageCount() * config.page_size();
+    size_t right_bytes = bm_->GetFile(right->GetFile())->GetPageCount() * config.page_size();
+    Index *left_idx = left->GetIndexByAttr(schema.attrs()[left_key].attr_name());
+    Index *right_idx = right->GetIndexByAttr(schema.attrs()[left_width + right_key].attr_name());
+    if ((left_idx != NULL && (right_idx != NULL || right_bytes <= config.work_mem())) ||
+        (right_idx != NULL && left_bytes <= config.work_mem())) {
+        // 인덱스가 있는 쪽은 키 순서로 읽고, 없는 쪽은 메모리에서 정렬
+        std::unique_ptr<ResultCursor> left_input;
+        std::unique_ptr<ResultCursor> right_input;
+        if (left_idx != NULL) {
+            left_input.reset(new IndexScanCursor(bm_, left, *left_idx, Predicate::Compile(left, left_wheres),
+                                                 std::move(left_all)));
+        } else {
+            left_input = SortByKey(OpenScan(left, left_wheres, std::move(left_all), false), left_key, arena);
+        }
+        if (right_idx != NULL) {
+            right_input.reset(new IndexScanCursor(bm_, right, *right_idx, Predicate::Compile(right, right_wheres),
+                                                  std::move(right_all)));
+        } else {
+            right_input = SortByKey(OpenScan(right, right_wheres, std::move(right_all), false), right_key, arena);
+        }
+        return std::unique_ptr<ResultCursor>(
+            new MergeJoinCursor(std::move(left_input), std::move(right_input), left_key, right_key, arena));
     }
 
-    delete[] record; 
-    return keys;
+    std::string spill_prefix = NewSpillPrefix(cm_->path(), "join");
+    bool build_left = left_bytes <= right_bytes;
+    return std::unique_ptr<ResultCursor>(new HashJoinCursor(
+        OpenScan(left, left_wheres, std::move(left_all), false), OpenScan(right, right_wheres, std::move(right_all), false),
+        left_key, right_key, build_left, build_left ? left_bytes : right_bytes, config.work_mem(), spill_prefix,
+        arena));
+}
+
+std::unique_ptr<ResultCursor> ExecutionEngine::OpenScan(Table *tbl, const std::vector<SQLWhere> &wheres,
+                                                        Projection projection, bool limited) {
+    Predicate predicate = Predicate::Compile(tbl, wheres);
+    // 인덱스가 있는 속성에 범위로 쓸 수 있는 조건(<> 제외)이 있으면 인덱스 스캔
+    for (const auto &where : wheres) {
+        Index *idx = tbl->GetIndexByAttr(where.key);
+        if (idx != NULL && where.sign_type != SIGN_NE) {
+            return std::unique_ptr<ResultCursor>(
+                new IndexScanCursor(bm_, tbl, *idx, std::move(predicate), std::move(projection)));
+        }
+    }
+    // 큰 테이블은 페이지 범위(morsel)로 나눠 여러 스레드에서 거름
+    WorkStealingPool &pool = WorkStealingPool::Instance();
+    if (pool.slots() > 1 && bm_->GetFile(tbl->GetFile())->GetPageCount() >= PARALLEL_SCAN_MIN_PAGES) {
+        return std::unique_ptr<ResultCursor>(
+            new ParallelScanCursor(bm_, tbl, std::move(predicate), std::move(projection), pool, limited));
+    }
+    return std::unique_ptr<ResultCursor>(new SeqScanCursor(bm_, tbl, std::move(predicate), std::move(projection)));
 }
 
 
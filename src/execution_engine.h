@@ -8,24 +8,109 @@
 #include "file.h"
 #include "exceptions.h"
 #include "buffer_manager.h"
+#include "cursor.h"
+#include "bplus_tree.h"
+#include "bulk_loader.h"
+#include "join.h"
 
 class ExecutionEngine {
 private:
     CatalogManager *cm_;
     BufferManager *bm_;
     std::string db_name_;
+    TableCache *tables_;    // nullptr이면 매번 카탈로그에서 찾음
+    bool new_pages_;        // 이 문장이 InsertRecord로 새 페이지를 등록함
 
-    std::vector<TKey> ParseRecord(Table *tbl, std::vector<char> &data, int offset);
-    
-    bool EvaluateConditions(const std::vector<TKey> &record, Table *tbl, const std::vector<SQLWhere> &wheres);
+    /**
+     * @brief 현재 데이터베이스의 테이블을 찾음 (세션 캐시가 있으면 캐시에서)
+     *
+     * @throw TableNotExistException 없는 테이블
+     */
+    Table *GetTable(const std::string &tb_name);
+
+    /**
+     * @brief 한 행의 값을 테이블 스키마에 맞춰 레코드 바이트로 변환
+     * @param arena 값을 바꿀 때 쓰는 임시 메모리. 호출할 때마다 비움
+     *
+     * @throw SyntaxErrorException 값 개수와 속성 개수가 다름
+     */
+    void EncodeRow(Table *tbl, const std::vector<SQLValue> &values, std::vector<char> &content, Arena &arena);
+
+    /**
+     * @brief 레코드 하나를 free space map이 찾은 페이지(없으면 새 페이지)에 넣고 인덱스 갱신
+     *
+     * @throw RowTooLargeException 빈 페이지에도 들어가지 않는 레코드 (새 페이지를 잡지 않음)
+     */
+    void InsertRecord(Table *tbl, const char *content, int content_len);
+
+    /**
+     * @brief InsertRecord가 새 페이지를 등록했고 로그를 쓰면 테이블 파일(디렉토리 포함)을 디스크에 내림
+     */
+    void SyncNewPages(Table *tbl);
+
+    /**
+     * @brief 인덱스 파일을 새로 만들고 테이블의 모든 레코드를 넣음
+     */
+    void BuildIndex(Table *tbl, const Index &idx);
+
+    /**
+     * @brief WHERE를 만족하는 행의 projection 속성을 꺼내는 스캔 커서 (인덱스, 병렬, 순차 스캔 중 고름)
+     *
+     * @param wheres tbl의 속성 이름(테이블 이름 없이)으로 쓴 조건
+     * @param limited LIMIT가 있음 (병렬 스캔이 작은 묶음부터 읽음)
+     */
+    std::unique_ptr<ResultCursor> OpenScan(Table *tbl, const std::vector<SQLWhere> &wheres, Projection projection,
+                                           bool limited);
+
+    /**
+     * @brief 두 테이블의 equi-join 커서. 결과 행은 schema 순서(왼쪽 속성 뒤에 오른쪽 속성)
+     * @details WHERE 조건은 각 테이블의 스캔으로 내려 보낸다. ON의 한쪽 속성에 인덱스가 있고 다른 쪽도 인덱스가 있거나
+     *          work_mem 안에 들어가면 인덱스 순서로 읽어 sort-merge join하고, 아니면 작은 테이블로 hash join한다.
+     *          메모리에 모으는 행은 arena에 담는다.
+     *
+     * @throw InvalidJoinException 같은 테이블끼리, 또는 ON이 한 테이블의 속성끼리이거나 타입이 다름
+     */
+    std::unique_ptr<ResultCursor> OpenJoin(Table *left, Table *right, const RowSchema &schema, SQLSelect &st,
+                                           Arena *arena);
 
 public:
-    ExecutionEngine(CatalogManager *cm, std::string db, BufferManager *bm)
-        : cm_(cm), db_name_(db), bm_(bm) {}
+    ExecutionEngine(CatalogManager *cm, std::string db, BufferManager *bm, TableCache *tables = nullptr)
+        : cm_(cm), bm_(bm), db_name_(db), tables_(tables), new_pages_(false) {}
     ~ExecutionEngine() {}
 
+    /**
+     * @brief INSERT 실행. 빈 페이지를 채울 만큼 행이 많으면 BulkLoader로 새 페이지에 적재
+     * @details 로그를 쓸 때 새 페이지를 등록했으면 끝나기 전에 테이블 파일을 fdatasync한다. 페이지 등록(디렉토리
+     *          entry)은 로그에 남지 않으므로, commit한 행의 로그가 가리키는 페이지가 복구 때 있어야 하기 때문이다.
+     */
     void Insert(SQLInsert &st);
+
+    /**
+     * @brief INSERT의 모든 행이 테이블 속성 개수만큼 값을 가졌는지 확인 (아무것도 쓰지 않음)
+     *
+     * @throw TableNotExistException 없는 테이블
+     * @throw SyntaxErrorException 값 개수가 속성 개수와 다른 행이 있음
+     */
+    void CheckInsert(SQLInsert &st);
+
+    /**
+     * @brief 인덱스 파일을 만들고 테이블의 기존 레코드로 B+Tree를 채운 뒤 catalog에 등록
+     */
+    void CreateIndex(SQLCreateIndex &st);
+    void DropIndex(SQLDropIndex &st);
+
+    /**
+     * @brief 테이블의 모든 인덱스를 테이블 레코드로 다시 만듦 (로그 복구 뒤)
+     */
+    void RebuildIndexes(Table *tbl);
     void Select(SQLSelect &st);
+
+    /**
+     * @brief SELECT 결과를 한 행씩 꺼내는 커서를 엶. 출력하지 않는 호출자용
+     *
+     * @return std::unique_ptr<ResultCursor> 커서가 살아있는 동안 현재 페이지가 고정됨
+     */
+    std::unique_ptr<ResultCursor> OpenSelect(SQLSelect &st);
 };
 
 #endif
\ No newline at end of file
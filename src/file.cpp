@@ -1,5 +1,13 @@
 #include "file.h"
+#include <cerrno>
+#include <fcntl.h>
 #include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "exceptions.h"
+#include "metrics.h"
 /*=======================================PageDirectory================================================ */
 
 bool PageDirectory::HasPage() {
@@ -22,7 +30,7 @@ size_t PageDirectory::GetOffset() const {
     return directory_offset_;
 }
 
-std::array<PageDirectoryEntry, MAX_ENTRIES_PER_DIR>& PageDirectory::GetEntries() {
+std::vector<PageDirectoryEntry>& PageDirectory::GetEntries() {
     return entries_;
 }
 
@@ -34,115 +42,347 @@ void PageDirectory::SetNext(size_t next) {
     next_ = next;
 }
 
+void PageDirectory::Encode(std::vector<char>& block) const {
+    block.assign(Config::Instance().page_size(), 0);
+    DirectoryHeader header;
+    header.magic = DIRECTORY_MAGIC;
+    header.version = FILE_FORMAT_VERSION;
+    header.page_size = static_cast<uint32_t>(Config::Instance().page_size());
+    header.index = index_;
+    header.size = size_;
+    header.reserved = 0;
+    header.offset = directory_offset_;
+    header.next = next_;
+    std::memcpy(block.data(), &header, sizeof(DirectoryHeader));
+
+    char* pos = block.data() + DIRECTORY_HEADER_SIZE;
+    for (int i = 0; i < size_; i++) {
+        uint64_t offset = entries_[i].offset;
+        std::memcpy(pos, &offset, sizeof(uint64_t));
+        std::memcpy(pos + sizeof(uint64_t), &entries_[i].free_space, sizeof(uint32_t));
+        std::memcpy(pos + sizeof(uint64_t) + sizeof(uint32_t), &entries_[i].zone, sizeof(ZoneBounds));
+        pos += DIRECTORY_ENTRY_SIZE;
+    }
+}
+
+bool PageDirectory::Decode(const std::vector<char>& block) {
+    DirectoryHeader header;
+    std::memcpy(&header, block.data(), sizeof(DirectoryHeader));
+    if (header.magic != DIRECTORY_MAGIC || header.size < 0 || static_cast<size_t>(header.size) > MaxEntries()) {
+        return false;
+    }
+    directory_offset_ = header.offset;
+    next_ = header.next;
+    index_ = header.index;
+    size_ = header.size;
+    entries_.assign(MaxEntries(), PageDirectoryEntry());
+
+    const char* pos = block.data() + DIRECTORY_HEADER_SIZE;
+    for (int i = 0; i < size_; i++) {
+        uint64_t offset;
+        std::memcpy(&offset, pos, sizeof(uint64_t));
+        std::memcpy(&entries_[i].free_space, pos + sizeof(uint64_t), sizeof(uint32_t));
+        std::memcpy(&entries_[i].zone, pos + sizeof(uint64_t) + sizeof(uint32_t), sizeof(ZoneBounds));
+        if (entries_[i].zone.count < 0 || entries_[i].zone.count > ZONE_MAP_COLUMNS) {
+            entries_[i].zone = ZoneBounds();
+        }
+        entries_[i].offset = offset;
+        pos += DIRECTORY_ENTRY_SIZE;
+    }
+    return true;
+}
+
 /*=======================================File================================================ */
-File::File(const std::string& filename) {
-    file_.open(filename, std::ios::in | std::ios::out | std::ios::binary);
-    if (!file_.is_open()) {
-        file_.open(filename, std::ios::out | std::ios::binary);
-        file_.close();
-        file_.open(filename, std::ios::in | std::ios::out | std::ios::binary);
+File::File(const std::string& filename, bool mapped) : fd_(-1), filename_(filename), page_size_(Config::Instance().page_size()), file_size_(0), fsm_(page_size_), map_(nullptr), map_size_(0) {
+    fd_ = mapped ? open(filename.c_str(), O_RDONLY) : open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("테이블 파일을 열 수 없습니다: " + filename);
+    }
+    struct stat st;
+    if (fstat(fd_, &st) == 0) {
+        file_size_ = static_cast<size_t>(st.st_size);
+    }
+
+    std::vector<char> block(page_size_);
+    if (file_size_ == 0) {  // 새 파일
+        if (mapped) {
+            close(fd_);
+            fd_ = -1;
+            throw InvalidFileFormatException();
+        }
+        dirs_.push_back(std::make_shared<PageDirectory>(AllocateBlock(), 0));
+        dirs_dirty_.push_back(false);
+        WritePageDirToFile(*dirs_.back());
+        return;
+    }
+    if (!ReadBlock(0, block.data())) {  // 페이지 하나보다 짧은 파일 (더 작은 page_size로 만든 파일 등)
+        close(fd_);
+        fd_ = -1;
+        throw InvalidFileFormatException();
+    }
+    DirectoryHeader header;
+    std::memcpy(&header, block.data(), sizeof(DirectoryHeader));
+    if (header.magic != DIRECTORY_MAGIC || header.version != FILE_FORMAT_VERSION || header.page_size != page_size_) {
+        close(fd_);
+        fd_ = -1;
+        throw InvalidFileFormatException();
+    }
+
+    // PageDirectory 체인을 한 번만 읽어 캐시
+    size_t offset = 0;
+    do {
+        std::shared_ptr<PageDirectory> dir = LoadPageDirFromFile(offset);
+        if (dir == nullptr) {
+            break;
+        }
+        dirs_.push_back(dir);
+        dirs_dirty_.push_back(false);
+        offset = dir->GetNext();
+    } while (offset != 0);
+
+    // 디렉토리 entry에 저장된 남은 공간으로 free space map 구성
+    for (const std::shared_ptr<PageDirectory>& d : dirs_) {
+        std::vector<PageDirectoryEntry>& entries = d->GetEntries();
+        for (int i = 0; i < d->GetSize(); i++) {
+            fsm_.Update(PageNo(d->GetIdx(), i), entries[i].free_space);
+        }
     }
-    if(GetPageDir(0) == nullptr){
-        PageDirectory directory(0,0);
-        WritePageDirToFile(directory);
+
+    if (mapped) {
+        void* addr = mmap(nullptr, file_size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) {
+            close(fd_);
+            fd_ = -1;
+            throw std::runtime_error("테이블 파일을 mmap할 수 없습니다: " + filename);
+        }
+        map_ = static_cast<char*>(addr);
+        map_size_ = file_size_;
     }
 }
 
-std::shared_ptr<Page> File::LoadPageFromFile(size_t offset) {
-    file_.seekg(offset);
-    std::shared_ptr<Page> page = std::make_shared<Page>();
-    boost::archive::binary_iarchive iar(file_);
-    iar >> *page;
-    return page;
+bool File::ReadBlock(size_t offset, char* buf) {
+    LatencyTimer timer(Metrics::PAGE_READ_TIME);
+    size_t done = 0;
+    while (done < page_size_) {
+        ssize_t n = pread(fd_, buf + done, page_size_ - done, offset + done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    Metrics::Instance().Add(Metrics::PAGES_READ);
+    return true;
+}
+
+void File::WriteBlock(size_t offset, const char* buf) {
+    size_t done = 0;
+    while (done < page_size_) {
+        ssize_t n = pwrite(fd_, buf + done, page_size_ - done, offset + done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw std::runtime_error("페이지를 쓸 수 없습니다: " + filename_);
+        }
+        done += static_cast<size_t>(n);
+    }
+    Metrics::Instance().Add(Metrics::PAGES_WRITTEN);
+}
+
+size_t File::AllocateBlock() {
+    size_t offset = (file_size_ + page_size_ - 1) / page_size_ * page_size_;
+    file_size_ = offset + page_size_;
+    return offset;
+}
+
+void File::LoadPageFromFile(size_t offset, Page& page) {
+    if (!ReadBlock(offset, page.GetRawData()) || !page.ReadHeader()) {
+        throw std::runtime_error("페이지를 읽을 수 없습니다: " + filename_);
+    }
+    page.SetFilename(filename_);
 }
 
 std::shared_ptr<PageDirectory> File::LoadPageDirFromFile(size_t offset) {
-    file_.seekg(offset);
+    std::vector<char> block(page_size_);
+    if (!ReadBlock(offset, block.data())) {
+        return nullptr;
+    }
     std::shared_ptr<PageDirectory> dir = std::make_shared<PageDirectory>(offset);
-    try {
-        boost::archive::binary_iarchive iar(file_);
-        iar >> *dir;
-    } catch (const boost::archive::archive_exception& e) {
-        // std::cerr << "Error: Failed to deserialize PageDirectory. " << e.what() << std::endl;
+    if (!dir->Decode(block)) {
         return nullptr;
     }
     return dir;
 }
 
 void File::WritePageDirToFile(const PageDirectory& dir) {
-    file_.seekp(dir.GetOffset(), std::ios::beg); // 자신의 위치에 덮어쓴다.
-    boost::archive::binary_oarchive oar(file_);
-    oar << dir;
+    std::vector<char> block;
+    dir.Encode(block);
+    WriteBlock(dir.GetOffset(), block.data()); // 자신의 위치에 덮어쓴다.
 }
 
 size_t File::WritePageToFile(PageDirectory& dir, const Page& page) {
-    if (page.GetPageIdx() == -1) {  // 직렬화 안된 Page인 경우
-        file_.seekp(0, std::ios::end);  // File 제일 뒤를 point
+    size_t offset;
+    if (page.GetPageIdx() == -1) {  // 디렉토리에 아직 등록되지 않은 Page인 경우
+        offset = AllocateBlock();   // File 제일 뒤 블록
     } else {
-        std::array<PageDirectoryEntry, MAX_ENTRIES_PER_DIR>& entries = dir.GetEntries();
-        file_.seekp(entries[page.GetPageIdx()].offset, std::ios::beg);  // Page의 위치를 point
+        std::vector<PageDirectoryEntry>& entries = dir.GetEntries();
+        offset = entries[page.GetPageIdx()].offset;  // Page의 위치
     }
-    //std::cout<<"[WritePageToFile] page index : "<<page.GetPageIdx()<<std::endl;
-    size_t offset = file_.tellp();
-    boost::archive::binary_oarchive oar(file_);
-    oar << page;
+    WriteBlock(offset, page.GetRawData());
     return offset;
 }
 
-std::shared_ptr<PageDirectory> File::AddPageToDirectory(PageDirectory& dir, Page& page) {
-    size_t page_offset = WritePageToFile(dir, page);
-    if (dir.GetSize() >= MAX_ENTRIES_PER_DIR) { // PageDirectory가 가득찬경우
-        file_.seekp(0, std::ios::end);  // File의 제일 뒤를 point
-        size_t offset = file_.tellp();
-        PageDirectory new_dir(offset,dir.GetIdx()+1);  // 새로운 PageDirectory create
-        WritePageDirToFile(new_dir);
-        dir.SetNext(offset);    // 새로운 PageDirectory를 next로 기록
-        WritePageDirToFile(dir);  // 현재 PageDirectory Write
+std::shared_ptr<PageDirectory> File::DirectoryWithRoom() {
+    std::shared_ptr<PageDirectory> dir = dirs_.back();
+    if (static_cast<size_t>(dir->GetSize()) >= PageDirectory::MaxEntries()) { // PageDirectory가 가득찬경우
+        size_t offset = AllocateBlock();  // File의 제일 뒤 블록
+        std::shared_ptr<PageDirectory> new_dir = std::make_shared<PageDirectory>(offset, dir->GetIdx() + 1);  // 새로운 PageDirectory create
+        WritePageDirToFile(*new_dir);
+        dir->SetNext(offset);    // 새로운 PageDirectory를 next로 기록
+        WritePageDirToFile(*dir);  // 현재 PageDirectory Write
+        dirs_dirty_[dir->GetIdx()] = false;
+        dirs_.push_back(new_dir);
+        dirs_dirty_.push_back(false);
         dir = new_dir;
     }
+    return dir;
+}
+
+void File::RegisterPage(PageDirectory& dir, Page& page, size_t offset) {
+    page.SetDirIdx(dir.GetIdx());
     page.SetPageIdx(dir.GetSize()); // Page는 entries에서의 본인 index저장
-    std::array<PageDirectoryEntry, MAX_ENTRIES_PER_DIR>& entries = dir.GetEntries();
-    entries[dir.GetSize()] = {page_offset, false};  // 새로운 Page 관리
+    std::vector<PageDirectoryEntry>& entries = dir.GetEntries();
+    entries[dir.GetSize()] = {offset, false, static_cast<uint32_t>(page.GetFreeSpace()), page.GetZone()};  // 새로운 Page 관리
+    fsm_.Update(PageNo(dir.GetIdx(), dir.GetSize()), page.GetFreeSpace());
     dir.IncrementSize();
-    return std::make_shared<PageDirectory>(dir);
+}
+
+std::shared_ptr<PageDirectory> File::AddPageToDirectory(Page& page) {
+    std::shared_ptr<PageDirectory> dir = DirectoryWithRoom();
+    size_t page_offset = AllocateBlock();  // File 제일 뒤 블록
+    RegisterPage(*dir, page, page_offset);  // 헤더에 위치를 기록한 뒤 씀
+    WriteBlock(page_offset, page.GetRawData());
+    WritePageDirToFile(*dir);
+    dirs_dirty_[dir->GetIdx()] = false;
+    return dir;
+}
+
+void File::AppendPages(const std::vector<std::shared_ptr<Page>>& pages) {
+    for (const std::shared_ptr<Page>& page : pages) {
+        std::shared_ptr<PageDirectory> dir = DirectoryWithRoom();
+        size_t offset = AllocateBlock();
+        RegisterPage(*dir, *page, offset);  // 헤더에 위치를 기록한 뒤 씀
+        WriteBlock(offset, page->GetRawData());
+        dirs_dirty_[dir->GetIdx()] = true;
+    }
+    SyncPageDirs();  // 바뀐 디렉토리는 batch 끝에 한 번씩만 씀
 }
 
 std::shared_ptr<Page> File::GetPage(PageDirectory& dir, int page_index) {
-    std::array<PageDirectoryEntry, MAX_ENTRIES_PER_DIR>& entries = dir.GetEntries();
+    std::shared_ptr<Page> page = std::make_shared<Page>(filename_, 0);
+    ReadPage(dir, page_index, *page);
+    return page;
+}
+
+void File::ReadPage(PageDirectory& dir, int page_index, Page& page) {
     if (page_index >= dir.GetSize()) {
         throw std::out_of_range("잘못된 페이지 인덱스입니다.");
     }
-    //std::cout<<"[GetPage] page index : "<<page_index<<"\tdir size : "<<dir.GetSize()<<std::endl;
-    PageDirectoryEntry& entry = entries[page_index];
-    
-    std::shared_ptr<Page> page = LoadPageFromFile(entry.offset);
-    entry.is_loaded = true;
-    return page;
+    LoadPageFromFile(dir.GetEntries()[page_index].offset, page);
+}
+
+void File::ViewPage(PageDirectory& dir, int page_index, Page& page) const {
+    if (page_index >= dir.GetSize()) {
+        throw std::out_of_range("잘못된 페이지 인덱스입니다.");
+    }
+    size_t offset = dir.GetEntries()[page_index].offset;
+    if (map_ == nullptr || offset + page_size_ > map_size_ || !page.AttachImage(map_ + offset)) {
+        throw std::runtime_error("페이지를 읽을 수 없습니다: " + filename_);
+    }
+    Metrics::Instance().Add(Metrics::PAGES_READ);
+}
+
+void File::AdviseSequential() {
+    if (map_ != nullptr) {
+        madvise(map_, map_size_, MADV_SEQUENTIAL);
+    }
+}
+
+bool File::FindPageWithSpace(int length, bool pax, int* dir_idx, int* page_idx) {
+    uint64_t page_no;
+    if (!fsm_.Find(pax ? length : length + sizeof(Slot), &page_no)) {
+        return false;
+    }
+    *dir_idx = static_cast<int>(page_no / PageDirectory::MaxEntries());
+    *page_idx = static_cast<int>(page_no % PageDirectory::MaxEntries());
+    return true;
 }
 
-std::shared_ptr<Page> File::GetEnoughSpacePage(int length){
-    std::shared_ptr<PageDirectory> dir = GetPageDir(0);
-    do{
-        for(int i=0;i<dir->GetSize();i++){
-            std::shared_ptr<Page> page = GetPage(*dir,i);
-            //std::cout<<"[GetEnoughSpacePage] page index : "<<page->GetPageIdx()<<"\tpage free : "<<page->GetFreeSpace()<<std::endl;
-            if(page->GetFreeSpace() > length){
+void File::UpdateEntry(const Page& page) {
+    std::shared_ptr<PageDirectory> dir = GetPageDirByIdx(page.GetDirIdx());
+    if (dir == nullptr || page.GetPageIdx() < 0 || page.GetPageIdx() >= dir->GetSize()) {
+        return;
+    }
+    PageDirectoryEntry& entry = dir->GetEntries()[page.GetPageIdx()];
+    uint32_t free_space = static_cast<uint32_t>(page.GetFreeSpace());
+    if (entry.free_space == free_space && std::memcmp(&entry.zone, &page.GetZone(), sizeof(ZoneBounds)) == 0) {
+        return;
+    }
+    entry.free_space = free_space;
+    entry.zone = page.GetZone();
+    fsm_.Update(PageNo(page.GetDirIdx(), page.GetPageIdx()), free_space);
+    dirs_dirty_[dir->GetIdx()] = true;
+}
 
-                return page;
-            }
+void File::SyncPageDirs() {
+    for (size_t i = 0; i < dirs_.size(); i++) {
+        if (dirs_dirty_[i]) {
+            WritePageDirToFile(*dirs_[i]);
+            dirs_dirty_[i] = false;
         }
-        size_t offset = dir->GetNext();
-        dir = GetPageDir(offset);
-    }while(dir->GetNext());
-    return nullptr;
+    }
+}
+
+void File::Sync() {
+    SyncPageDirs();
+    if (fdatasync(fd_) != 0) {
+        throw std::runtime_error("파일을 디스크에 내릴 수 없습니다: " + filename_);
+    }
 }
 
 std::shared_ptr<PageDirectory> File::GetPageDir(size_t offset) {
-    return LoadPageDirFromFile(offset);
+    for (const std::shared_ptr<PageDirectory>& dir : dirs_) {
+        if (dir->GetOffset() == offset) {
+            return dir;
+        }
+    }
+    return nullptr;
+}
+
+int File::GetPageCount() const {
+    int count = 0;
+    for (const std::shared_ptr<PageDirectory>& dir : dirs_) {
+        count += dir->GetSize();
+    }
+    return count;
+}
+
+std::shared_ptr<PageDirectory> File::GetPageDirByIdx(int index) {
+    if (index < 0 || index >= static_cast<int>(dirs_.size())) {
+        return nullptr;
+    }
+    return dirs_[index];
 }
 
 File::~File() {
-    if (file_.is_open()) {
-        file_.close();
+    if (map_ != nullptr) {
+        munmap(map_, map_size_);
+    }
+    if (fd_ >= 0) {
+        SyncPageDirs();
+        close(fd_);
     }
 }
@@ -1,17 +1,33 @@
 #ifndef ABCDB_FILE_H_
 #define ABCDB_FILE_H_
 
+#include <cstdint>
 #include <cstring> 
-#include <fstream> 
-#include <array>
-#include <boost/archive/binary_iarchive.hpp>
-#include <boost/archive/binary_oarchive.hpp>
-#include <boost/serialization/utility.hpp>
-#include <boost/serialization/array.hpp>
+#include <vector>
 #include "page.h"
+#include "free_space_map.h"
 
-#define DIRECTORY_BODY_SIZE (PAGE_SIZE - sizeof(size_t) * 2 - sizeof(int))  // 페이지 디렉토리의 헤더를 제외한 사이즈
-#define MAX_ENTRIES_PER_DIR (DIRECTORY_BODY_SIZE / sizeof(PageDirectoryEntry))  // 최대 페이지 entry 저장 개수
+#define DIRECTORY_MAGIC 0x44434241  // "ABCD"
+#define FILE_FORMAT_VERSION 3
+#define DIRECTORY_ENTRY_SIZE (sizeof(uint64_t) + sizeof(uint32_t) + sizeof(ZoneBounds))  // 디스크에 기록되는 entry 하나의 크기 (offset, free_space, zone)
+
+/**
+ * @brief 디스크에 기록되는 페이지 디렉토리 헤더
+ * @details 파일은 page_size 크기의 블록 단위로 구성되며 0번 블록은 항상 0번 PageDirectory이다.
+ *          0번 디렉토리의 page_size로 파일을 만들 때 사용한 페이지 크기를 검사한다.
+ */
+struct DirectoryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t page_size;
+    int32_t index;      // 페이지 디렉토리 index
+    int32_t size;       // 현재 entries 사이즈
+    uint32_t reserved;
+    uint64_t offset;    // 페이지 디렉토리 offset
+    uint64_t next;      // 다음 페이지 디렉토리 offset
+};
+
+#define DIRECTORY_HEADER_SIZE sizeof(DirectoryHeader)  // 페이지 디렉토리의 헤더 사이즈
 
 /**
  * @brief 페이지 디렉토리 entries에 들어가는 페이지를 참조하기위한 정보
@@ -19,12 +35,9 @@
  */
 struct PageDirectoryEntry{
     size_t offset;  // 파일 내 페이지의 오프셋
-    bool is_loaded = false; // 페이지가 메모리에 로드되어 있는지 여부
-    template<class Archive>
-    void serialize(Archive & ar, const unsigned int version){
-        ar & offset;
-        ar & is_loaded;
-    }
+    bool is_loaded = false; // 페이지가 메모리에 로드되어 있는지 여부 (디스크에는 기록되지 않음)
+    uint32_t free_space = 0;    // 페이지의 남은 공간 (free space map의 원본)
+    ZoneBounds zone = ZoneBounds();     // 페이지 헤더 zone map의 사본. 스캔이 페이지를 읽지 않고 거르는 데 씀
 };
 
 /**
@@ -37,20 +50,35 @@ private:
     size_t next_;   // 다음 페이지 디렉토리 offset
     int index_;  // 페이지 디렉토리 index
     int size_;  // 현재 entries 사이즈
-    std::array<PageDirectoryEntry, MAX_ENTRIES_PER_DIR> entries_;   // page offset을 저장하는 array
+    std::vector<PageDirectoryEntry> entries_;   // page offset을 저장하는 array (MaxEntries()개)
 
 public:
-    PageDirectory(const size_t offset, const int index): directory_offset_(offset), next_(0),index_(index), size_(0) {};
-    PageDirectory(const size_t offset){};
-    template<class Archive>
-     void serialize(Archive& ar, const unsigned int version) {
-        ar & directory_offset_;
-        ar & next_;
-        ar & index_;
-        ar & size_;
-        ar & boost::serialization::make_array(entries_.data(), entries_.size());
+    PageDirectory(const size_t offset, const int index): directory_offset_(offset), next_(0),index_(index), size_(0), entries_(MaxEntries()) {};
+    PageDirectory(const size_t offset): directory_offset_(offset), next_(0), index_(0), size_(0), entries_(MaxEntries()) {};
+
+    /**
+     * @brief 디렉토리 하나가 관리할 수 있는 최대 페이지 entry 개수. 설정된 페이지 크기에서 계산됨
+     */
+    static size_t MaxEntries() {
+        return (Config::Instance().page_size() - DIRECTORY_HEADER_SIZE) / DIRECTORY_ENTRY_SIZE;
     }
 
+    /**
+     * @brief 디렉토리를 page_size 크기의 디스크 블록으로 기록
+     * 
+     * @param block page_size 크기의 버퍼
+     */
+    void Encode(std::vector<char>& block) const;
+
+    /**
+     * @brief 디스크 블록에서 디렉토리 복원
+     * 
+     * @param block page_size 크기의 버퍼
+     * @return true 성공
+     * @return false 디렉토리 블록이 아님
+     */
+    bool Decode(const std::vector<char>& block);
+
     /**
      * @brief 페이지 디렉토리가 페이지를 하나라도 가지고 있는지 여부
      * 
@@ -88,9 +116,9 @@ public:
     /**
      * @brief Get the Entries object
      * 
-     * @return std::array<PageDirectoryEntry, MAX_ENTRIES_PER_DIR>& 
+     * @return std::vector<PageDirectoryEntry>& 
      */
-    std::array<PageDirectoryEntry, MAX_ENTRIES_PER_DIR>& GetEntries();
+    std::vector<PageDirectoryEntry>& GetEntries();
     
     /**
      * @brief Get the Next object
@@ -109,19 +137,62 @@ public:
 
 /**
  * @brief PageDirectory 및 Page를 관리
+ * @details 파일 디스크립터는 File이 사라질 때까지 열려 있고, PageDirectory 체인은 열 때 한 번 읽어
+ *          메모리(dirs_)에 둔다. GetPageDir 계열 함수가 돌려주는 디렉토리는 이 캐시 자체이다.
+ *          페이지 읽기와 WritePageToFile은 pread/pwrite뿐이라 여러 세션이 동시에 불러도 되고, 디렉토리와
+ *          free space map을 바꾸는 함수는 BufferManager::statement_latch()를 exclusive로 잡은 문장만 부른다.
+ *
+ *          mapped로 열면 파일을 읽기 전용으로 열어 전체를 mmap하고, 스캔은 ViewPage로 블록을 복사 없이 읽는다.
+ *          이때는 페이지나 디렉토리를 쓰는 함수를 부르면 안 되며, 다른 프로세스가 파일을 줄이면 안 된다.
  * 
  */
 class File {
 private:
-    std::fstream file_;
+    int fd_;
+    std::string filename_;
+    size_t page_size_;
+    size_t file_size_;  // 할당된 블록까지의 파일 크기
+    std::vector<std::shared_ptr<PageDirectory>> dirs_;  // index 순서의 PageDirectory 체인
+    std::vector<bool> dirs_dirty_;                      // entry의 free_space만 바뀌어 아직 쓰지 않은 디렉토리
+    FreeSpaceMap fsm_;
+    char* map_;         // mapped로 열었을 때 파일 전체를 mmap한 주소 (아니면 nullptr)
+    size_t map_size_;
+
+    /**
+     * @brief (dir idx, page idx)를 free space map의 페이지 전역 번호로 변환
+     */
+    static uint64_t PageNo(int dir_idx, int page_idx) {
+        return static_cast<uint64_t>(dir_idx) * PageDirectory::MaxEntries() + page_idx;
+    }
+
+    /**
+     * @brief offset 위치의 page_size 크기 블록을 한 번의 pread로 읽음
+     * 
+     * @return true 성공
+     * @return false 파일 끝이거나 읽기 실패
+     */
+    bool ReadBlock(size_t offset, char* buf);
 
     /**
-     * @brief 파일에서 페이지 읽어옴
+     * @brief offset 위치에 page_size 크기 블록을 한 번의 pwrite로 씀
+     */
+    void WriteBlock(size_t offset, const char* buf);
+
+    /**
+     * @brief 파일 끝에 새 블록 자리를 잡음
+     * 
+     * @return size_t 새 블록의 offset
+     */
+    size_t AllocateBlock();
+
+    /**
+     * @brief 파일에서 페이지를 page의 이미지로 읽어옴
      * 
      * @param offset 읽어올 Page의 offset
-     * @return std::shared_ptr<Page>  Page의 스마트 포인터(참조 카운팅을 통해 마지막 참조가 해제되면 자동으로 객체 삭제)
+     * @param page 내용을 덮어쓸 Page (헤더와 파일 이름도 다시 설정됨)
+     * @throw std::runtime_error 블록을 읽을 수 없거나 페이지 헤더가 올바르지 않음
      */
-    std::shared_ptr<Page> LoadPageFromFile(size_t offset);
+    void LoadPageFromFile(size_t offset, Page& page);
     /**
      * @brief 파일에서 페이지 디렉토리 읽어옴
      * 
@@ -130,8 +201,23 @@ private:
      */
     std::shared_ptr<PageDirectory> LoadPageDirFromFile(size_t offset);
 
+    /**
+     * @brief 빈 entry가 남은 마지막 PageDirectory. 가득 찼으면 새 디렉토리를 만들어 체인에 연결
+     */
+    std::shared_ptr<PageDirectory> DirectoryWithRoom();
+    /**
+     * @brief offset 위치의 page를 dir의 다음 entry로 등록하고 free space map에 반영 (디렉토리는 쓰지 않음)
+     */
+    void RegisterPage(PageDirectory& dir, Page& page, size_t offset);
+
 public:
-    File(const std::string& filename);
+    /**
+     * @brief 파일을 열고 0번 PageDirectory를 검사. 빈 파일이면 0번 PageDirectory를 만든다
+     * 
+     * @param mapped 읽기 전용으로 열어 파일 전체를 mmap함 (read_only 설정)
+     * @throw InvalidFileFormatException 테이블 파일이 아니거나 페이지 크기가 설정과 다름 (페이지 하나보다 짧은 파일, mapped면 빈 파일도)
+     */
+    File(const std::string& filename, bool mapped = false);
 
     /**
      * @brief 페이지 디렉토리 파일에 쓰기
@@ -150,20 +236,49 @@ public:
     size_t WritePageToFile(PageDirectory& dir, const Page& page);
 
     /**
-     * @brief 페이지 페이지 디렉토리에 추가
+     * @brief 페이지를 마지막 페이지 디렉토리에 추가. 디렉토리가 가득 찼으면 새 디렉토리를 체인에 연결
      * 
-     * @param dir Page를 관리할 PageDirectory
      * @param page PageDirectory에 새롭게 추가할 Page
+     * @return std::shared_ptr<PageDirectory> Page가 추가된 PageDirectory
+     */
+    std::shared_ptr<PageDirectory> AddPageToDirectory(Page& page);
+
+    /**
+     * @brief 메모리에서 채운 새 페이지들을 파일 끝에 차례로 쓰고 디렉토리에 등록 (bulk load)
+     * @details 페이지는 버퍼 풀을 거치지 않으며, 바뀐 디렉토리는 마지막에 한 번씩만 쓴다.
+     *
+     * @param pages 등록되지 않은(page idx -1) 페이지. 호출 뒤 각 페이지의 dir idx/page idx가 정해짐
      */
-    std::shared_ptr<PageDirectory> AddPageToDirectory(PageDirectory& dir, Page& page);
+    void AppendPages(const std::vector<std::shared_ptr<Page>>& pages);
 
     /**
-     * @brief 주어진 length만큼의 빈공간을 가지는 페이지 리턴
+     * @brief free space map에서 length 길이의 레코드를 넣을 수 있는 페이지를 찾음. 페이지는 읽지 않음
      * 
      * @param length 저장할 레코드 길이
-     * @return std::shared_ptr<Page> 페이지포인터
+     * @param pax 파일의 페이지가 PAX 형식인지. PAX 행은 slot 없이 length만 차지함 (Page::SetFreeSpace)
+     * @param dir_idx 찾은 페이지의 디렉토리 index
+     * @param page_idx 찾은 페이지의 index
+     * @return true 찾음
+     * @return false 여유 공간이 있는 페이지 없음
      */
-    std::shared_ptr<Page> GetEnoughSpacePage(int length);
+    bool FindPageWithSpace(int length, bool pax, int* dir_idx, int* page_idx);
+
+    /**
+     * @brief 페이지의 현재 남은 공간과 zone map을 디렉토리 entry와 free space map에 반영
+     * 
+     * @param page 디렉토리에 등록된 Page
+     */
+    void UpdateEntry(const Page& page);
+
+    /**
+     * @brief free space만 바뀐 디렉토리들을 디스크에 씀
+     */
+    void SyncPageDirs();
+
+    /**
+     * @brief 디렉토리를 쓰고 파일 내용을 디스크까지 내림 (fdatasync)
+     */
+    void Sync();
 
     /**
      * @brief Get the Page object
@@ -174,14 +289,55 @@ public:
      */
     std::shared_ptr<Page> GetPage(PageDirectory& dir, int page_index);
 
+    /**
+     * @brief GetPage처럼 읽되 새 Page를 만들지 않고 page의 이미지에 덮어씀 (ScanRing 프레임 재사용)
+     */
+    void ReadPage(PageDirectory& dir, int page_index, Page& page);
+
+    /**
+     * @brief mmap한 파일의 페이지 블록을 복사하지 않고 page가 가리키게 함 (Page::AttachImage)
+     * @details page는 파일이 열려 있는 동안 읽기만 할 수 있다. 버퍼 풀을 거치지 않으므로 고정할 필요가 없다.
+     */
+    void ViewPage(PageDirectory& dir, int page_index, Page& page) const;
+
+    /**
+     * @brief mapped로 열어 ViewPage를 쓸 수 있는지
+     */
+    bool IsMapped() const {return map_ != nullptr;}
+
+    /**
+     * @brief 파일을 앞에서부터 차례로 읽는다고 커널에 알림 (madvise MADV_SEQUENTIAL). mmap하지 않았으면 아무것도 안 함
+     */
+    void AdviseSequential();
+
     /**
      * @brief Get the Page Dir object
      * 
      * @param offset 
-     * @return std::shared_ptr<PageDirectory> 
+     * @return std::shared_ptr<PageDirectory> 없으면 nullptr
      */
     std::shared_ptr<PageDirectory> GetPageDir(size_t offset = 0);
 
+    /**
+     * @brief index번째 PageDirectory
+     * 
+     * @param index PageDirectory의 index
+     * @return std::shared_ptr<PageDirectory> 없으면 nullptr
+     */
+    std::shared_ptr<PageDirectory> GetPageDirByIdx(int index);
+
+    /**
+     * @brief 체인에 있는 PageDirectory 개수
+     */
+    int GetPageDirCount() const {return static_cast<int>(dirs_.size());}
+
+    /**
+     * @brief 모든 PageDirectory에 등록된 페이지 수
+     */
+    int GetPageCount() const;
+
+    const std::string& GetFilename() const {return filename_;}
+
     //
     ~File();
 };
@@ -0,0 +1,238 @@
+#include "filter_kernels.h"
+
+#include <cstring>
+#include <functional>
+
+#include "commons.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ABCDB_FILTER_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__)
+#define ABCDB_FILTER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief i번째 행부터 width개 행 중 mask bit가 0인 행을 selection에서 지움 (i는 width의 배수)
+ */
+inline void ApplyMask(uint64_t *selection, size_t i, unsigned mask, unsigned width) {
+    uint64_t drop = static_cast<uint64_t>(~mask & ((1u << width) - 1)) << (i & 63);
+    selection[i >> 6] &= ~drop;
+}
+
+void ClearRange(uint64_t *selection, size_t begin, size_t n) {
+    for (size_t i = begin; i < n; ++i) {
+        selection[i >> 6] &= ~(static_cast<uint64_t>(1) << (i & 63));
+    }
+}
+
+template <typename T, typename Cmp>
+void ScalarLoop(const T *values, size_t begin, size_t n, T literal, uint64_t *selection) {
+    Cmp cmp;
+    for (size_t i = begin; i < n; ++i) {
+        if (!cmp(values[i], literal)) {
+            selection[i >> 6] &= ~(static_cast<uint64_t>(1) << (i & 63));
+        }
+    }
+}
+
+template <typename T>
+void ScalarFilter(const T *values, size_t begin, size_t n, int sign_type, T literal, uint64_t *selection) {
+    switch (sign_type) {
+        case SIGN_EQ: ScalarLoop<T, std::equal_to<T>>(values, begin, n, literal, selection); break;
+        case SIGN_NE: ScalarLoop<T, std::not_equal_to<T>>(values, begin, n, literal, selection); break;
+        case SIGN_LT: ScalarLoop<T, std::less<T>>(values, begin, n, literal, selection); break;
+        case SIGN_LE: ScalarLoop<T, std::less_equal<T>>(values, begin, n, literal, selection); break;
+        case SIGN_GT: ScalarLoop<T, std::greater<T>>(values, begin, n, literal, selection); break;
+        case SIGN_GE: ScalarLoop<T, std::greater_equal<T>>(values, begin, n, literal, selection); break;
+        default: ClearRange(selection, begin, n); break;
+    }
+}
+
+#ifdef ABCDB_FILTER_SSE2
+/*=======================================SSE2 (4 lanes)================================================ */
+template <int Sign>
+inline unsigned Sse2CmpInt(__m128i v, __m128i l) {
+    switch (Sign) {
+        case SIGN_EQ: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, l)));
+        case SIGN_NE: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, l))) ^ 0xF;
+        case SIGN_LT: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, l)));
+        case SIGN_LE: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, l))) ^ 0xF;
+        case SIGN_GT: return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v, l)));
+        default:      return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, l))) ^ 0xF;  // SIGN_GE
+    }
+}
+
+template <int Sign>
+inline unsigned Sse2CmpFloat(__m128 v, __m128 l) {
+    switch (Sign) {
+        case SIGN_EQ: return _mm_movemask_ps(_mm_cmpeq_ps(v, l));
+        case SIGN_NE: return _mm_movemask_ps(_mm_cmpneq_ps(v, l));
+        case SIGN_LT: return _mm_movemask_ps(_mm_cmplt_ps(v, l));
+        case SIGN_LE: return _mm_movemask_ps(_mm_cmple_ps(v, l));
+        case SIGN_GT: return _mm_movemask_ps(_mm_cmpgt_ps(v, l));
+        default:      return _mm_movemask_ps(_mm_cmpge_ps(v, l));  // SIGN_GE
+    }
+}
+
+template <int Sign>
+size_t Sse2LoopInt32(const int32_t *values, size_t n, int32_t literal, uint64_t *selection) {
+    __m128i l = _mm_set1_epi32(literal);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+        ApplyMask(selection, i, Sse2CmpInt<Sign>(v, l), 4);
+    }
+    return i;
+}
+
+template <int Sign>
+size_t Sse2LoopFloat(const float *values, size_t n, float literal, uint64_t *selection) {
+    __m128 l = _mm_set1_ps(literal);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        ApplyMask(selection, i, Sse2CmpFloat<Sign>(_mm_loadu_ps(values + i), l), 4);
+    }
+    return i;
+}
+#endif
+
+#ifdef ABCDB_FILTER_AVX2
+/*=======================================AVX2 (8 lanes)================================================ */
+template <int Sign>
+__attribute__((target("avx2"))) inline unsigned Avx2CmpInt(__m256i v, __m256i l) {
+    switch (Sign) {
+        case SIGN_EQ: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, l)));
+        case SIGN_NE: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, l))) ^ 0xFF;
+        case SIGN_LT: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(l, v)));
+        case SIGN_LE: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, l))) ^ 0xFF;
+        case SIGN_GT: return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v, l)));
+        default:      return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(l, v))) ^ 0xFF;  // SIGN_GE
+    }
+}
+
+template <int Sign>
+__attribute__((target("avx2"))) inline unsigned Avx2CmpFloat(__m256 v, __m256 l) {
+    switch (Sign) {
+        case SIGN_EQ: return _mm256_movemask_ps(_mm256_cmp_ps(v, l, _CMP_EQ_OQ));
+        case SIGN_NE: return _mm256_movemask_ps(_mm256_cmp_ps(v, l, _CMP_NEQ_UQ));
+        case SIGN_LT: return _mm256_movemask_ps(_mm256_cmp_ps(v, l, _CMP_LT_OQ));
+        case SIGN_LE: return _mm256_movemask_ps(_mm256_cmp_ps(v, l, _CMP_LE_OQ));
+        case SIGN_GT: return _mm256_movemask_ps(_mm256_cmp_ps(v, l, _CMP_GT_OQ));
+        default:      return _mm256_movemask_ps(_mm256_cmp_ps(v, l, _CMP_GE_OQ));  // SIGN_GE
+    }
+}
+
+template <int Sign>
+__attribute__((target("avx2"))) size_t Avx2LoopInt32(const int32_t *values, size_t n, int32_t literal, uint64_t *selection) {
+    __m256i l = _mm256_set1_epi32(literal);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+        ApplyMask(selection, i, Avx2CmpInt<Sign>(v, l), 8);
+    }
+    return i;
+}
+
+template <int Sign>
+__attribute__((target("avx2"))) size_t Avx2LoopFloat(const float *values, size_t n, float literal, uint64_t *selection) {
+    __m256 l = _mm256_set1_ps(literal);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        ApplyMask(selection, i, Avx2CmpFloat<Sign>(_mm256_loadu_ps(values + i), l), 8);
+    }
+    return i;
+}
+
+bool HasAvx2() {
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+}
+#endif
+
+/**
+ * @brief sign_type에 맞는 벡터 루프를 골라 실행. 처리한 행 수(벡터 폭의 배수)를 반환하며 나머지는 호출한 쪽이 스칼라로 처리
+ */
+template <typename T>
+size_t VectorFilter(const T *values, size_t n, int sign_type, T literal, uint64_t *selection);
+
+#define ABCDB_DISPATCH_SIGN(LOOP)                                           \
+    switch (sign_type) {                                                    \
+        case SIGN_EQ: return LOOP<SIGN_EQ>(values, n, literal, selection);  \
+        case SIGN_NE: return LOOP<SIGN_NE>(values, n, literal, selection);  \
+        case SIGN_LT: return LOOP<SIGN_LT>(values, n, literal, selection);  \
+        case SIGN_LE: return LOOP<SIGN_LE>(values, n, literal, selection);  \
+        case SIGN_GT: return LOOP<SIGN_GT>(values, n, literal, selection);  \
+        case SIGN_GE: return LOOP<SIGN_GE>(values, n, literal, selection);  \
+        default: return 0;                                                  \
+    }
+
+template <>
+size_t VectorFilter<int32_t>(const int32_t *values, size_t n, int sign_type, int32_t literal, uint64_t *selection) {
+#ifdef ABCDB_FILTER_AVX2
+    if (HasAvx2()) {
+        ABCDB_DISPATCH_SIGN(Avx2LoopInt32)
+    }
+#endif
+#ifdef ABCDB_FILTER_SSE2
+    ABCDB_DISPATCH_SIGN(Sse2LoopInt32)
+#endif
+    return 0;
+}
+
+template <>
+size_t VectorFilter<float>(const float *values, size_t n, int sign_type, float literal, uint64_t *selection) {
+#ifdef ABCDB_FILTER_AVX2
+    if (HasAvx2()) {
+        ABCDB_DISPATCH_SIGN(Avx2LoopFloat)
+    }
+#endif
+#ifdef ABCDB_FILTER_SSE2
+    ABCDB_DISPATCH_SIGN(Sse2LoopFloat)
+#endif
+    return 0;
+}
+
+#undef ABCDB_DISPATCH_SIGN
+
+}  // namespace
+
+void GatherInt32(const char *const *records, size_t n, int offset, int32_t *out) {
+    for (size_t i = 0; i < n; ++i) {
+        std::memcpy(&out[i], records[i] + offset, sizeof(int32_t));
+    }
+}
+
+void GatherFloat(const char *const *records, size_t n, int offset, float *out) {
+    for (size_t i = 0; i < n; ++i) {
+        std::memcpy(&out[i], records[i] + offset, sizeof(float));
+    }
+}
+
+void FilterInt32(const int32_t *values, size_t n, int sign_type, int32_t literal, uint64_t *selection) {
+    size_t done = VectorFilter<int32_t>(values, n, sign_type, literal, selection);
+    ScalarFilter<int32_t>(values, done, n, sign_type, literal, selection);
+}
+
+void FilterFloat(const float *values, size_t n, int sign_type, float literal, uint64_t *selection) {
+    size_t done = VectorFilter<float>(values, n, sign_type, literal, selection);
+    ScalarFilter<float>(values, done, n, sign_type, literal, selection);
+}
+
+const char *FilterKernelIsa() {
+#ifdef ABCDB_FILTER_AVX2
+    if (HasAvx2()) {
+        return "avx2";
+    }
+#endif
+#ifdef ABCDB_FILTER_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,40 @@
+#ifndef ABCDB_FILTER_KERNELS_H_
+#define ABCDB_FILTER_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 한 페이지 분량의 열 값에 대해 비교 조건을 한 번에 적용하는 batch filter 커널
+ * @details 결과는 selection bitmap(행 i → selection[i / 64]의 i % 64 번째 bit)에 AND로 반영하므로
+ *          조건 여러 개를 차례로 적용하면 AND 조건이 된다. selection은 호출 전에 1로 채워둬야 한다.
+ *
+ *          x86에서는 SSE2로 4개씩 비교하고, 실행 중 CPU가 AVX2를 지원하면 AVX2로 8개씩 비교한다.
+ *          (AVX2 함수는 target attribute로만 컴파일하므로 빌드 옵션을 바꿀 필요 없음) 그 밖의 환경은 스칼라 루프.
+ */
+
+/**
+ * @brief 레코드들의 offset 위치 4바이트 값을 연속 배열로 모음
+ *
+ * @param records 레코드 시작 주소 배열
+ * @param n 레코드 수
+ * @param offset 레코드 안에서 열의 위치
+ * @param out n개 크기 배열
+ */
+void GatherInt32(const char *const *records, size_t n, int offset, int32_t *out);
+void GatherFloat(const char *const *records, size_t n, int offset, float *out);
+
+/**
+ * @brief values[i] (sign_type) literal 이 거짓인 행의 bit를 selection에서 지움
+ *
+ * @param sign_type SIGN_EQ ... SIGN_GE (commons.h), 알 수 없는 값이면 모든 bit를 지움
+ */
+void FilterInt32(const int32_t *values, size_t n, int sign_type, int32_t literal, uint64_t *selection);
+void FilterFloat(const float *values, size_t n, int sign_type, float literal, uint64_t *selection);
+
+/**
+ * @brief 현재 커널이 사용하는 명령어 집합 이름 ("avx2", "sse2", "scalar")
+ */
+const char *FilterKernelIsa();
+
+#endif
@@ -0,0 +1,46 @@
+#include "free_space_map.h"
+
+FreeSpaceMap::FreeSpaceMap(size_t page_size) : page_size_(page_size), buckets_(FSM_BUCKETS) {}
+
+int FreeSpaceMap::BucketOf(size_t free_space) const {
+    size_t bucket = free_space * FSM_BUCKETS / page_size_;
+    return bucket >= FSM_BUCKETS ? FSM_BUCKETS - 1 : static_cast<int>(bucket);
+}
+
+void FreeSpaceMap::Erase(uint64_t page_no) {
+    int bucket = bucket_of_[page_no];
+    if (bucket < 0) {
+        return;
+    }
+    std::vector<uint64_t> &pages = buckets_[bucket];
+    size_t pos = pos_in_bucket_[page_no];
+    pages[pos] = pages.back();  // 마지막 원소를 빈 자리로 옮겨 O(1) 삭제
+    pos_in_bucket_[pages[pos]] = pos;
+    pages.pop_back();
+    bucket_of_[page_no] = -1;
+}
+
+void FreeSpaceMap::Update(uint64_t page_no, size_t free_space) {
+    if (page_no >= bucket_of_.size()) {
+        bucket_of_.resize(page_no + 1, -1);
+        pos_in_bucket_.resize(page_no + 1, 0);
+    }
+    int bucket = BucketOf(free_space);
+    if (bucket_of_[page_no] == bucket) {
+        return;
+    }
+    Erase(page_no);
+    bucket_of_[page_no] = bucket;
+    pos_in_bucket_[page_no] = buckets_[bucket].size();
+    buckets_[bucket].push_back(page_no);
+}
+
+bool FreeSpaceMap::Find(size_t needed, uint64_t *page_no) const {
+    for (int bucket = BucketOf(needed) + 1; bucket < FSM_BUCKETS; ++bucket) {
+        if (!buckets_[bucket].empty()) {
+            *page_no = buckets_[bucket].back();
+            return true;
+        }
+    }
+    return false;
+}
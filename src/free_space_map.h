@@ -0,0 +1,50 @@
+#ifndef ABCDB_FREE_SPACE_MAP_H_
+#define ABCDB_FREE_SPACE_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define FSM_BUCKETS 64
+
+/**
+ * @brief 테이블 파일의 페이지별 남은 공간을 FSM_BUCKETS개의 구간으로 나누어 관리
+ * @details 페이지는 전역 번호(dir_idx * MaxEntries + page_idx)로 구분한다. 각 구간은 페이지 번호 배열이며
+ *          추가/삭제/탐색 모두 O(1)이다. 찾을 때는 필요한 크기보다 확실히 큰 구간만 보므로 구간 폭
+ *          (page_size / FSM_BUCKETS)만큼의 공간은 놓칠 수 있다.
+ *          값은 PageDirectoryEntry에 저장된 남은 공간에서 다시 만들어지는 힌트이며, 실제 여유 공간은
+ *          페이지를 읽은 뒤 Page::HasEnoughSpace로 다시 확인해야 한다.
+ */
+class FreeSpaceMap {
+private:
+    size_t page_size_;
+    std::vector<std::vector<uint64_t>> buckets_;  // 구간별 페이지 번호
+    std::vector<int> bucket_of_;                  // 페이지 번호 -> 구간 (-1이면 없음)
+    std::vector<size_t> pos_in_bucket_;           // 페이지 번호 -> 구간 배열 내 위치
+
+    int BucketOf(size_t free_space) const;
+    void Erase(uint64_t page_no);
+
+public:
+    explicit FreeSpaceMap(size_t page_size);
+
+    /**
+     * @brief 페이지의 남은 공간 갱신 (처음 보는 페이지면 추가)
+     *
+     * @param page_no 페이지 전역 번호
+     * @param free_space 남은 공간 (bytes)
+     */
+    void Update(uint64_t page_no, size_t free_space);
+
+    /**
+     * @brief needed bytes 이상 남은 페이지 중 가장 덜 빈 구간의 페이지를 찾음
+     *
+     * @param needed 필요한 공간 (레코드 + 슬롯)
+     * @param page_no 찾은 페이지 전역 번호
+     * @return true 찾음
+     * @return false 그런 페이지 없음
+     */
+    bool Find(size_t needed, uint64_t *page_no) const;
+};
+
+#endif  // ABCDB_FREE_SPACE_MAP_H_
@@ -1,5 +1,6 @@
 #include "interpreter.h"
 
+#include <cctype>
 #include <fstream>
 #include <iostream>
 #include <any>
@@ -8,22 +9,165 @@
 #include <boost/filesystem.hpp>
 #include <boost/regex.hpp>
 
+#include "commons.h"
 #include "exceptions.h"
+#include "session_output.h"
 #include "api.h"
+#include "metrics.h"
 
 using namespace std;
 using namespace antlr4;
 
+namespace
+{
+
+/**
+ * @brief 캐시하거나 PREPARE할 수 있는 문장(INSERT, SELECT)의 복사본
+ *
+ * @return SQL* 다른 문장이면 nullptr
+ */
+SQL *CloneStatement(SQL *st)
+{
+  if (SQLInsert *insert = dynamic_cast<SQLInsert *>(st))
+  {
+    return new SQLInsert(*insert);
+  }
+  if (SQLSelect *select = dynamic_cast<SQLSelect *>(st))
+  {
+    return new SQLSelect(*select);
+  }
+  return nullptr;
+}
+
+/**
+ * @brief 캐시 key: 앞뒤 공백과 끝의 ';'를 뺀 문장
+ */
+std::string NormalizeStatement(const std::string &statement)
+{
+  std::string key = boost::algorithm::trim_copy(statement);
+  while (!key.empty() && key.back() == ';')
+  {
+    key.pop_back();
+    boost::algorithm::trim_right(key);
+  }
+  return key;
+}
+
+/**
+ * @brief "EXECUTE name [USING value, ...]"를 ANTLR 없이 읽음. 값은 문법의 STRING_LITERAL, NUMERIC_LITERAL과 같은 규칙
+ * @details EXECUTE, USING은 대소문자를 가리지 않고, 문자열 값의 ''는 따옴표 하나로 바꾼다 (SQLStatementVisitor::VisitValue와 같음).
+ *
+ * @return SQLExecute* 형식이 다르면 nullptr (ANTLR로 파싱해 오류를 알림)
+ */
+SQLExecute *ParseExecute(const std::string &statement)
+{
+  size_t pos = 0;
+  size_t n = statement.size();
+  auto skip_space = [&] {
+    while (pos < n && isspace(static_cast<unsigned char>(statement[pos])))
+      pos++;
+  };
+  auto word = [&]() -> std::string {
+    size_t begin = pos;
+    if (pos < n && (isalpha(static_cast<unsigned char>(statement[pos])) || statement[pos] == '_'))
+    {
+      while (pos < n && (isalnum(static_cast<unsigned char>(statement[pos])) || statement[pos] == '_'))
+        pos++;
+    }
+    return statement.substr(begin, pos - begin);
+  };
+  auto digits = [&] {
+    while (pos < n && isdigit(static_cast<unsigned char>(statement[pos])))
+      pos++;
+  };
+
+  skip_space();
+  if (!boost::algorithm::iequals(word(), "EXECUTE"))
+    return nullptr;
+  skip_space();
+  std::string name = word();
+  if (name.empty())
+    return nullptr;
+
+  std::vector<SQLValue> params;
+  skip_space();
+  if (pos < n && statement[pos] != ';')
+  {
+    if (!boost::algorithm::iequals(word(), "USING"))
+      return nullptr;
+    while (true)
+    {
+      skip_space();
+      SQLValue value;
+      if (pos < n && statement[pos] == '\'')
+      {
+        size_t begin = ++pos;
+        while (pos < n && (statement[pos] != '\'' || (pos + 1 < n && statement[pos + 1] == '\'')))
+          pos += statement[pos] == '\'' ? 2 : 1; // '' 는 따옴표 하나
+        if (pos >= n)
+          return nullptr;
+        value.data_type = T_CHAR;
+        value.value = statement.substr(begin, pos - begin);
+        boost::algorithm::replace_all(value.value, "''", "'");
+        pos++;
+      }
+      else if (pos < n && isdigit(static_cast<unsigned char>(statement[pos])))
+      {
+        size_t begin = pos;
+        digits();
+        value.data_type = T_INT;
+        if (pos + 1 < n && statement[pos] == '.' && isdigit(static_cast<unsigned char>(statement[pos + 1])))
+        {
+          pos++;
+          digits();
+          value.data_type = T_FLOAT;
+        }
+        value.value = statement.substr(begin, pos - begin);
+      }
+      else
+      {
+        return nullptr;
+      }
+      params.push_back(value);
+      skip_space();
+      if (pos >= n || statement[pos] != ',')
+        break;
+      pos++;
+    }
+  }
+  while (pos < n && statement[pos] == ';')
+  {
+    pos++;
+    skip_space();
+  }
+  if (pos != n)
+    return nullptr;
+
+  SQLExecute *stmt = new SQLExecute();
+  stmt->set_name(name);
+  stmt->set_params(params);
+  return stmt;
+}
+
+} // namespace
+
+std::string Interpreter::DataPath()
+{
+  return string(getenv("HOME")) + "/ABCDBData/";
+}
+
 Interpreter::Interpreter() : api(nullptr)
 {
-  string p = string(getenv("HOME")) + "/ABCDBData/";
-  api = new API(p);
+  api = new API(DataPath());
 }
 
+Interpreter::Interpreter(API *session) : api(session) {}
+
 Interpreter::~Interpreter() { delete api; }
 
-void Interpreter::ExecSQL(std::string statement)
+SQL *Interpreter::ParseSQL(std::string statement)
 {
+  LatencyTimer timer(Metrics::PARSE_TIME);
   sql_statement_ = statement;
 
   // ANTLR4를 사용하여 SQL 문을 파싱합니다.
@@ -37,19 +181,83 @@ void Interpreter::ExecSQL(std::string statement)
 
   // 방문자를 생성하여 구문 트리를 순회하고 SQL 문 객체를 생성합니다.
   SQLStatementVisitor visitor;
-  antlrcpp::Any result = visitor.visit(tree);
-
-  SQL *sqlStatement = nullptr;
+  antlrcpp::Any result;
+  try
+  {
+    result = visitor.visit(tree);
+  }
+  catch (const SyntaxErrorException &e)
+  {
+    return nullptr;
+  }
 
   try
   {
-    sqlStatement = std::any_cast<SQL *>(result);
+    return std::any_cast<SQL *>(result);
   }
   catch (const std::bad_any_cast &e)
   {
-    std::cerr << "Bad any_cast: " << e.what() << std::endl;
-    return;
+    SessionErr() << "Bad any_cast: " << e.what() << std::endl;
+    return nullptr;
+  }
+}
+
+SQL *Interpreter::ParseCached(const std::string &statement, bool remember)
+{
+  std::string key = NormalizeStatement(statement);
+  auto it = plan_index_.find(key);
+  if (it != plan_index_.end())
+  {
+    plans_.splice(plans_.begin(), plans_, it->second);
+    return CloneStatement(it->second->second.get());
+  }
+  if (SQLExecute *execute = ParseExecute(key))
+  {
+    return execute;
+  }
+
+  SQL *sqlStatement = ParseSQL(key);
+  SQLInsert *insert = dynamic_cast<SQLInsert *>(sqlStatement);
+  if (insert && insert->rows().size() > 1 && insert->param_count() == 0)
+  {
+    remember = false;
+  }
+  SQL *plan = sqlStatement == nullptr || !remember ? nullptr : CloneStatement(sqlStatement);
+  if (plan != nullptr)
+  {
+    plans_.emplace_front(key, std::unique_ptr<SQL>(plan));
+    plan_index_[key] = plans_.begin();
+    if (plans_.size() > PARSE_CACHE_SIZE)
+    {
+      plan_index_.erase(plans_.back().first);
+      plans_.pop_back();
+    }
+  }
+  return sqlStatement;
+}
+
+void Interpreter::RunPrepared(SQLExecute &st)
+{
+  auto it = prepared_.find(st.name());
+  if (it == prepared_.end())
+  {
+    throw PreparedStatementNotExistException();
+  }
+  std::unique_ptr<SQL> bound(CloneStatement(it->second.get()));
+  if (SQLInsert *insert = dynamic_cast<SQLInsert *>(bound.get()))
+  {
+    insert->BindParameters(st.params());
   }
+  else if (SQLSelect *select = dynamic_cast<SQLSelect *>(bound.get()))
+  {
+    select->BindParameters(st.params());
+  }
+  RunSQLStatement(bound.get());
+}
+
+void Interpreter::ExecSQL(std::string statement)
+{
+  SQL *sqlStatement = ParseCached(statement);
 
   if (sqlStatement != nullptr)
   {
@@ -59,12 +267,95 @@ void Interpreter::ExecSQL(std::string statement)
   }
   else
   {
-    std::cerr << "Failed to parse SQL statement." << std::endl;
+    SessionErr() << "Failed to parse SQL statement." << std::endl;
+  }
+}
+
+void Interpreter::ExecScript(const std::vector<std::string> &sqls)
+{
+  SQLInsert *batch = nullptr; // 아직 실행하지 않은 INSERT 묶음
+  for (size_t n = 0; n < sqls.size(); n++)
+  {
+    const std::string &sql = sqls[n];
+    if (boost::algorithm::trim_copy(sql).empty())
+    {
+      continue;
+    }
+    SQL *sqlStatement = ParseCached(sql, false); // 스크립트 한 줄짜리 문장이 캐시를 밀어내지 않게 함
+    if (sqlStatement == nullptr)
+    {
+      SessionErr() << "Statement " << n + 1 << ": Failed to parse SQL statement." << std::endl;
+      continue;
+    }
+
+    SQLInsert *insert = dynamic_cast<SQLInsert *>(sqlStatement);
+    bool invalid = false;
+    if (insert && insert->param_count() > 0)
+    {
+      invalid = true; // 묶지 않고 RunSQLStatement에서 오류
+    }
+    else if (insert)
+    {
+      try
+      {
+        api->CheckInsert(*insert);
+      }
+      catch (const std::exception &e)
+      {
+        invalid = true; // 오류는 따로 실행할 때 RunSQLStatement가 알림
+      }
+    }
+    if (invalid)
+    {
+      insert = nullptr;
+    }
+    if (insert && batch && insert->tb_name() == batch->tb_name())
+    {
+      batch->AppendRows(*insert);
+      delete sqlStatement;
+      if (batch->rows().size() >= EXEC_INSERT_BATCH_ROWS)
+      {
+        RunSQLStatement(batch);
+        delete batch;
+        batch = nullptr;
+      }
+      continue;
+    }
+
+    // 다른 문장이 나오면 모아둔 INSERT를 먼저 실행해 순서를 지킴
+    if (batch)
+    {
+      RunSQLStatement(batch);
+      delete batch;
+      batch = nullptr;
+    }
+    if (insert)
+    {
+      batch = insert;
+      continue;
+    }
+    if (invalid)
+    {
+      SessionErr() << "Statement " << n + 1 << ":" << std::endl;
+    }
+    RunSQLStatement(sqlStatement);
+    delete sqlStatement;
+  }
+  if (batch)
+  {
+    RunSQLStatement(batch);
+    delete batch;
   }
 }
 
 void Interpreter::RunSQLStatement(SQL *sqlStatement)
 {
+  // EXEC와 EXECUTE는 안에서 실행하는 문장마다 따로 기록됨
+  std::unique_ptr<LatencyTimer> timer;
+  if (sqlStatement->sql_type() != 80 && sqlStatement->sql_type() != 121)
+  {
+    timer.reset(new LatencyTimer(Metrics::EXECUTE_TIME));
+  }
   try
   {
     switch (sqlStatement->sql_type())
@@ -90,19 +381,22 @@ void Interpreter::RunSQLStatement(SQL *sqlStatement)
         api->CreateTable(*st);
     }
     break;
-    // case 32:
-    // {
-    //   SQLCreateIndex *st = dynamic_cast<SQLCreateIndex *>(sqlStatement);
-    //   if (st)
-    //     api->CreateIndex(*st);
-    // }
-    // break;
+    case 32:
+    {
+      SQLCreateIndex *st = dynamic_cast<SQLCreateIndex *>(sqlStatement);
+      if (st)
+        api->CreateIndex(*st);
+    }
+    break;
     case 40:
       api->ShowDatabases();
       break;
     case 41:
       api->ShowTables();
       break;
+    case 42:
+      api->ShowStats();
+      break;
     // case 50:
     // {
     //   SQLDropDatabase *st = dynamic_cast<SQLDropDatabase *>(sqlStatement);
@@ -117,13 +411,13 @@ void Interpreter::RunSQLStatement(SQL *sqlStatement)
     //     api->DropTable(*st);
     // }
     // break;
-    // case 52:
-    // {
-    //   SQLDropIndex *st = dynamic_cast<SQLDropIndex *>(sqlStatement);
-    //   if (st)
-    //     api->DropIndex(*st);
-    // }
-    // break;
+    case 52:
+    {
+      SQLDropIndex *st = dynamic_cast<SQLDropIndex *>(sqlStatement);
+      if (st)
+        api->DropIndex(*st);
+    }
+    break;
     case 60:
     {
       SQLUse *st = dynamic_cast<SQLUse *>(sqlStatement);
@@ -134,6 +428,8 @@ void Interpreter::RunSQLStatement(SQL *sqlStatement)
     case 70:
     {
       SQLInsert *st = dynamic_cast<SQLInsert *>(sqlStatement);
+      if (st && st->param_count() > 0)
+        throw SyntaxErrorException(); // '?'는 PREPARE에서만
       if (st)
         api->Insert(*st);
     }
@@ -147,7 +443,7 @@ void Interpreter::RunSQLStatement(SQL *sqlStatement)
         ifstream in(st->file_name(), ios::in | ios::binary);
         if (!in)
         {
-          cerr << "Could not open file: " << st->file_name() << endl;
+          SessionErr() << "Could not open file: " << st->file_name() << endl;
           break;
         }
         in.seekg(0, std::ios::end);
@@ -155,28 +451,54 @@ void Interpreter::RunSQLStatement(SQL *sqlStatement)
         in.seekg(0, std::ios::beg);
         in.read(&contents[0], contents.size());
         in.close();
-        cout << endl;
+        SessionOut() << endl;
 
-        // 내용을 세미콜론으로 분할하여 실행합니다.
+        // 내용을 세미콜론으로 분할하여 실행합니다. 같은 테이블에 연속된 INSERT는 한 번에 적재합니다.
         vector<string> sqls;
         boost::split(sqls, contents, boost::is_any_of(";"));
-        for (const auto &sql : sqls)
-        {
-          if (!sql.empty())
-          {
-            ExecSQL(sql);
-          }
-        }
+        ExecScript(sqls);
       }
     }
     break;
     case 90:
     {
       SQLSelect *st = dynamic_cast<SQLSelect *>(sqlStatement);
+      if (st && st->param_count() > 0)
+        throw SyntaxErrorException();
       if (st)
         api->Select(*st);
     }
     break;
+    case 91:
+    {
+      SQLExplain *st = dynamic_cast<SQLExplain *>(sqlStatement);
+      if (st && st->select()->param_count() > 0)
+        throw SyntaxErrorException();
+      if (st)
+        api->ExplainAnalyze(*st->select());
+    }
+    break;
+    case 120:
+    {
+      SQLPrepare *st = dynamic_cast<SQLPrepare *>(sqlStatement);
+      if (st && st->statement())
+        prepared_[st->name()].reset(st->release_statement());
+    }
+    break;
+    case 121:
+    {
+      SQLExecute *st = dynamic_cast<SQLExecute *>(sqlStatement);
+      if (st)
+        RunPrepared(*st);
+    }
+    break;
+    case 122:
+    {
+      SQLDeallocate *st = dynamic_cast<SQLDeallocate *>(sqlStatement);
+      if (st && prepared_.erase(st->name()) == 0)
+        throw PreparedStatementNotExistException();
+    }
+    break;
     // case 100:
     // {
     //   SQLDelete *st = dynamic_cast<SQLDelete *>(sqlStatement);
@@ -192,56 +514,100 @@ void Interpreter::RunSQLStatement(SQL *sqlStatement)
     // }
     // break;
     default:
-      cerr << "Unknown SQL statement type." << endl;
+      SessionErr() << "Unknown SQL statement type." << endl;
       break;
     }
   }
   catch (SyntaxErrorException &e)
   {
-    cerr << "Syntax Error!" << endl;
+    SessionErr() << "Syntax Error!" << endl;
   }
   catch (NoDatabaseSelectedException &e)
   {
-    cerr << "No database selected!" << endl;
+    SessionErr() << "No database selected!" << endl;
   }
   catch (DatabaseNotExistException &e)
   {
-    cerr << "Database doesn't exist!" << endl;
+    SessionErr() << "Database doesn't exist!" << endl;
   }
   catch (DatabaseAlreadyExistsException &e)
   {
-    cerr << "Database already exists!" << endl;
+    SessionErr() << "Database already exists!" << endl;
   }
   catch (TableNotExistException &e)
   {
-    cerr << "Table doesn't exist!" << endl;
+    SessionErr() << "Table doesn't exist!" << endl;
   }
   catch (OneIndexEachTableException &e)
   {
-    cerr << "Each table could only have one index!" << endl;
+    SessionErr() << "Each table could only have one index!" << endl;
   }
   catch (BPlusTreeException &e)
   {
-    cerr << "BPlusTree exception!" << endl;
+    SessionErr() << "BPlusTree exception!" << endl;
   }
   catch (TableAlreadyExistsException &e)
   {
-    cerr << "Table already exists!" << endl;
+    SessionErr() << "Table already exists!" << endl;
   }
   catch (IndexAlreadyExistsException &e)
   {
-    cerr << "Index already exists!" << endl;
+    SessionErr() << "Index already exists!" << endl;
   }
   catch (IndexNotExistException &e)
   {
-    cerr << "Index doesn't exist!" << endl;
+    SessionErr() << "Index doesn't exist!" << endl;
   }
   catch (IndexMustBeCreatedOnPKException &e)
   {
-    cerr << "Index must be created on primary key!" << endl;
+    SessionErr() << "Index must be created on primary key!" << endl;
   }
   catch (PrimaryKeyConflictException &e)
   {
-    cerr << "Primary key conflicts!" << endl;
+    SessionErr() << "Primary key conflicts!" << endl;
+  }
+  catch (BufferPoolFullException &e)
+  {
+    SessionErr() << "Buffer pool is full: every frame is pinned!" << endl;
+  }
+  catch (AttributeNotExistException &e)
+  {
+    SessionErr() << "Attribute doesn't exist!" << endl;
+  }
+  catch (InvalidFileFormatException &e)
+  {
+    SessionErr() << "Invalid table file format or page size mismatch!" << endl;
+  }
+  catch (PreparedStatementNotExistException &e)
+  {
+    SessionErr() << "Prepared statement doesn't exist!" << endl;
+  }
+  catch (AttributeNotGroupedException &e)
+  {
+    SessionErr() << "Selected attribute must appear in GROUP BY!" << endl;
+  }
+  catch (InvalidAggregateException &e)
+  {
+    SessionErr() << "SUM needs an int or float attribute!" << endl;
+  }
+  catch (AggregateOverflowException &e)
+  {
+    SessionErr() << "Aggregate result is out of int range!" << endl;
+  }
+  catch (AmbiguousAttributeException &e)
+  {
+    SessionErr() << "Attribute name is ambiguous, write it as table.attribute!" << endl;
+  }
+  catch (InvalidJoinException &e)
+  {
+    SessionErr() << "JOIN must match one attribute of each table with the same type!" << endl;
+  }
+  catch (RowTooLargeException &e)
+  {
+    SessionErr() << "Row does not fit in a page, raise page_size (or work_mem for temporary files)!" << endl;
+  }
+  catch (ReadOnlyException &e)
+  {
+    SessionErr() << "Database is opened read-only (read_only = on), only queries are allowed!" << endl;
   }
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
 #ifndef INTERPRETER_H_
 #define INTERPRETER_H_
 
+#include <list>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "api.h"
@@ -12,15 +16,66 @@
 #include "SQLParser.h"
 #include "sql_statement_visitor.h"
 
+#define EXEC_INSERT_BATCH_ROWS 10000  // EXEC에서 한 번에 적재하는 최대 INSERT 행 수
+#define PARSE_CACHE_SIZE 256          // 세션마다 파싱 결과를 기억하는 INSERT/SELECT 문장 수
+
+/**
+ * @brief SQL 문자열을 파싱해 API로 실행하는 세션
+ * @details 같은 INSERT/SELECT 문자열이 다시 오면 ANTLR로 파싱하지 않고 LRU 캐시(PARSE_CACHE_SIZE개)의 결과를 복사해 쓴다.
+ *          EXEC 스크립트의 문장과 값을 바로 쓴 multi-row INSERT는 캐시에 넣지 않는다.
+ *          PREPARE로 준비한 문장은 EXECUTE name USING ... 로 '?' 자리를 채워 실행하며, EXECUTE 문은 직접 읽으므로
+ *          반복 실행에서는 ANTLR을 거치지 않는다. 준비한 문장과 캐시는 세션마다 따로 가진다.
+ */
 class Interpreter
 {
 private:
+  typedef std::list<std::pair<std::string, std::unique_ptr<SQL>>> PlanList;
+
   API *api;
   std::string sql_statement_;
+  PlanList plans_;                                                 // 파싱 캐시, 앞이 최근
+  std::unordered_map<std::string, PlanList::iterator> plan_index_; // 문장 -> plans_ 위치
+  std::unordered_map<std::string, std::unique_ptr<SQL>> prepared_; // PREPARE 이름 -> 문장
+
   void RunSQLStatement(SQL *sqlStatement);
+  /**
+   * @brief SQL 문 하나를 파싱
+   *
+   * @return SQL* 호출한 쪽이 delete, 실패하면 nullptr
+   */
+  SQL *ParseSQL(std::string statement);
+  /**
+   * @brief ParseSQL과 같지만 캐시에 있는 문장이면 파싱하지 않고 복사본을 돌려줌
+   *
+   * @param remember 캐시에 없던 문장을 캐시에 넣음 (EXEC 스크립트의 문장은 넣지 않음)
+   * @return SQL* 호출한 쪽이 delete, 실패하면 nullptr
+   */
+  SQL *ParseCached(const std::string &statement, bool remember = true);
+  /**
+   * @brief 준비한 문장의 '?' 자리를 채워 실행
+   *
+   * @throw PreparedStatementNotExistException 없는 이름
+   * @throw SyntaxErrorException 값 개수가 자리 수와 다름
+   */
+  void RunPrepared(SQLExecute &st);
+  /**
+   * @brief EXEC 파일의 문장들을 차례로 실행. 같은 테이블에 연속된 INSERT는 multi-row INSERT 하나로 묶음
+   * @details 값 개수가 테이블과 맞지 않는 INSERT는 묶지 않고 따로 실행해, 몇 번째 문장인지와 오류를 알리고
+   *          앞뒤의 올바른 INSERT는 그대로 적재한다.
+   */
+  void ExecScript(const std::vector<std::string> &sqls);
 
 public:
+  /**
+   * @brief 데이터 디렉토리 ($HOME/ABCDBData/)
+   */
+  static std::string DataPath();
+
   Interpreter();
+  /**
+   * @brief 세션 서버의 세션처럼 이미 만든 API로 실행. api는 Interpreter가 지움
+   */
+  explicit Interpreter(API *session);
   ~Interpreter();
   void ExecSQL(std::string statement);
 };
@@ -0,0 +1,266 @@
+#include "join.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief JOIN 키의 64비트 해시. CompareJoinKey가 같다고 보는 값은 해시도 같음
+ */
+uint64_t HashJoinKey(const TKeyView &key) {
+    size_t len;
+    char buf[8] = {0};
+    const char *bytes = key.key();
+    if (key.key_type() == T_CHAR) {
+        len = strnlen(key.key(), key.length());
+    } else if (key.key_type() == T_FLOAT) {
+        float f;
+        memcpy(&f, key.key(), sizeof(float));
+        f = f == 0.0f ? 0.0f : f;   // -0 == 0
+        memcpy(buf, &f, sizeof(float));
+        bytes = buf;
+        len = sizeof(float);
+    } else {
+        len = 4;
+    }
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ static_cast<unsigned char>(bytes[i])) * 0x100000001B3ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    return h ^ (h >> 33);
+}
+
+void AppendSchema(std::vector<Attribute> &schema, const std::vector<Attribute> &attrs) {
+    schema.insert(schema.end(), attrs.begin(), attrs.end());
+}
+
+}  // namespace
+
+int CompareJoinKey(const TKeyView &a, const TKeyView &b) {
+    if (a.key_type() == T_CHAR) {
+        size_t la = strnlen(a.key(), a.length());
+        size_t lb = strnlen(b.key(), b.length());
+        int c = memcmp(a.key(), b.key(), std::min(la, lb));
+        return c != 0 ? c : (la > lb) - (la < lb);
+    }
+    return (a > b) - (a < b);
+}
+
+/*=======================================HashJoinCursor================================================ */
+HashJoinCursor::HashJoinCursor(std::unique_ptr<ResultCursor> left, std::unique_ptr<ResultCursor> right,
+                               int left_key, int right_key, bool build_left, size_t build_estimate,
+                               size_t work_mem, const std::string &spill_prefix, Arena *arena)
+    : build_left_(build_left), build_key_(build_left ? left_key : right_key),
+      probe_key_(build_left ? right_key : left_key), build_estimate_(build_estimate), work_mem_(work_mem),
+      spill_prefix_(spill_prefix), left_width_(left->Schema().size()),
+      build_((build_left ? left : right)->Schema(), arena), probe_layout_((build_left ? right : left)->Schema(), arena),
+      part_(0), built_(false), spilled_(false), probe_row_(nullptr), probe_hash_(0), match_(0) {
+    AppendSchema(schema_, left->Schema());
+    AppendSchema(schema_, right->Schema());
+    build_input_ = std::move(build_left ? left : right);
+    probe_input_ = std::move(build_left ? right : left);
+}
+
+size_t HashJoinCursor::Partition(uint64_t hash) const {
+    return static_cast<size_t>(hash >> 56) & (build_parts_.size() - 1);   // bucket은 하위 비트를 씀
+}
+
+void HashJoinCursor::StartSpill() {
+    size_t parts = JOIN_MIN_PARTITIONS;
+    while (parts < JOIN_MAX_PARTITIONS && build_estimate_ / parts > work_mem_ / 2) {
+        parts *= 2;
+    }
+    for (size_t p = 0; p < parts; p++) {
+        build_parts_.emplace_back(new SpillFile(spill_prefix_ + "b" + std::to_string(p)));
+        probe_parts_.emplace_back(new SpillFile(spill_prefix_ + "p" + std::to_string(p)));
+    }
+    for (size_t r = 0; r < build_.size(); r++) {
+        build_parts_[Partition(HashJoinKey(build_.Value(r, build_key_)))]->Add(
+            build_.row(r), static_cast<int>(build_.row_len()));
+    }
+    build_.Clear();
+    spilled_ = true;
+}
+
+void HashJoinCursor::Build() {
+    built_ = true;
+    while (const std::vector<TKeyView> *row = build_input_->Next()) {
+        build_.Append(*row);
+        if (!spilled_) {
+            if (build_.bytes() + build_.size() * 3 * sizeof(uint32_t) > work_mem_) {
+                StartSpill();
+            }
+            continue;
+        }
+        build_parts_[Partition(HashJoinKey(build_.Value(0, build_key_)))]->Add(
+            build_.row(0), static_cast<int>(build_.row_len()));
+        build_.Clear();
+    }
+    build_input_.reset();   // 고정한 페이지를 놓음
+
+    if (!spilled_) {
+        Index();
+        return;
+    }
+    // probe 쪽도 같은 partition으로 나눔
+    RowBuffer &one = probe_layout_;     // 행 하나씩만 담고 Clear하므로 chunk 하나로 충분
+    while (const std::vector<TKeyView> *row = probe_input_->Next()) {
+        one.Clear();
+        one.Append(*row);
+        probe_parts_[Partition(HashJoinKey((*row)[probe_key_]))]->Add(one.row(0), static_cast<int>(one.row_len()));
+    }
+    probe_input_.reset();
+    for (size_t p = 0; p < build_parts_.size(); p++) {
+        build_parts_[p]->Finish();
+        probe_parts_[p]->Finish();
+    }
+    LoadPartition(0);
+}
+
+void HashJoinCursor::Index() {
+    size_t n = build_.size();
+    size_t buckets = 16;
+    while (buckets < n * 2) {
+        buckets *= 2;
+    }
+    buckets_.assign(buckets, 0);
+    next_.assign(n, 0);
+    hashes_.resize(n);
+    for (size_t r = 0; r < n; r++) {
+        uint64_t hash = HashJoinKey(build_.Value(r, build_key_));
+        size_t b = hash & (buckets - 1);
+        hashes_[r] = static_cast<uint32_t>(hash);
+        next_[r] = buckets_[b];
+        buckets_[b] = static_cast<uint32_t>(r + 1);
+    }
+}
+
+void HashJoinCursor::LoadPartition(size_t part) {
+    part_ = part;
+    build_.Clear();
+    while (const char *row = build_parts_[part]->NextRow()) {
+        build_.AppendRaw(row);
+    }
+    build_parts_[part].reset();   // 파일 삭제
+    Index();
+}
+
+bool HashJoinCursor::NextProbe() {
+    if (!spilled_) {
+        probe_row_ = probe_input_->Next();
+        return probe_row_ != nullptr;
+    }
+    while (part_ < probe_parts_.size()) {
+        if (const char *row = probe_parts_[part_]->NextRow()) {
+            probe_layout_.View(row, probe_values_);
+            probe_row_ = &probe_values_;
+            return true;
+        }
+        probe_parts_[part_].reset();
+        if (part_ + 1 >= probe_parts_.size()) {
+            part_++;
+            break;
+        }
+        LoadPartition(part_ + 1);
+    }
+    probe_row_ = nullptr;
+    return false;
+}
+
+const std::vector<TKeyView> *HashJoinCursor::Next() {
+    if (!built_) {
+        Build();
+    }
+    while (true) {
+        if (probe_row_ != nullptr) {
+            const TKeyView &key = (*probe_row_)[probe_key_];
+            while (match_ != 0) {
+                uint32_t r = match_ - 1;
+                match_ = next_[r];
+                if (hashes_[r] != static_cast<uint32_t>(probe_hash_) ||
+                    CompareJoinKey(build_.Value(r, build_key_), key) != 0) {
+                    continue;
+                }
+                size_t build_first = build_left_ ? 0 : left_width_;
+                size_t probe_first = build_left_ ? left_width_ : 0;
+                row_.resize(schema_.size());
+                build_.View(build_.row(r), row_, build_first);
+                std::copy(probe_row_->begin(), probe_row_->end(), row_.begin() + probe_first);
+                return &row_;
+            }
+        }
+        if (!NextProbe()) {
+            return nullptr;
+        }
+        probe_hash_ = HashJoinKey((*probe_row_)[probe_key_]);
+        match_ = buckets_[probe_hash_ & (buckets_.size() - 1)];
+    }
+}
+
+/*=======================================MergeJoinCursor================================================ */
+MergeJoinCursor::MergeJoinCursor(std::unique_ptr<ResultCursor> left, std::unique_ptr<ResultCursor> right,
+                                 int left_key, int right_key, Arena *arena)
+    : left_(std::move(left)), right_(std::move(right)), left_key_(left_key), right_key_(right_key),
+      left_width_(left_->Schema().size()), group_(right_->Schema(), arena), group_pos_(0), started_(false),
+      left_row_(nullptr), right_row_(nullptr) {
+    AppendSchema(schema_, left_->Schema());
+    AppendSchema(schema_, right_->Schema());
+}
+
+const std::vector<TKeyView> *MergeJoinCursor::Next() {
+    if (!started_) {
+        started_ = true;
+        right_row_ = right_->Next();
+    }
+    while (true) {
+        if (left_row_ != nullptr && group_pos_ < group_.size()) {
+            row_.resize(schema_.size());
+            std::copy(left_row_->begin(), left_row_->end(), row_.begin());
+            group_.View(group_.row(group_pos_++), row_, left_width_);
+            return &row_;
+        }
+
+        left_row_ = left_->Next();
+        if (left_row_ == nullptr) {
+            return nullptr;
+        }
+        const TKeyView &key = (*left_row_)[left_key_];
+        if (group_.size() > 0 && CompareJoinKey(key, group_.Value(0, right_key_)) == 0) {
+            group_pos_ = 0;     // 같은 키의 왼쪽 행. 모아 둔 오른쪽 행과 다시 짝지음
+            continue;
+        }
+
+        // 오른쪽을 왼쪽 키까지 건너뛰고 같은 키의 행을 모음
+        group_.Clear();
+        group_pos_ = 0;
+        while (right_row_ != nullptr && CompareJoinKey((*right_row_)[right_key_], key) < 0) {
+            right_row_ = right_->Next();
+        }
+        if (right_row_ == nullptr) {
+            return nullptr;     // 남은 왼쪽 행과 맞는 행이 없음
+        }
+        while (right_row_ != nullptr && CompareJoinKey((*right_row_)[right_key_], key) == 0) {
+            group_.Append(*right_row_);
+            right_row_ = right_->Next();
+        }
+    }
+}
+
+std::unique_ptr<ResultCursor> SortByKey(std::unique_ptr<ResultCursor> input, int key, Arena *arena) {
+    std::shared_ptr<RowBuffer> rows = std::make_shared<RowBuffer>(input->Schema(), arena);
+    while (const std::vector<TKeyView> *row = input->Next()) {
+        rows->Append(*row);
+    }
+    std::vector<uint32_t> order(rows->size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    const RowBuffer &buffer = *rows;
+    std::stable_sort(order.begin(), order.end(), [&buffer, key](uint32_t a, uint32_t b) {
+        return CompareJoinKey(buffer.Value(a, key), buffer.Value(b, key)) < 0;
+    });
+    return std::unique_ptr<ResultCursor>(new BufferCursor(rows, std::move(order)));
+}
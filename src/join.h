@@ -0,0 +1,133 @@
+#ifndef ABCDB_JOIN_H_
+#define ABCDB_JOIN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "catalog_manager.h"
+#include "sql_statement.h"
+#include "cursor.h"
+#include "spill_file.h"
+
+#define JOIN_MIN_PARTITIONS 4           // build 쪽이 work_mem를 넘었을 때 나누는 최소 partition 수
+#define JOIN_MAX_PARTITIONS 256
+
+/**
+ * @brief JOIN 키 비교. CHAR는 길이가 달라도 NULL 앞까지만 비교함
+ */
+int CompareJoinKey(const TKeyView &a, const TKeyView &b);
+
+/**
+ * @brief 작은 쪽 입력으로 해시 테이블을 만들고(build) 다른 쪽 행마다 같은 키의 행을 찾는(probe) equi-join 커서
+ * @details build 쪽 행은 RowBuffer에 복사하고, 2의 거듭제곱 개 bucket과 행별 다음 행 번호로 chain을 만든다.
+ *          행마다 해시 하위 32비트를 두어 키 비교는 해시가 같을 때만 한다.
+ *
+ *          build 쪽이 work_mem를 넘으면 (Grace hash join) 지금까지 모은 행과 나머지 build 행, 그리고 probe 행 전체를
+ *          해시 상위 비트로 partition마다 SpillFile에 나눠 쓴 뒤 partition을 하나씩 메모리에 올려 join한다.
+ *          partition 수는 build 쪽 테이블 크기로 정하며, 한 partition이 여전히 work_mem를 넘어도 그대로 올린다.
+ *
+ *          결과 행은 왼쪽 테이블 속성 뒤에 오른쪽 테이블 속성이 온다 (어느 쪽이 build이든 같음).
+ */
+class HashJoinCursor : public ResultCursor {
+private:
+    std::unique_ptr<ResultCursor> build_input_;
+    std::unique_ptr<ResultCursor> probe_input_;
+    bool build_left_;                   // build 쪽이 왼쪽 테이블
+    int build_key_;
+    int probe_key_;
+    size_t build_estimate_;             // build 쪽 테이블 크기 (bytes), partition 수를 정하는 데 씀
+    size_t work_mem_;
+    std::string spill_prefix_;
+    std::vector<Attribute> schema_;
+    size_t left_width_;                 // 왼쪽 테이블 속성 수
+
+    RowBuffer build_;
+    std::vector<uint32_t> buckets_;     // 행 번호 + 1. 0이면 빈 bucket
+    std::vector<uint32_t> next_;        // 같은 bucket의 다음 행 번호 + 1
+    std::vector<uint32_t> hashes_;      // 행별 키 해시 하위 32비트
+
+    std::vector<std::unique_ptr<SpillFile>> build_parts_;   // 비어 있으면 spill하지 않음
+    std::vector<std::unique_ptr<SpillFile>> probe_parts_;
+    RowBuffer probe_layout_;            // spill할 probe 행을 한 행씩 담고, 다시 읽은 행을 나눔
+    size_t part_;                       // 지금 join하는 partition
+
+    bool built_;
+    bool spilled_;
+    const std::vector<TKeyView> *probe_row_;
+    std::vector<TKeyView> probe_values_;
+    uint64_t probe_hash_;
+    uint32_t match_;                    // probe 행의 chain에서 다음에 볼 행 번호 + 1
+    std::vector<TKeyView> row_;
+
+    void Build();
+
+    /**
+     * @brief 지금까지 모은 build 행을 partition 파일로 옮기고 이후 행을 partition으로 보냄
+     */
+    void StartSpill();
+    size_t Partition(uint64_t hash) const;
+    void Index();
+    void LoadPartition(size_t part);
+    bool NextProbe();
+
+public:
+    /**
+     * @param left_key 왼쪽 입력 행의 키 위치
+     * @param right_key 오른쪽 입력 행의 키 위치
+     * @param build_left 왼쪽 입력으로 해시 테이블을 만듦
+     * @param build_estimate build 쪽 입력의 예상 크기 (bytes)
+     * @param spill_prefix spill 파일 경로 앞부분 (디렉토리는 있어야 함)
+     * @param arena build 쪽 행을 담을 arena. nullptr이면 커서가 따로 잡음
+     */
+    HashJoinCursor(std::unique_ptr<ResultCursor> left, std::unique_ptr<ResultCursor> right, int left_key,
+                   int right_key, bool build_left, size_t build_estimate, size_t work_mem,
+                   const std::string &spill_prefix, Arena *arena = nullptr);
+
+    const std::vector<Attribute> &Schema() { return schema_; }
+    const std::vector<TKeyView> *Next();
+
+    /**
+     * @brief build 쪽이 work_mem를 넘어 partition 파일을 썼는지
+     */
+    bool spilled() const { return spilled_; }
+};
+
+/**
+ * @brief 키 순서로 정렬된 두 입력을 나란히 읽는 sort-merge equi-join 커서
+ * @details 입력은 키 순서여야 한다 (인덱스 스캔이나 SortByKey). 오른쪽에서 키가 같은 행들만 RowBuffer에 복사해 두고
+ *          왼쪽 행이 같은 키인 동안 그 행들과 짝을 짓는다. 어느 한쪽이 끝나면 더 읽지 않는다.
+ *
+ *          결과 행은 왼쪽 테이블 속성 뒤에 오른쪽 테이블 속성이 온다.
+ */
+class MergeJoinCursor : public ResultCursor {
+private:
+    std::unique_ptr<ResultCursor> left_;
+    std::unique_ptr<ResultCursor> right_;
+    int left_key_;
+    int right_key_;
+    std::vector<Attribute> schema_;
+    size_t left_width_;
+
+    RowBuffer group_;                   // 오른쪽에서 키가 같은 행들
+    size_t group_pos_;                  // 지금 왼쪽 행과 짝지을 다음 group_ 행
+    bool started_;
+    const std::vector<TKeyView> *left_row_;
+    const std::vector<TKeyView> *right_row_;
+    std::vector<TKeyView> row_;
+
+public:
+    MergeJoinCursor(std::unique_ptr<ResultCursor> left, std::unique_ptr<ResultCursor> right, int left_key,
+                    int right_key, Arena *arena = nullptr);
+
+    const std::vector<Attribute> &Schema() { return schema_; }
+    const std::vector<TKeyView> *Next();
+};
+
+/**
+ * @brief 입력 행을 모두 메모리에 복사해 key 속성 순서로 정렬한 커서 (인덱스가 없는 쪽의 sort-merge join 입력)
+ */
+std::unique_ptr<ResultCursor> SortByKey(std::unique_ptr<ResultCursor> input, int key, Arena *arena = nullptr);
+
+#endif
@@ -1,18 +1,76 @@
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
 #include <boost/algorithm/string.hpp>
+#include <pthread.h>
 #include <readline/history.h>
 #include <readline/readline.h>
 
+#include "config.h"
 #include "interpreter.h"
+#include "server.h"
 
 using namespace std;
 
+/**
+ * @brief --server [port]: 한 프로세스에서 여러 클라이언트 세션을 받음. SIGINT/SIGTERM을 받으면 세션을 끊고 checkpoint 후 종료
+ */
+int RunServer(int argc, const char *argv[]) {
+  // 신호는 전용 스레드가 sigwait로 받아 Stop을 부름 (worker 스레드는 신호를 막은 상태로 시작)
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  std::unique_ptr<API> core;
+  try {
+    core.reset(new API(Interpreter::DataPath()));
+  } catch (const std::runtime_error &e) {  // 열 수 없는 데이터 디렉토리 (읽기 전용인데 재생할 로그가 있음 등)
+    cerr << e.what() << endl;
+    return 1;
+  }
+  Config &config = Config::Instance();
+  int port = argc > 2 ? atoi(argv[2]) : static_cast<int>(config.server_port());
+  SessionServer server(core.get(), port, static_cast<size_t>(config.server_workers()));
+
+  thread waiter([&server, &signals] {
+    int sig;
+    sigwait(&signals, &sig);
+    server.Stop();
+  });
+  try {
+    server.Run();
+  } catch (const std::runtime_error &e) {
+    cerr << e.what() << endl;
+    server.Stop();
+    pthread_kill(waiter.native_handle(), SIGTERM);
+    waiter.join();
+    return 1;
+  }
+  pthread_kill(waiter.native_handle(), SIGTERM);  // Run이 먼저 끝났어도 waiter를 깨움
+  waiter.join();
+  return 0;
+}
+
 int main(int argc, const char *argv[]) {
+  if (argc > 1 && string(argv[1]) == "--server") {
+    return RunServer(argc, argv);
+  }
 
   string sql;
-  Interpreter itp;
+  std::unique_ptr<Interpreter> itp;
+  try {
+    itp.reset(new Interpreter());
+  } catch (const std::runtime_error &e) {
+    cerr << e.what() << endl;
+    return 1;
+  }
   char *line;
   size_t found;
 
@@ -25,7 +83,7 @@ int main(int argc, const char *argv[]) {
     boost::algorithm::trim(sql);
 
     if (sql.compare(0, 4, "exit") == 0 || sql.compare(0, 4, "quit") == 0) {
-      itp.ExecSQL("quit");
+      itp->ExecSQL("quit");
       break;
     }
     while ((found = sql.find(";")) == string::npos) {
@@ -37,9 +95,9 @@ int main(int argc, const char *argv[]) {
     if (sql.length() != 0) {
       add_history(sql.c_str());
     }
-    itp.ExecSQL(sql);
+    itp->ExecSQL(sql);
 
     std::cout << std::endl;
   }
   return 0;
-}
\ No newline at end of file
+}
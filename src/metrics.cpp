@@ -0,0 +1,112 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+
+const char *const COUNTER_NAMES[Metrics::COUNTER_COUNT] = {
+    "buffer hits", "buffer misses", "scan ring hits", "buffer evictions", "pages read", "pages written", "rows scanned", "rows filtered",
+};
+
+const char *const LATENCY_NAMES[Metrics::LATENCY_COUNT] = {
+    "parse", "execute", "page read",
+};
+
+/**
+ * @brief ns를 소수 한 자리 microseconds로 출력
+ */
+void PrintMicros(std::ostream &out, double ns) {
+    out << std::setw(12) << std::right << std::fixed << std::setprecision(1) << ns / 1000.0;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() : count_(0), sum_ns_(0), max_ns_(0) {
+    for (std::atomic<uint64_t> &bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t LatencyHistogram::Percentile(double p) const {
+    uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p * total + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < METRIC_HISTOGRAM_BUCKETS; i++) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min<uint64_t>(max_ns(), (uint64_t(2) << i) - 1);
+        }
+    }
+    return max_ns();
+}
+
+Metrics::Snapshot Metrics::Snapshot::operator-(const Snapshot &other) const {
+    Snapshot diff;
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        diff.counters[i] = counters[i] - other.counters[i];
+    }
+    return diff;
+}
+
+Metrics::Metrics() {
+    for (PaddedCounter &counter : counters_) {
+        counter.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+Metrics &Metrics::Instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+Metrics::Snapshot Metrics::Take() const {
+    Snapshot snapshot;
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        snapshot.counters[i] = Get(static_cast<Counter>(i));
+    }
+    return snapshot;
+}
+
+void Metrics::PrintCounters(const Snapshot &snapshot, std::ostream &out) {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        out << "\t" << std::setw(20) << std::left << COUNTER_NAMES[i] << snapshot.counters[i] << std::endl;
+    }
+    uint64_t lookups = snapshot[BUFFER_HITS] + snapshot[BUFFER_MISSES];
+    out << "\t" << std::setw(20) << std::left << "buffer hit ratio";
+    if (lookups == 0) {
+        out << "-" << std::endl;
+    } else {
+        out << std::fixed << std::setprecision(2) << 100.0 * snapshot[BUFFER_HITS] / lookups << "%" << std::endl;
+    }
+    out.flags(flags);   // 뒤에 출력하는 FLOAT 값의 형식을 바꾸지 않음
+    out.precision(precision);
+}
+
+void Metrics::PrintLatencies(std::ostream &out) const {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << "\t" << std::setw(12) << std::left << "(us)" << std::setw(12) << std::right << "count";
+    for (const char *column : {"avg", "p50", "p95", "p99", "max"}) {
+        out << std::setw(12) << std::right << column;
+    }
+    out << std::endl;
+    for (int i = 0; i < LATENCY_COUNT; i++) {
+        const LatencyHistogram &histogram = latencies_[i];
+        uint64_t count = histogram.count();
+        out << "\t" << std::setw(12) << std::left << LATENCY_NAMES[i] << std::setw(12) << std::right << count;
+        PrintMicros(out, count == 0 ? 0.0 : static_cast<double>(histogram.sum_ns()) / count);
+        PrintMicros(out, histogram.Percentile(0.50));
+        PrintMicros(out, histogram.Percentile(0.95));
+        PrintMicros(out, histogram.Percentile(0.99));
+        PrintMicros(out, histogram.max_ns());
+        out << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,142 @@
+#ifndef ABCDB_METRICS_H_
+#define ABCDB_METRICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#define METRIC_HISTOGRAM_BUCKETS 40     // bucket i는 [2^i, 2^(i+1)) ns, 마지막 bucket은 그 이상 모두
+
+/**
+ * @brief 지연 시간 분포. bucket 경계가 2의 거듭제곱인 히스토그램
+ * @details Record는 relaxed atomic 더하기 몇 번뿐이라 여러 스레드가 잠금 없이 부른다.
+ *          백분위는 값이 든 bucket의 위 경계로 어림한다 (최대 두 배 오차, max를 넘지 않음).
+ */
+class LatencyHistogram {
+private:
+    std::atomic<uint64_t> buckets_[METRIC_HISTOGRAM_BUCKETS];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_ns_;
+    std::atomic<uint64_t> max_ns_;
+
+public:
+    LatencyHistogram();
+
+    void Record(uint64_t ns) {
+        size_t bucket = ns < 2 ? 0 : 63 - __builtin_clzll(ns);
+        if (bucket >= METRIC_HISTOGRAM_BUCKETS) {
+            bucket = METRIC_HISTOGRAM_BUCKETS - 1;
+        }
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t max = max_ns_.load(std::memory_order_relaxed);
+        while (ns > max && !max_ns_.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum_ns() const { return sum_ns_.load(std::memory_order_relaxed); }
+    uint64_t max_ns() const { return max_ns_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 기록된 값 중 비율 p (0 ~ 1) 위치의 값 (ns, bucket 위 경계로 어림)
+     */
+    uint64_t Percentile(double p) const;
+};
+
+/**
+ * @brief 프로세스 전체의 실행 통계 (모든 세션이 공유)
+ * @details 버퍼 풀 hit/miss/교체, scan ring hit, 파일 페이지 읽기/쓰기, 스캔한 행과 조건으로 걸러진 행 수를 세고,
+ *          파싱·실행·페이지 읽기 시간은 LatencyHistogram에 담는다. 카운터는 서로 다른 cache line에 두어
+ *          병렬 스캔 worker들이 같은 line을 두고 다투지 않게 하며, 스캔은 페이지 단위로 한 번씩만 더한다.
+ *          SHOW STATS가 전체를, EXPLAIN ANALYZE가 질의 하나 동안의 차이를 보여준다.
+ */
+class Metrics {
+public:
+    enum Counter {
+        BUFFER_HITS,        // 버퍼 풀에서 찾은 페이지
+        BUFFER_MISSES,      // 버퍼 풀에도 scan ring에도 없어 파일에서 읽은 페이지
+        SCAN_RING_HITS,     // 버퍼 풀에는 없지만 scan ring 프레임에 읽어 둔 페이지 (hit ratio에 넣지 않음)
+        BUFFER_EVICTIONS,   // 새 페이지 자리를 위해 내보낸 프레임
+        PAGES_READ,         // 파일에서 읽은 페이지 (pread, mmap으로 본 페이지)
+        PAGES_WRITTEN,      // 파일에 쓴 페이지
+        ROWS_SCANNED,       // 스캔이 조건을 검사한 행
+        ROWS_FILTERED,      // 그 중 조건을 만족하지 않아 버린 행
+        COUNTER_COUNT
+    };
+
+    enum Latency {
+        PARSE_TIME,         // 파싱 (parse cache hit 제외)
+        EXECUTE_TIME,       // 문장 실행 (결과 출력 포함)
+        PAGE_READ_TIME,     // 파일에서 페이지 하나 읽기
+        LATENCY_COUNT
+    };
+
+    /**
+     * @brief 어느 순간의 카운터 값. 두 Snapshot의 차이가 그 사이의 작업량
+     */
+    struct Snapshot {
+        uint64_t counters[COUNTER_COUNT];
+
+        uint64_t operator[](Counter counter) const { return counters[counter]; }
+        Snapshot operator-(const Snapshot &other) const;
+    };
+
+private:
+    struct alignas(64) PaddedCounter {
+        std::atomic<uint64_t> value;
+    };
+
+    PaddedCounter counters_[COUNTER_COUNT];
+    LatencyHistogram latencies_[LATENCY_COUNT];
+
+    Metrics();
+
+public:
+    static Metrics &Instance();
+
+    void Add(Counter counter, uint64_t n = 1) {
+        counters_[counter].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void Record(Latency latency, uint64_t ns) { latencies_[latency].Record(ns); }
+
+    uint64_t Get(Counter counter) const { return counters_[counter].value.load(std::memory_order_relaxed); }
+    const LatencyHistogram &latency(Latency latency) const { return latencies_[latency]; }
+    Snapshot Take() const;
+
+    /**
+     * @brief 카운터 (버퍼 hit ratio 포함)를 출력
+     */
+    static void PrintCounters(const Snapshot &snapshot, std::ostream &out);
+
+    /**
+     * @brief 지연 시간 히스토그램을 count, avg, p50, p95, p99, max (microseconds) 표로 출력
+     */
+    void PrintLatencies(std::ostream &out) const;
+};
+
+/**
+ * @brief 만들어진 때부터 소멸할 때까지의 시간을 Metrics에 기록
+ */
+class LatencyTimer {
+private:
+    Metrics::Latency latency_;
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    explicit LatencyTimer(Metrics::Latency latency) : latency_(latency), start_(std::chrono::steady_clock::now()) {}
+    LatencyTimer(const LatencyTimer &) = delete;
+    LatencyTimer &operator=(const LatencyTimer &) = delete;
+
+    ~LatencyTimer() { Metrics::Instance().Record(latency_, ElapsedNs()); }
+
+    uint64_t ElapsedNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+    }
+};
+
+#endif
@@ -1,5 +1,7 @@
 #include "page.h"
 
+#include <algorithm>
+
 /*=======================================Slot================================================ */
 void Slot::SetRecordInfo(size_t offset, size_t length) {
     offset_ = offset;
@@ -29,7 +31,206 @@ void Slot:: Clear() {
 };
 
 /*=======================================Page================================================ */
+void Page::WriteHeader() {
+    if (data_size_ < HEADER_SIZE) {
+        return;
+    }
+    PageHeader header;
+    header.magic = PAGE_MAGIC;
+    header.dir_idx = dir_idx_;
+    header.page_idx = page_idx_;
+    header.record_offset = record_offset_;
+    header.slot_offset = slot_offset_;
+    header.layout = layout_;
+    header.lsn = lsn_;
+    header.row_count = row_count_;
+    header.row_capacity = row_capacity_;
+    header.column_count = static_cast<int32_t>(columns_.size());
+    header.zone_column_count = static_cast<int32_t>(zone_columns_.size());
+    std::memset(header.zone_columns, 0, sizeof(header.zone_columns));
+    if (!zone_columns_.empty()) {   // 비어 있으면 data()가 null일 수 있음
+        std::memcpy(header.zone_columns, zone_columns_.data(), zone_columns_.size() * sizeof(ZoneColumn));
+    }
+    header.zone = zone_;
+    std::memcpy(data_, &header, sizeof(PageHeader));
+}
+
+bool Page::ReadHeader() {
+    if (data_size_ < HEADER_SIZE) {
+        return false;
+    }
+    PageHeader header;
+    std::memcpy(&header, data_, sizeof(PageHeader));
+    if (header.magic != PAGE_MAGIC || header.slot_offset < HEADER_SIZE ||
+        header.record_offset > static_cast<int>(data_size_) || header.slot_offset > header.record_offset) {
+        return false;
+    }
+    dir_idx_ = header.dir_idx;
+    page_idx_ = header.page_idx;
+    record_offset_ = header.record_offset;
+    slot_offset_ = header.slot_offset;
+    lsn_ = header.lsn;
+    layout_ = header.layout;
+    columns_.clear();
+    row_count_ = 0;
+    row_capacity_ = 0;
+    row_length_ = 0;
+    if (layout_ == PAGE_LAYOUT_PAX) {
+        if (!ReadPaxColumns(header)) {
+            return false;
+        }
+    } else if (layout_ != PAGE_LAYOUT_SLOTTED) {
+        return false;
+    }
+    if (!ReadZoneColumns(header)) {
+        return false;
+    }
+    SetFreeSpace();
+    return true;
+}
+
+bool Page::ReadZoneColumns(const PageHeader& header) {
+    zone_columns_.clear();
+    zone_ = ZoneBounds();
+    if (header.zone_column_count < 0 || header.zone_column_count > ZONE_MAP_COLUMNS ||
+        (header.zone.count != 0 && header.zone.count != header.zone_column_count)) {
+        return false;
+    }
+    for (int i = 0; i < header.zone_column_count; i++) {
+        const ZoneColumn& column = header.zone_columns[i];
+        if (column.offset < 0 || (column.data_type != T_INT && column.data_type != T_FLOAT)) {
+            zone_columns_.clear();
+            return false;
+        }
+        zone_columns_.push_back(column);
+    }
+    zone_ = header.zone;
+    return true;
+}
+
+void Page::ApplyFormat(const PageFormat& format) {
+    if (!format.pax_columns.empty()) {
+        FormatPax(format.pax_columns);
+    }
+    SetZoneColumns(format.zone_columns);
+}
+
+bool Page::SetZoneColumns(const std::vector<ZoneColumn>& columns) {
+    if (GetSlotCount() != 0) {
+        return false;
+    }
+    zone_columns_.assign(columns.begin(), columns.begin() + std::min<size_t>(columns.size(), ZONE_MAP_COLUMNS));
+    zone_ = ZoneBounds();
+    WriteHeader();
+    return true;
+}
+
+void Page::ExtendZone(const char* record, int record_size) {
+    bool first = zone_.count == 0;
+    for (size_t i = 0; i < zone_columns_.size(); i++) {
+        const ZoneColumn& column = zone_columns_[i];
+        if (column.offset + static_cast<int>(sizeof(uint32_t)) > record_size) {
+            DropZone();
+            return;
+        }
+        uint32_t raw;
+        std::memcpy(&raw, record + column.offset, sizeof(raw));
+        bool below, above;
+        if (column.data_type == T_INT) {
+            int32_t v, lo, hi;
+            std::memcpy(&v, &raw, 4);
+            std::memcpy(&lo, &zone_.min[i], 4);
+            std::memcpy(&hi, &zone_.max[i], 4);
+            below = v < lo;
+            above = v > hi;
+        } else {
+            float v, lo, hi;
+            std::memcpy(&v, &raw, 4);
+            if (v != v) {
+                DropZone();     // NaN은 범위로 나타낼 수 없음
+                return;
+            }
+            std::memcpy(&lo, &zone_.min[i], 4);
+            std::memcpy(&hi, &zone_.max[i], 4);
+            below = v < lo;
+            above = v > hi;
+        }
+        if (first || below) zone_.min[i] = raw;
+        if (first || above) zone_.max[i] = raw;
+    }
+    zone_.count = static_cast<int32_t>(zone_columns_.size());
+}
+
+void Page::DropZone() {
+    zone_columns_.clear();
+    zone_ = ZoneBounds();
+}
+
+bool Page::ReadPaxColumns(const PageHeader& header) {
+    int size = static_cast<int>(data_size_);
+    if (header.column_count <= 0 ||
+        header.column_count > (size - HEADER_SIZE) / static_cast<int>(sizeof(PaxColumn)) ||
+        header.row_capacity < 0 || header.row_count < 0 || header.row_count > header.row_capacity) {
+        return false;
+    }
+    int dir_end = HEADER_SIZE + header.column_count * static_cast<int>(sizeof(PaxColumn));
+    columns_.resize(header.column_count);
+    std::memcpy(columns_.data(), &data_[HEADER_SIZE], columns_.size() * sizeof(PaxColumn));
+    for (const PaxColumn& column : columns_) {
+        if (column.width <= 0 || column.offset < dir_end ||
+            static_cast<int64_t>(column.offset) + static_cast<int64_t>(column.width) * header.row_capacity > size) {
+            columns_.clear();
+            return false;
+        }
+        row_length_ += column.width;
+    }
+    row_count_ = header.row_count;
+    row_capacity_ = header.row_capacity;
+    return true;
+}
+
+bool Page::FormatPax(const std::vector<int>& widths) {
+    if (GetSlotCount() != 0 || widths.empty()) {
+        return false;
+    }
+    int size = static_cast<int>(data_size_);
+    int count = static_cast<int>(widths.size());
+    int dir_end = HEADER_SIZE + count * static_cast<int>(sizeof(PaxColumn));
+    int row_length = 0;
+    for (int width : widths) {
+        if (width <= 0) {
+            return false;
+        }
+        row_length += width;
+    }
+    // minipage마다 정렬 때문에 최대 7바이트가 빔
+    int capacity = (size - AlignColumn(dir_end) - 7 * count) / row_length;
+    if (capacity <= 0) {
+        return false;
+    }
+
+    std::vector<PaxColumn> columns(count);
+    int offset = AlignColumn(dir_end);
+    for (int i = 0; i < count; i++) {
+        columns[i].offset = offset;
+        columns[i].width = widths[i];
+        offset = AlignColumn(offset + capacity * widths[i]);
+    }
+    columns_ = std::move(columns);
+    std::memcpy(&data_[HEADER_SIZE], columns_.data(), columns_.size() * sizeof(PaxColumn));
+    layout_ = PAGE_LAYOUT_PAX;
+    row_count_ = 0;
+    row_capacity_ = capacity;
+    row_length_ = row_length;
+    SetFreeSpace();
+    WriteHeader();
+    return true;
+}
+
 bool Page::HasEnoughSpace(int record_size) const {
+    if (IsPax()) {
+        return record_size == row_length_ && row_count_ < row_capacity_;
+    }
     return slot_offset_ + static_cast<int>(sizeof(Slot)) <= record_offset_ - record_size;
 };
 
@@ -38,6 +239,17 @@ bool Page::InsertRecord(const char* record, int record_size) {
             std::cerr<< "페이지에 남은 공간이 부족합니다."<<std::endl;
             return false;
     }
+    ExtendZone(record, record_size);
+    if (IsPax()) {
+        for (const PaxColumn& column : columns_) {
+            std::memcpy(&data_[column.offset + row_count_ * column.width], record, column.width);
+            record += column.width;
+        }
+        row_count_++;
+        SetFreeSpace();
+        WriteHeader();
+        return true;
+    }
 
     record_offset_ -= record_size;
     std::memcpy(&data_[record_offset_], record, record_size);
@@ -46,26 +258,74 @@ bool Page::InsertRecord(const char* record, int record_size) {
     std::memcpy(&data_[slot_offset_], &new_slot, sizeof(Slot));
     slot_offset_ += sizeof(Slot);
     SetFreeSpace();
+    WriteHeader();
     return true;
 };
 
 // 특정 인덱스에서 가변 길이 레코드를 읽는 함수
 std::string Page::ReadRecordFromOffset(int offset, int length) const {
-    if (offset < 0 || static_cast<std::vector<char>::size_type>(offset + length) > data_.size()) {
+    if (offset < 0 || static_cast<size_t>(offset + length) > data_size_) {
             throw std::out_of_range("잘못된 오프셋 또는 길이");
         }
-        return std::string(data_.begin() + offset, data_.begin() + offset + length);
+        return std::string(data_ + offset, data_ + offset + length);
 };
 bool Page::IsDirty() const{
     return dirty_;
 }
 
 bool Page::IsPinned() const{
-    return pinned_;
+    return pin_count_.load(std::memory_order_acquire) > 0;
+}
+
+void RecordIterator::Settle() {
+    while (slot_pos_ < slot_end_) {
+        Slot slot;
+        std::memcpy(&slot, data_ + slot_pos_, sizeof(Slot));
+        if (!slot.IsDeleted()) {
+            current_.data = data_ + slot.GetOffset();
+            current_.length = slot.GetLength();
+            current_.slot_no = (slot_pos_ - HEADER_SIZE) / static_cast<int>(sizeof(Slot));
+            return;
+        }
+        slot_pos_ += sizeof(Slot);
+    }
+}
+
+bool Page::GetRecord(int slot_no, RecordRef* record) const {
+    if (IsPax() || slot_no < 0 || slot_no >= GetSlotCount()) {
+        return false;
+    }
+    Slot slot;
+    std::memcpy(&slot, &data_[HEADER_SIZE + slot_no * sizeof(Slot)], sizeof(Slot));
+    if (slot.IsDeleted()) {
+        return false;
+    }
+    record->data = data_ + slot.GetOffset();
+    record->length = slot.GetLength();
+    record->slot_no = slot_no;
+    return true;
+}
+
+bool Page::CopyRecord(int row, char* out) const {
+    if (!IsPax() || row < 0 || row >= row_count_) {
+        return false;
+    }
+    for (const PaxColumn& column : columns_) {
+        std::memcpy(out, &data_[column.offset + row * column.width], column.width);
+        out += column.width;
+    }
+    return true;
 }
 
 const std::vector<char> Page::GetData() const{
-    return data_;
+    return std::vector<char>(data_, data_ + data_size_);
+}
+
+bool Page::AttachImage(const char* image) {
+    buffer_.clear();
+    data_ = const_cast<char*>(image);   // 읽기만 하므로 WriteHeader를 부르는 함수는 쓰지 않음
+    data_size_ = Config::Instance().page_size();
+    return ReadHeader();
 }
 
 int Page::GetPageIdx() const{
@@ -76,25 +336,27 @@ int Page::GetAge() const{
     return age_;
 }
 
-int Page::GetFreeSpace(){
+int Page::GetFreeSpace() const{
    return free_space_;
 }
 
 void Page::SetFreeSpace() {
+    if (IsPax()) {
+        free_space_ = (row_capacity_ - row_count_) * row_length_;
+        return;
+    }
     free_space_ = record_offset_ - slot_offset_;
 }
 
 void Page::SetPageIdx(const int index){
     page_idx_=index;
+    WriteHeader();
 }
 
 void Page::SetDirty(const bool dirty){
     dirty_=dirty;
 }
 
-void Page::SetPinned(const bool pinned){
-    pinned_=pinned;
-}
 
 // void Page::PrintRecord() const{
 //     int current_slot_offset = HEADER_SIZE;
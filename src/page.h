@@ -1,17 +1,80 @@
 #ifndef ABCDB_PAGE_H_
 #define ABCDB_PAGE_H_
 
-#include <boost/archive/binary_iarchive.hpp>
-#include <boost/archive/binary_oarchive.hpp>
-#include <boost/serialization/utility.hpp>
-#include <boost/serialization/vector.hpp>
-#include <boost/filesystem.hpp>
+#include <atomic>
+#include <cstdint>
 #include <cstring> 
-#include <fstream> 
 #include <iostream>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "commons.h"
+#include "config.h"
 
-#define PAGE_SIZE (4 * 1024)
 #define HEADER_SIZE  128
+#define PAGE_MAGIC 0x50434241  // "ABCP"
+
+#define PAGE_LAYOUT_SLOTTED 0   // 행 단위 slotted page (기본값)
+#define PAGE_LAYOUT_PAX 1       // 속성마다 minipage를 두는 PAX page
+
+#define ZONE_MAP_COLUMNS 4      // zone map에 범위를 기록하는 최대 속성 수
+
+/**
+ * @brief zone map에 범위를 기록하는 INT/FLOAT 속성 하나
+ */
+struct ZoneColumn {
+    int32_t offset;         // 레코드 안에서 값의 위치
+    int32_t data_type;      // T_INT, T_FLOAT
+};
+
+/**
+ * @brief 페이지에 있는 행들의 속성별 최솟값·최댓값 (zone map). 값은 data_type의 4바이트 그대로 담음
+ * @details 페이지 헤더와 PageDirectoryEntry에 같은 내용이 기록되므로 스캔은 페이지를 읽지 않고 범위를 볼 수 있다.
+ */
+struct ZoneBounds {
+    int32_t count;                      // 범위가 있는 속성 수. 0이면 모름 (빈 페이지, zone map을 쓰지 않는 파일)
+    uint32_t min[ZONE_MAP_COLUMNS];
+    uint32_t max[ZONE_MAP_COLUMNS];
+};
+
+/**
+ * @brief 새 페이지를 만들 때 정하는 형식 (Table::GetPageFormat)
+ */
+struct PageFormat {
+    std::vector<int> pax_columns;           // 비어 있지 않으면 이 폭의 minipage로 나눈 PAX 페이지
+    std::vector<ZoneColumn> zone_columns;   // 최솟값·최댓값을 기록할 속성 (최대 ZONE_MAP_COLUMNS개)
+};
+
+/**
+ * @brief 디스크에 기록되는 페이지 헤더. 페이지 data_의 앞 HEADER_SIZE 바이트에 위치
+ * 
+ */
+struct PageHeader {
+    uint32_t magic;
+    int32_t dir_idx;        // 페이지가 속한 페이지디렉터리의 index
+    int32_t page_idx;       // 페이지 디렉터리내의 index
+    int32_t record_offset;  // 데이터가 추가될 위치
+    int32_t slot_offset;    // 슬롯이 추가될 위치
+    int32_t layout;         // PAGE_LAYOUT_SLOTTED, PAGE_LAYOUT_PAX (예전 페이지는 0)
+    uint64_t lsn;           // 이 페이지를 마지막으로 바꾼 WAL 레코드의 LSN (0이면 로그 없음)
+    int32_t row_count;      // PAX: 저장된 행 수
+    int32_t row_capacity;   // PAX: 들어갈 수 있는 행 수
+    int32_t column_count;   // PAX: minipage 수
+    int32_t zone_column_count;
+    ZoneColumn zone_columns[ZONE_MAP_COLUMNS];
+    ZoneBounds zone;
+};
+static_assert(sizeof(PageHeader) <= HEADER_SIZE, "PageHeader must fit in HEADER_SIZE");
+
+/**
+ * @brief PAX 페이지의 minipage 하나. 헤더 바로 뒤에 column_count개가 차례로 기록됨
+ * 
+ */
+struct PaxColumn {
+    int32_t offset;         // minipage 시작 위치 (8바이트 정렬)
+    int32_t width;          // 값 하나의 길이. 행 i의 값은 offset + i * width
+};
 
 /**
  * @brief Page내부에서 Record를 관리하는 Slot
@@ -22,12 +85,6 @@ class Slot {
         size_t offset_;  // 페이지 내의 레코드 시작 위치 (바이트 단위)
         size_t length_;  // 저장된 레코드의 길이
         bool is_del_;   // 레코드 삭제여부
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & offset_;
-            ar & length_;
-            ar & is_del_;
-        }
     public:
         Slot() : offset_(0), length_(0), is_del_(false) {}
         Slot(size_t offset, size_t length) : offset_(offset), length_(length), is_del_(false) {}
@@ -67,28 +124,89 @@ class Slot {
         void Clear();
 };
 
+/**
+ * @brief 페이지 프레임 안의 레코드를 가리키는 view. 복사하지 않으며 페이지가 버퍼 풀에 고정되어 있는 동안만 유효
+ * 
+ */
+struct RecordRef {
+    const char* data;   // 레코드 시작 위치 (페이지 data_ 내부)
+    size_t length;      // 레코드 길이
+    int slot_no;        // 슬롯 번호 (레코드 id의 일부)
+};
+
+/**
+ * @brief 페이지의 슬롯을 순서대로 따라가며 삭제되지 않은 레코드의 RecordRef를 돌려주는 iterator
+ * 
+ */
+class RecordIterator {
+    private:
+        const char* data_;  // 페이지 이미지
+        int slot_pos_;      // 현재 슬롯 위치
+        int slot_end_;      // 슬롯 영역의 끝 (Page::slot_offset_)
+        RecordRef current_;
+
+        /**
+         * @brief 현재 위치부터 삭제되지 않은 첫 슬롯을 찾아 current_를 채움
+         */
+        void Settle();
+
+    public:
+        RecordIterator(const char* data, int slot_pos, int slot_end)
+        :data_(data), slot_pos_(slot_pos), slot_end_(slot_end), current_{nullptr, 0, -1} {Settle();}
+
+        const RecordRef& operator*() const {return current_;}
+        const RecordRef* operator->() const {return &current_;}
+        RecordIterator& operator++() {slot_pos_ += sizeof(Slot); Settle(); return *this;}
+        bool operator!=(const RecordIterator& other) const {return slot_pos_ != other.slot_pos_;}
+        bool operator==(const RecordIterator& other) const {return slot_pos_ == other.slot_pos_;}
+};
+
+/**
+ * @brief range-based for 용 레코드 범위. for (const RecordRef& rec : page->Records())
+ * 
+ */
+class RecordRange {
+    private:
+        const char* data_;
+        int slot_end_;
+    public:
+        RecordRange(const char* data, int slot_end) :data_(data), slot_end_(slot_end) {}
+        RecordIterator begin() const {return RecordIterator(data_, HEADER_SIZE, slot_end_);}
+        RecordIterator end() const {return RecordIterator(data_, slot_end_, slot_end_);}
+};
+
 /**
  * @brief 실질적인 Record를 관리하는 Page
+ * @details 페이지 크기는 Config::page_size()로 시작할 때 정해진다.
+ *          data_는 디스크 이미지 그대로이며, 헤더 필드가 바뀔 때마다 data_ 앞의 PageHeader도 갱신되므로
+ *          File은 data_를 그대로 한 번에 읽고 쓴다.
+ *
+ *          FormatPax로 만든 PAX 페이지는 고정 길이 행을 속성별 minipage에 나눠 저장한다. 같은 속성의 값이 연속되므로
+ *          스캔은 조건에 쓰인 속성의 minipage만 읽는다. 행 번호가 레코드 id의 slot 번호이며, 레코드가 연속된
+ *          바이트가 아니므로 Records()/GetRecord() 대신 GetColumn()/CopyRecord()로 읽는다.
  * 
  */
 class Page {
     private:
-        friend class boost::serialization::access;
-        template<class Archive>
-        void serialize(Archive& ar, const unsigned int version) {
-            ar & file_;
-            ar & age_;
-            ar & dir_idx_;
-            ar & page_idx_;
-            ar & record_offset_;
-            ar & slot_offset_;
-            ar & free_space_;
-            ar & dirty_;
-            ar & pinned_;
-            ar & data_;
-            ar & filename_;
-        }
-        
+        /**
+         * @brief 헤더 필드를 data_ 앞의 PageHeader에 기록
+         */
+        void WriteHeader();
+
+        /**
+         * @brief PAX 페이지 헤더 뒤의 minipage 목록을 읽고 범위를 확인
+         */
+        bool ReadPaxColumns(const PageHeader& header);
+        bool ReadZoneColumns(const PageHeader& header);
+
+        /**
+         * @brief 새 레코드의 값으로 zone_ 범위를 넓힘. 범위로 나타낼 수 없는 값이면 이 페이지의 zone map을 버림
+         */
+        void ExtendZone(const char* record, int record_size);
+        void DropZone();
+
+        static int AlignColumn(int offset) {return (offset + 7) & ~7;}
+
         // 페이지 헤더
         std::string file_;
         long age_;          
@@ -97,21 +215,35 @@ class Page {
         int record_offset_;                 // 데이터가 추가될 위치
         int slot_offset_;                   // 슬롯이 추가될 위치
         int free_space_;
-        bool dirty_;                        // 페이지 변경 여부   
-        bool pinned_;                       // 페이지 고정 여부
+        int layout_;                        // PAGE_LAYOUT_SLOTTED, PAGE_LAYOUT_PAX
+        int row_count_;                     // PAX: 저장된 행 수
+        int row_capacity_;                  // PAX: 들어갈 수 있는 행 수
+        int row_length_;                    // PAX: 행 길이 (minipage 폭의 합)
+        std::vector<PaxColumn> columns_;    // PAX: minipage 목록
+        std::vector<ZoneColumn> zone_columns_;  // zone map을 기록하는 속성
+        ZoneBounds zone_;                   // 저장된 행들의 zone_columns_별 범위
+        std::atomic<bool> dirty_;           // 페이지 변경 여부   
+        std::atomic<int> pin_count_;        // 페이지를 고정한 사용자 수
+        mutable std::shared_mutex latch_;   // 페이지 내용 reader/writer latch
+        uint64_t lsn_;                      // 페이지를 마지막으로 바꾼 WAL 레코드의 LSN
         std::shared_ptr<Page> next_;        // 다음 페이지
         std::shared_ptr<Page> prev_;        // 이전 페이지
         std::string filename_;              // 파일 이름
         // 데이터
-        std::vector<char> data_;            // 레코드
+        std::vector<char> buffer_;          // 페이지가 가진 이미지 (AttachImage로 바깥 이미지를 가리키면 비어 있음)
+        char* data_;                        // 페이지 이미지 (buffer_ 또는 mmap한 파일 블록)
+        size_t data_size_;
 
     public:
-        Page(const std::string& filename, int dir_idx) :file_(filename), age_(-1), dir_idx_(dir_idx), page_idx_(-1), record_offset_(PAGE_SIZE), slot_offset_(HEADER_SIZE), dirty_(false), pinned_(false) {
-            data_.resize(PAGE_SIZE);
+        Page(const std::string& filename, int dir_idx) :file_(filename), age_(-1), dir_idx_(dir_idx), page_idx_(-1), record_offset_(static_cast<int>(Config::Instance().page_size())), slot_offset_(HEADER_SIZE), layout_(PAGE_LAYOUT_SLOTTED), row_count_(0), row_capacity_(0), row_length_(0), zone_(), dirty_(false), pin_count_(0), lsn_(0) {
+            buffer_.resize(Config::Instance().page_size());
+            data_ = buffer_.data();
+            data_size_ = buffer_.size();
             SetFreeSpace();
+            WriteHeader();
         }
         Page()
-        :page_idx_(-1)
+        :page_idx_(-1), layout_(PAGE_LAYOUT_SLOTTED), row_count_(0), row_capacity_(0), row_length_(0), zone_(), dirty_(false), pin_count_(0), lsn_(0), data_(nullptr), data_size_(0)
         {
         }
 
@@ -132,7 +264,34 @@ class Page {
         bool HasEnoughSpace(int record_size) const;
         
         /**
-         * @brief 빈 슬롯에 데이터 저장 (페이지 끝에서부터 채워짐)
+         * @brief 빈 페이지를 PAX 형식으로 바꿈. 들어갈 행 수는 페이지 크기와 폭의 합으로 정해짐
+         * 
+         * @param widths 속성별 값 길이 (레코드 안의 속성 순서)
+         * @return false 이미 레코드가 있거나 한 행도 들어가지 않음
+         */
+        bool FormatPax(const std::vector<int>& widths);
+
+        bool IsPax() const {return layout_ == PAGE_LAYOUT_PAX;}
+
+        /**
+         * @brief 빈 페이지에 형식을 적용 (PAX minipage, zone map 속성)
+         */
+        void ApplyFormat(const PageFormat& format);
+
+        /**
+         * @brief 빈 페이지에서 InsertRecord마다 최솟값·최댓값을 기록할 속성을 정함
+         * 
+         * @return false 이미 레코드가 있음
+         */
+        bool SetZoneColumns(const std::vector<ZoneColumn>& columns);
+
+        /**
+         * @brief 저장된 행들의 zone map. File이 PageDirectoryEntry에 옮겨 적음
+         */
+        const ZoneBounds& GetZone() const {return zone_;}
+
+        /**
+         * @brief 빈 슬롯에 데이터 저장 (페이지 끝에서부터 채워짐). PAX 페이지는 행을 minipage마다 나눠 씀
          * 
          * @param record 새롭게 저장할 Record
          * @param record_size 새롭게 저장할 Record의 크기
@@ -163,12 +322,72 @@ class Page {
          */
         const std::vector<char> GetData() const;
 
+        /**
+         * @brief 페이지의 레코드를 복사 없이 순회하는 범위
+         * @details 반환된 RecordRef는 페이지 data_를 가리키므로 순회하는 동안 페이지를 고정(Pin)해야 함
+         * 
+         * @return RecordRange 
+         */
+        RecordRange Records() const {return RecordRange(data_, slot_offset_);}
+
+        /**
+         * @brief 슬롯 번호로 레코드 하나를 가리키는 view
+         * 
+         * @param slot_no 슬롯 번호
+         * @param record 찾은 레코드
+         * @return false 슬롯이 없거나 삭제된 레코드 (PAX 페이지는 항상 false)
+         */
+        bool GetRecord(int slot_no, RecordRef* record) const;
+
+        /**
+         * @brief PAX 페이지의 행 하나를 레코드 형식(속성 순서대로 이어 붙임)으로 복사
+         * 
+         * @param out 행 길이(minipage 폭의 합) 바이트 이상
+         * @return false 없는 행
+         */
+        bool CopyRecord(int row, char* out) const;
+
+        /**
+         * @brief PAX 페이지의 minipage. 행 i의 값은 GetColumn(col) + i * GetColumnWidth(col)
+         */
+        int GetColumnCount() const {return static_cast<int>(columns_.size());}
+        const char *GetColumn(int col) const {return data_ + columns_[col].offset;}
+        int GetColumnWidth(int col) const {return columns_[col].width;}
+
+        /**
+         * @brief 슬롯 수 (삭제된 레코드 포함). PAX 페이지는 행 수
+         */
+        int GetSlotCount() const {return IsPax() ? row_count_ : (slot_offset_ - HEADER_SIZE) / static_cast<int>(sizeof(Slot));}
+
+        /**
+         * @brief 디스크 I/O용 페이지 이미지 (page_size 바이트)
+         */
+        char *GetRawData() {return data_;}
+        const char *GetRawData() const {return data_;}
+
+        /**
+         * @brief 디스크에서 읽은 data_의 PageHeader로 헤더 필드를 복원
+         * 
+         * @return true 올바른 페이지
+         * @return false 페이지 magic이 맞지 않음
+         */
+        bool ReadHeader();
+
+        /**
+         * @brief 페이지 이미지를 복사하지 않고 image(page_size 바이트)를 가리키게 한 뒤 헤더를 읽음
+         * @details mmap한 테이블 파일을 스캔할 때 쓴다. image는 읽기 전용이므로 이 페이지는 읽기만 해야 하며,
+         *          image가 유효한 동안만 쓸 수 있다. 다른 블록을 가리키려면 다시 부르면 된다.
+         *
+         * @return false 올바른 페이지가 아님
+         */
+        bool AttachImage(const char* image);
+
         /**
          * @brief Get the Free Space object
          * 
          * @return int 
          */
-        int GetFreeSpace();
+        int GetFreeSpace() const;
         
         /**
          * @brief Get the Page Idx object
@@ -177,6 +396,20 @@ class Page {
          */
         int GetPageIdx() const;
 
+        /**
+         * @brief Get the Dir Idx object
+         * 
+         * @return int Page가 속한 PageDirectory의 인덱스
+         */
+        int GetDirIdx() const {return dir_idx_;}
+
+        /**
+         * @brief Set the Dir Idx object
+         * 
+         * @param index Page가 속한 PageDirectory의 인덱스
+         */
+        void SetDirIdx(const int index) {dir_idx_ = index; WriteHeader();}
+
         /**
          * @brief Set the Page Idx object
          * 
@@ -184,6 +417,12 @@ class Page {
          */
         void SetPageIdx(const int index);
 
+        /**
+         * @brief 페이지를 마지막으로 바꾼 WAL 레코드의 LSN. 복구할 때 이미 반영된 레코드를 건너뛰는 데 씀
+         */
+        uint64_t GetLsn() const {return lsn_;}
+        void SetLsn(uint64_t lsn) {lsn_ = lsn; WriteHeader();}
+
         /**
          * @brief 페이지 변경 여부 확인
          * 
@@ -195,11 +434,23 @@ class Page {
         /**
          * @brief 페이지 고정 여부 확인
          * 
-         * @return true 고정됨
+         * @return true 한 명 이상이 고정함 (교체 대상에서 빠짐)
          * @return false 고정되지 않음
          */
         bool IsPinned() const;
 
+        /**
+         * @brief 고정 횟수를 늘리고 줄임. 여러 세션이 같은 프레임을 동시에 고정할 수 있으므로 Pin마다 Unpin을 한 번 불러야 함
+         */
+        void Pin() {pin_count_.fetch_add(1, std::memory_order_acq_rel);}
+        void Unpin() {pin_count_.fetch_sub(1, std::memory_order_acq_rel);}
+        int GetPinCount() const {return pin_count_.load(std::memory_order_acquire);}
+
+        /**
+         * @brief 페이지 내용 latch. 레코드를 넣을 때는 exclusive, 디스크에 쓸 때와 읽을 때는 shared로 잡음
+         */
+        std::shared_mutex &Latch() const {return latch_;}
+
         int GetSlotOffset() const {return slot_offset_;}
 
         /**
@@ -231,14 +482,6 @@ class Page {
          */
         void SetDirty(bool dirty);
 
-        /**
-         * @brief 페이지 고정 여부 설정
-         * 
-         * @param  true 고정됨
-         * @param  false 고정되지 않음
-         */
-        void SetPinned(bool pinned);
-
         /**
          * @brief 다음 페이지 설정
          * @param next 다음 페이지
@@ -0,0 +1,225 @@
+#include "predicate.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+#include "commons.h"
+#include "filter_kernels.h"
+
+namespace {
+
+// 타입별 비교. 값은 페이지 안의 임의 위치에 있을 수 있으므로 memcpy로 읽음
+struct IntMatcher {
+    template <typename Cmp>
+    static bool Value(const PredicateTerm &term, const char *value) {
+        int32_t v;
+        std::memcpy(&v, value, sizeof(int32_t));
+        return Cmp()(v, term.int_value);
+    }
+};
+
+struct FloatMatcher {
+    template <typename Cmp>
+    static bool Value(const PredicateTerm &term, const char *value) {
+        float v;
+        std::memcpy(&v, value, sizeof(float));
+        return Cmp()(v, term.float_value);
+    }
+};
+
+struct CharMatcher {
+    template <typename Cmp>
+    static bool Value(const PredicateTerm &term, const char *value) {
+        return Cmp()(std::strncmp(value, term.char_value.data(), term.length), 0);
+    }
+};
+
+template <typename Matcher, typename Cmp>
+bool MatchRecord(const PredicateTerm &term, const char *record) {
+    return Matcher::template Value<Cmp>(term, record + term.offset);
+}
+
+template <typename Matcher, typename Cmp>
+void AssignMatch(PredicateTerm &term) {
+    term.match = &MatchRecord<Matcher, Cmp>;
+    term.match_value = &Matcher::template Value<Cmp>;
+}
+
+/**
+ * @brief 연산자에 맞는 레코드용/값용 비교 함수를 term에 채움 (알 수 없는 연산자면 그대로 둠)
+ */
+template <typename Matcher>
+void SelectMatch(PredicateTerm &term) {
+    switch (term.sign_type) {
+        case SIGN_EQ: AssignMatch<Matcher, std::equal_to<>>(term); break;
+        case SIGN_NE: AssignMatch<Matcher, std::not_equal_to<>>(term); break;
+        case SIGN_LT: AssignMatch<Matcher, std::less<>>(term); break;
+        case SIGN_LE: AssignMatch<Matcher, std::less_equal<>>(term); break;
+        case SIGN_GT: AssignMatch<Matcher, std::greater<>>(term); break;
+        case SIGN_GE: AssignMatch<Matcher, std::greater_equal<>>(term); break;
+        default: break;
+    }
+}
+
+bool MatchNone(const PredicateTerm &, const char *) {
+    return false;
+}
+
+/**
+ * @brief value (sign_type) literal 을 만족하는 값이 [lo, hi] 범위에 있을 수 있는지
+ */
+template <typename T>
+bool RangeMayMatch(int sign_type, T lo, T hi, T literal) {
+    switch (sign_type) {
+        case SIGN_EQ: return lo <= literal && literal <= hi;
+        case SIGN_NE: return !(lo == literal && hi == literal);
+        case SIGN_LT: return lo < literal;
+        case SIGN_LE: return lo <= literal;
+        case SIGN_GT: return hi > literal;
+        case SIGN_GE: return hi >= literal;
+        default: return false;
+    }
+}
+
+}  // namespace
+
+Predicate Predicate::Compile(Table *tbl, const std::vector<SQLWhere> &wheres) {
+    Predicate predicate;
+    std::vector<ZoneColumn> zone_columns = tbl->GetPageFormat().zone_columns;
+    for (const auto &where : wheres) {
+        int attr_index = tbl->GetAttributeIndex(where.key);
+        if (attr_index == -1) continue;
+        int offset = tbl->GetAttributeOffset(attr_index);
+
+        const Attribute &attr = tbl->ats()[attr_index];
+        PredicateTerm term;
+        term.column = attr_index;
+        term.offset = offset;
+        term.zone = -1;
+        for (size_t z = 0; z < zone_columns.size(); z++) {
+            if (zone_columns[z].offset == offset) {
+                term.zone = static_cast<int>(z);
+                predicate.uses_zone_map_ = true;
+            }
+        }
+        term.data_type = attr.data_type();
+        term.length = term.data_type == T_CHAR ? attr.length() : 4;
+        term.sign_type = where.sign_type;
+        term.int_value = 0;
+        term.float_value = 0;
+        term.match = nullptr;
+        term.match_value = nullptr;
+        switch (term.data_type) {
+            case T_INT:
+                term.int_value = std::atoi(where.value.c_str());
+                SelectMatch<IntMatcher>(term);
+                break;
+            case T_FLOAT:
+                term.float_value = static_cast<float>(std::atof(where.value.c_str()));
+                SelectMatch<FloatMatcher>(term);
+                break;
+            case T_CHAR:
+                term.char_value.assign(term.length, 0);
+                std::memcpy(term.char_value.data(), where.value.c_str(),
+                            std::min<size_t>(where.value.size(), term.length));
+                SelectMatch<CharMatcher>(term);
+                break;
+            default:
+                break;
+        }
+        if (term.match == nullptr) {
+            term.match = &MatchNone;  // 알 수 없는 타입/연산자는 기존처럼 조건 불만족
+            term.match_value = &MatchNone;
+        }
+        predicate.terms_.push_back(std::move(term));
+    }
+    return predicate;
+}
+
+void Predicate::MatchBatch(const char *const *records, size_t n, std::vector<uint64_t> &selection, BatchScratch &scratch) const {
+    size_t words = (n + 63) / 64;
+    selection.assign(words, ~static_cast<uint64_t>(0));
+    if (n % 64 != 0) {
+        selection[words - 1] = (static_cast<uint64_t>(1) << (n % 64)) - 1;
+    }
+
+    for (const PredicateTerm &term : terms_) {
+        switch (term.data_type) {
+            case T_INT:
+                scratch.ints.resize(n);
+                GatherInt32(records, n, term.offset, scratch.ints.data());
+                FilterInt32(scratch.ints.data(), n, term.sign_type, term.int_value, selection.data());
+                break;
+            case T_FLOAT:
+                scratch.floats.resize(n);
+                GatherFloat(records, n, term.offset, scratch.floats.data());
+                FilterFloat(scratch.floats.data(), n, term.sign_type, term.float_value, selection.data());
+                break;
+            default:
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t bit = static_cast<uint64_t>(1) << (i & 63);
+                    if ((selection[i >> 6] & bit) && !term.match(term, records[i])) {
+                        selection[i >> 6] &= ~bit;
+                    }
+                }
+                break;
+        }
+    }
+}
+
+void Predicate::MatchColumns(const char *const *columns, const int *widths, size_t n, std::vector<uint64_t> &selection) const {
+    size_t words = (n + 63) / 64;
+    selection.assign(words, ~static_cast<uint64_t>(0));
+    if (n % 64 != 0) {
+        selection[words - 1] = (static_cast<uint64_t>(1) << (n % 64)) - 1;
+    }
+
+    for (const PredicateTerm &term : terms_) {
+        const char *column = columns[term.column];
+        switch (term.data_type) {
+            case T_INT:
+                // minipage는 8바이트 정렬된 연속 배열이므로 모으지 않고 바로 비교
+                FilterInt32(reinterpret_cast<const int32_t *>(column), n, term.sign_type, term.int_value, selection.data());
+                break;
+            case T_FLOAT:
+                FilterFloat(reinterpret_cast<const float *>(column), n, term.sign_type, term.float_value, selection.data());
+                break;
+            default: {
+                int width = widths[term.column];
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t bit = static_cast<uint64_t>(1) << (i & 63);
+                    if ((selection[i >> 6] & bit) && !term.match_value(term, column + i * width)) {
+                        selection[i >> 6] &= ~bit;
+                    }
+                }
+                break;
+            }
+        }
+    }
+}
+
+bool Predicate::MayMatch(const ZoneBounds &zone) const {
+    for (const PredicateTerm &term : terms_) {
+        if (term.zone < 0 || term.zone >= zone.count) {
+            continue;
+        }
+        bool may_match;
+        if (term.data_type == T_INT) {
+            int32_t lo, hi;
+            std::memcpy(&lo, &zone.min[term.zone], sizeof(int32_t));
+            std::memcpy(&hi, &zone.max[term.zone], sizeof(int32_t));
+            may_match = RangeMayMatch(term.sign_type, lo, hi, term.int_value);
+        } else {
+            float lo, hi;
+            std::memcpy(&lo, &zone.min[term.zone], sizeof(float));
+            std::memcpy(&hi, &zone.max[term.zone], sizeof(float));
+            may_match = RangeMayMatch(term.sign_type, lo, hi, term.float_value);
+        }
+        if (!may_match) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,123 @@
+#ifndef ABCDB_PREDICATE_H_
+#define ABCDB_PREDICATE_H_
+
+#include <cstdint>
+#include <vector>
+#include "catalog_manager.h"
+#include "sql_statement.h"
+
+/**
+ * @brief 컴파일된 WHERE 조건 하나. 레코드 안의 값 위치, 상수, 타입별 비교 함수를 미리 정해둠
+ */
+struct PredicateTerm {
+    int column;         // 속성 번호 (Table::ats() 위치, PAX 페이지의 minipage 번호)
+    int offset;         // 레코드 안에서 값의 시작 위치 (bytes)
+    int zone;           // 이 속성 범위가 기록된 zone map 위치 (Table::GetPageFormat), 없으면 -1
+    int length;         // 값 길이 (INT/FLOAT는 4)
+    int data_type;      // T_INT, T_FLOAT, T_CHAR
+    int sign_type;      // SIGN_EQ ...
+    int32_t int_value;
+    float float_value;
+    std::vector<char> char_value;   // length 바이트, 남는 부분은 0
+
+    /**
+     * @brief 레코드 하나에 대해 조건을 평가 (data_type, sign_type 조합마다 특수화된 함수)
+     */
+    bool (*match)(const PredicateTerm &term, const char *record);
+
+    /**
+     * @brief 값 하나에 대해 조건을 평가 (PAX minipage 안의 값)
+     */
+    bool (*match_value)(const PredicateTerm &term, const char *value);
+
+    /**
+     * @brief 레코드 안의 값과 같은 형식(length 바이트)의 상수
+     */
+    const char *literal() const {
+        switch (data_type) {
+            case T_INT: return reinterpret_cast<const char *>(&int_value);
+            case T_FLOAT: return reinterpret_cast<const char *>(&float_value);
+            default: return char_value.data();
+        }
+    }
+};
+
+/**
+ * @brief MatchBatch가 열 값을 모으는 데 쓰는 작업 공간. 호출마다 할당하지 않도록 호출한 쪽이 보관
+ */
+struct BatchScratch {
+    std::vector<int32_t> ints;
+    std::vector<float> floats;
+    std::vector<const char *> columns;  // PAX 페이지의 minipage 주소
+    std::vector<int> widths;
+};
+
+/**
+ * @brief 질의마다 한 번 컴파일하는 WHERE 조건 (AND로 연결)
+ * @details 속성 이름 탐색과 상수 변환은 Compile에서 끝내고, 행마다는 레코드 바이트만 읽는다.
+ *          INT = 비교는 4바이트를 읽어 정수로 바로 비교한다.
+ */
+class Predicate {
+private:
+    std::vector<PredicateTerm> terms_;
+    bool uses_zone_map_ = false;
+
+public:
+    /**
+     * @brief WHERE 조건을 테이블 스키마에 맞춰 컴파일. 테이블에 없는 속성의 조건은 무시됨
+     */
+    static Predicate Compile(Table *tbl, const std::vector<SQLWhere> &wheres);
+
+    /**
+     * @brief 레코드가 모든 조건을 만족하는지 검사
+     *
+     * @param record 레코드 시작 위치 (페이지 안)
+     */
+    bool Match(const char *record) const {
+        for (const PredicateTerm &term : terms_) {
+            if (!term.match(term, record)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 레코드 n개에 조건을 한 번에 적용 (batch 모드)
+     * @details INT/FLOAT 조건은 열 값을 연속 배열로 모은 뒤 SIMD filter 커널로 비교하고, CHAR 조건은 행마다 비교한다.
+     *
+     * @param records 레코드 시작 주소 배열
+     * @param n 레코드 수
+     * @param selection 결과 bitmap. (n + 63) / 64 word로 맞춰지며 조건을 만족한 행의 bit가 1
+     * @param scratch 작업 공간
+     */
+    void MatchBatch(const char *const *records, size_t n, std::vector<uint64_t> &selection, BatchScratch &scratch) const;
+
+    /**
+     * @brief PAX 페이지의 행 n개에 조건을 한 번에 적용. 조건에 쓰인 속성의 minipage만 읽음
+     * @details INT/FLOAT minipage는 이미 연속 배열이므로 모으는 단계 없이 filter 커널에 넘긴다.
+     *
+     * @param columns 속성별 minipage 시작 주소 (Page::GetColumn)
+     * @param widths 속성별 값 길이
+     * @param n 행 수
+     * @param selection 결과 bitmap (MatchBatch와 같음)
+     */
+    void MatchColumns(const char *const *columns, const int *widths, size_t n, std::vector<uint64_t> &selection) const;
+
+    /**
+     * @brief 페이지의 zone map 범위 안에 조건을 만족하는 행이 있을 수 있는지
+     * @details zone map에 범위가 기록된 INT/FLOAT 속성 조건만 보며, 범위를 모르면 true.
+     *          false인 페이지는 읽지 않고 건너뛸 수 있다.
+     */
+    bool MayMatch(const ZoneBounds &zone) const;
+
+    /**
+     * @brief MayMatch로 거를 수 있는 조건이 하나라도 있는지
+     */
+    bool UsesZoneMap() const { return uses_zone_map_; }
+
+    bool Empty() const { return terms_.empty(); }
+    const std::vector<PredicateTerm> &terms() const { return terms_; }
+};
+
+#endif
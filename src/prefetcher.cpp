@@ -0,0 +1,85 @@
+#include "prefetcher.h"
+
+#include <shared_mutex>
+#include <stdexcept>
+
+#include "buffer_manager.h"
+#include "exceptions.h"
+
+Prefetcher::Prefetcher(BufferManager *bm, size_t threads)
+    : bm_(bm), stop_(false), requested_(0), loaded_(0), skipped_(0) {
+    for (size_t i = 0; i < threads; i++) {
+        threads_.emplace_back(&Prefetcher::Run, this);
+    }
+}
+
+Prefetcher::~Prefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        queue_.clear();
+    }
+    cv_.notify_all();
+    for (std::thread &thread : threads_) {
+        thread.join();
+    }
+}
+
+void Prefetcher::Request(const std::string &file, const std::vector<std::pair<int, int>> &pages,
+                         const std::shared_ptr<ScanRing> &ring) {
+    if (pages.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const std::pair<int, int> &page : pages) {
+            if (queue_.size() >= PREFETCH_QUEUE_LIMIT) {
+                skipped_++;
+                continue;
+            }
+            queue_.push_back({file, page.first, page.second, ring});
+            requested_++;
+        }
+    }
+    cv_.notify_all();
+}
+
+void Prefetcher::Run() {
+    while (true) {
+        PrefetchRequest request;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_) {
+                return;
+            }
+            request = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        Load(request);
+    }
+}
+
+void Prefetcher::Load(const PrefetchRequest &request) {
+    // 쓰기 문장이 실행 중(또는 대기 중)이면 파일이 바뀔 수 있으므로 읽지 않음
+    std::shared_lock<std::shared_mutex> latch(bm_->statement_latch(), std::try_to_lock);
+    if (!latch.owns_lock() || bm_->IsResident(request.file, request.dir_idx, request.page_idx)) {
+        skipped_++;
+        return;
+    }
+    try {
+        if (request.ring) {
+            if (bm_->LoadIntoRing(request.file, request.dir_idx, request.page_idx, request.ring)) {
+                loaded_++;
+            } else {
+                skipped_++;
+            }
+        } else if (bm_->GetPage(request.file, request.dir_idx, request.page_idx) != nullptr) {
+            loaded_++;
+        }
+    } catch (const BufferPoolFullException &) {
+        skipped_++;     // 모든 프레임이 고정됨. 스캔이 직접 읽음
+    } catch (const std::out_of_range &) {
+        skipped_++;     // 요청 뒤 없어진 페이지
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef ABCDB_PREFETCHER_H_
+#define ABCDB_PREFETCHER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define PREFETCH_QUEUE_LIMIT 1024   // 이보다 많이 밀린 요청은 버림 (읽을 때쯤이면 이미 스캔이 지나감)
+
+class BufferManager;
+class ScanRing;
+
+/**
+ * @brief 미리 읽을 페이지 하나
+ */
+struct PrefetchRequest {
+    std::string file;
+    int dir_idx;
+    int page_idx;
+    std::shared_ptr<ScanRing> ring;     // nullptr이면 버퍼 풀에 넣음
+};
+
+/**
+ * @brief 순차 스캔이 곧 읽을 페이지를 I/O 스레드가 미리 pread해 버퍼 풀에 넣는 read-ahead
+ * @details 요청은 힌트일 뿐이라 버퍼 풀에 이미 있거나, 대기열이 가득 찼거나, 쓰기 문장이 statement latch를
+ *          잡고 있으면 읽지 않고 버린다. 읽을 때는 statement latch를 shared로 잡으므로 테이블 파일이
+ *          바뀌거나 삭제되는 중에는 읽지 않는다. 미리 읽은 페이지는 고정하지 않으므로 버퍼 풀이 작으면
+ *          쓰이기 전에 교체될 수 있다 (BufferManager는 거리를 프레임 수의 1/4로 제한).
+ *          ScanRing을 쓰는 스캔의 요청은 버퍼 풀 대신 그 ring에 읽어 둔다.
+ */
+class Prefetcher {
+private:
+    BufferManager *bm_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<PrefetchRequest> queue_;
+    bool stop_;
+
+    std::atomic<uint64_t> requested_;   // 대기열에 들어간 요청
+    std::atomic<uint64_t> loaded_;      // 디스크에서 읽어 버퍼 풀(또는 ring)에 넣은 페이지
+    std::atomic<uint64_t> skipped_;     // 이미 있거나 latch를 못 잡아 버린 요청
+
+    void Run();
+    void Load(const PrefetchRequest &request);
+
+public:
+    Prefetcher(BufferManager *bm, size_t threads);
+
+    /**
+     * @brief 남은 요청을 버리고 스레드가 끝날 때까지 기다림
+     */
+    ~Prefetcher();
+
+    /**
+     * @brief 파일의 (dir idx, page idx) 페이지들을 비동기로 읽도록 요청
+     *
+     * @param ring nullptr가 아니면 버퍼 풀 대신 ring에 넣음
+     */
+    void Request(const std::string &file, const std::vector<std::pair<int, int>> &pages,
+                 const std::shared_ptr<ScanRing> &ring = nullptr);
+
+    uint64_t requested() const { return requested_; }
+    uint64_t loaded() const { return loaded_; }
+    uint64_t skipped() const { return skipped_; }
+};
+
+#endif
@@ -0,0 +1,368 @@
+#include "replacement_policy.h"
+
+#include <iostream>
+
+/*=======================================SegmentedLruPolicy================================================ */
+void SegmentedLruPolicy::RecordInsert(const PageKey &key)
+{
+    if (entries_.find(key) != entries_.end())
+    {
+        RecordAccess(key);
+        return;
+    }
+    infreq_.push_front(key);
+    entries_[key] = Entry{false, infreq_.begin()};
+}
+
+void SegmentedLruPolicy::RecordAccess(const PageKey &key)
+{
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+    {
+        return;
+    }
+    Entry &entry = it->second;
+    if (entry.in_freq) // freq 안에서 앞으로 이동
+    {
+        freq_.splice(freq_.begin(), freq_, entry.pos);
+        return;
+    }
+
+    if (freq_.size() >= max_freq_size_ && !freq_.empty()) // freq가 가득 찼으면 freq의 LRU를 infreq 앞으로 내림
+    {
+        KeyIter demoted = std::prev(freq_.end());
+        infreq_.splice(infreq_.begin(), freq_, demoted);
+        entries_[*demoted].in_freq = false;
+    }
+    freq_.splice(freq_.begin(), infreq_, entry.pos);
+    entry.in_freq = true;
+}
+
+void SegmentedLruPolicy::Remove(const PageKey &key)
+{
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+    {
+        return;
+    }
+    if (it->second.in_freq)
+    {
+        freq_.erase(it->second.pos);
+    }
+    else
+    {
+        infreq_.erase(it->second.pos);
+    }
+    entries_.erase(it);
+}
+
+bool SegmentedLruPolicy::Victim(const std::function<bool(const PageKey &)> &evictable, PageKey *victim)
+{
+    for (auto it = infreq_.rbegin(); it != infreq_.rend(); ++it)
+    {
+        if (evictable(*it))
+        {
+            *victim = *it;
+            return true;
+        }
+    }
+    for (auto it = freq_.rbegin(); it != freq_.rend(); ++it)
+    {
+        if (evictable(*it))
+        {
+            *victim = *it;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*=======================================ClockPolicy================================================ */
+void ClockPolicy::RecordInsert(const PageKey &key)
+{
+    if (index_.find(key) != index_.end())
+    {
+        RecordAccess(key);
+        return;
+    }
+    size_t slot;
+    if (!free_slots_.empty())
+    {
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+        slots_[slot] = Slot{key, true, 0};
+    }
+    else
+    {
+        slot = slots_.size();
+        slots_.push_back(Slot{key, true, 0});
+    }
+    index_[key] = slot;
+}
+
+void ClockPolicy::RecordAccess(const PageKey &key)
+{
+    auto it = index_.find(key);
+    if (it != index_.end() && slots_[it->second].usage < MAX_USAGE)
+    {
+        slots_[it->second].usage++;
+    }
+}
+
+void ClockPolicy::Remove(const PageKey &key)
+{
+    auto it = index_.find(key);
+    if (it == index_.end())
+    {
+        return;
+    }
+    slots_[it->second].valid = false;
+    free_slots_.push_back(it->second);
+    index_.erase(it);
+}
+
+bool ClockPolicy::Victim(const std::function<bool(const PageKey &)> &evictable, PageKey *victim)
+{
+    if (slots_.empty())
+    {
+        return false;
+    }
+    // MAX_USAGE + 1 바퀴 돌면 모든 사용 횟수가 0이 되므로, 그때까지 못 찾으면 전부 고정된 것
+    for (size_t step = 0; step < slots_.size() * (MAX_USAGE + 1); ++step)
+    {
+        Slot &slot = slots_[hand_];
+        hand_ = (hand_ + 1) % slots_.size();
+        if (!slot.valid || !evictable(slot.key))
+        {
+            continue;
+        }
+        if (slot.usage > 0)
+        {
+            slot.usage--;
+            continue;
+        }
+        *victim = slot.key;
+        return true;
+    }
+    return false;
+}
+
+/*=======================================LruKPolicy================================================ */
+void LruKPolicy::Unlink(const History &h)
+{
+    if (h.times.size() < k_)
+    {
+        cold_.erase(h.times.back());
+    }
+    else
+    {
+        hot_.erase(h.times.front());
+    }
+}
+
+void LruKPolicy::Link(const PageKey &key, const History &h)
+{
+    if (h.times.size() < k_)
+    {
+        cold_[h.times.back()] = key;
+    }
+    else
+    {
+        hot_[h.times.front()] = key;
+    }
+}
+
+void LruKPolicy::Touch(History &h)
+{
+    h.times.push_back(++clock_);
+    if (h.times.size() > k_)
+    {
+        h.times.erase(h.times.begin());
+    }
+}
+
+void LruKPolicy::RecordInsert(const PageKey &key)
+{
+    auto it = history_.find(key);
+    if (it == history_.end())
+    {
+        History h;
+        h.resident = true;
+        Touch(h);
+        Link(key, h);
+        history_.emplace(key, h);
+        return;
+    }
+    History &h = it->second;
+    if (h.resident)
+    {
+        RecordAccess(key);
+        return;
+    }
+    // 최근에 교체된 프레임이 다시 적재됨: 이전 참조 기록을 이어서 사용
+    retired_.erase(h.retired);
+    h.resident = true;
+    Touch(h);
+    Link(key, h);
+}
+
+void LruKPolicy::RecordAccess(const PageKey &key)
+{
+    auto it = history_.find(key);
+    if (it == history_.end() || !it->second.resident)
+    {
+        return;
+    }
+    Unlink(it->second);
+    Touch(it->second);
+    Link(key, it->second);
+}
+
+void LruKPolicy::Remove(const PageKey &key)
+{
+    auto it = history_.find(key);
+    if (it == history_.end() || !it->second.resident)
+    {
+        return;
+    }
+    Unlink(it->second);
+    it->second.resident = false;
+    retired_.push_back(key);
+    it->second.retired = std::prev(retired_.end());
+
+    while (retired_.size() > capacity_)
+    {
+        history_.erase(retired_.front());
+        retired_.pop_front();
+    }
+}
+
+bool LruKPolicy::Victim(const std::function<bool(const PageKey &)> &evictable, PageKey *victim)
+{
+    for (const auto &entry : cold_)
+    {
+        if (evictable(entry.second))
+        {
+            *victim = entry.second;
+            return true;
+        }
+    }
+    for (const auto &entry : hot_)
+    {
+        if (evictable(entry.second))
+        {
+            *victim = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*=======================================TwoQueuePolicy================================================ */
+void TwoQueuePolicy::RememberGhost(const PageKey &key)
+{
+    a1out_.push_front(key);
+    ghosts_[key] = a1out_.begin();
+    while (a1out_.size() > kout_)
+    {
+        ghosts_.erase(a1out_.back());
+        a1out_.pop_back();
+    }
+}
+
+void TwoQueuePolicy::RecordInsert(const PageKey &key)
+{
+    if (entries_.find(key) != entries_.end())
+    {
+        RecordAccess(key);
+        return;
+    }
+    auto ghost = ghosts_.find(key);
+    if (ghost != ghosts_.end()) // A1out에 기록이 있으면 자주 쓰이는 페이지로 보고 Am에 넣음
+    {
+        a1out_.erase(ghost->second);
+        ghosts_.erase(ghost);
+        am_.push_front(key);
+        entries_[key] = Entry{AM, am_.begin()};
+        return;
+    }
+    a1in_.push_front(key);
+    entries_[key] = Entry{A1IN, a1in_.begin()};
+}
+
+void TwoQueuePolicy::RecordAccess(const PageKey &key)
+{
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+    {
+        return;
+    }
+    if (it->second.queue == AM)
+    {
+        am_.splice(am_.begin(), am_, it->second.pos);
+    }
+    // A1in은 FIFO이므로 참조되어도 순서를 바꾸지 않음
+}
+
+void TwoQueuePolicy::Remove(const PageKey &key)
+{
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+    {
+        return;
+    }
+    if (it->second.queue == AM)
+    {
+        am_.erase(it->second.pos);
+    }
+    else
+    {
+        a1in_.erase(it->second.pos);
+        RememberGhost(key);
+    }
+    entries_.erase(it);
+}
+
+bool TwoQueuePolicy::Victim(const std::function<bool(const PageKey &)> &evictable, PageKey *victim)
+{
+    bool prefer_a1in = a1in_.size() > kin_ || am_.empty();
+    std::list<PageKey> *order[2] = {&am_, &a1in_};
+    if (prefer_a1in)
+    {
+        std::swap(order[0], order[1]);
+    }
+    for (std::list<PageKey> *queue : order)
+    {
+        for (auto it = queue->rbegin(); it != queue->rend(); ++it)
+        {
+            if (evictable(*it))
+            {
+                *victim = *it;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/*=======================================Factory================================================ */
+std::unique_ptr<ReplacementPolicy> CreateReplacementPolicy(const std::string &name, size_t capacity)
+{
+    if (name == "clock")
+    {
+        return std::unique_ptr<ReplacementPolicy>(new ClockPolicy(capacity));
+    }
+    if (name == "lru-k" || name == "lru2")
+    {
+        return std::unique_ptr<ReplacementPolicy>(new LruKPolicy(capacity, 2));
+    }
+    if (name == "2q")
+    {
+        return std::unique_ptr<ReplacementPolicy>(new TwoQueuePolicy(capacity));
+    }
+    if (!name.empty() && name != "slru")
+    {
+        std::cerr << "Unknown replacement policy '" << name << "', using slru." << std::endl;
+    }
+    return std::unique_ptr<ReplacementPolicy>(new SegmentedLruPolicy(capacity));
+}
@@ -0,0 +1,208 @@
+#ifndef REPLACEMENT_POLICY_H
+#define REPLACEMENT_POLICY_H
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 버퍼 풀에서 프레임을 찾기 위한 키 (file id, dir idx, page idx)
+ */
+struct PageKey {
+    int file_id;
+    int dir_idx;
+    int page_idx;
+
+    bool operator==(const PageKey &other) const {
+        return file_id == other.file_id && dir_idx == other.dir_idx && page_idx == other.page_idx;
+    }
+};
+
+struct PageKeyHash {
+    size_t operator()(const PageKey &key) const {
+        size_t h = std::hash<int>()(key.file_id);
+        h = h * 31 + std::hash<int>()(key.dir_idx);
+        h = h * 31 + std::hash<int>()(key.page_idx);
+        return h;
+    }
+};
+
+/**
+ * @brief 버퍼 풀 교체 정책 인터페이스
+ * @details 정책은 프레임의 교체 순서만 관리하고, 페이지 자체는 BufferPool의 frame table이 가진다.
+ *          Victim은 evictable을 만족하는(고정되지 않은) 프레임 중에서만 고른다.
+ */
+class ReplacementPolicy
+{
+public:
+    virtual ~ReplacementPolicy() {}
+
+    virtual const char *Name() const = 0;
+
+    /**
+     * @brief 새 프레임이 버퍼 풀에 적재됨
+     */
+    virtual void RecordInsert(const PageKey &key) = 0;
+
+    /**
+     * @brief 버퍼 풀에 있는 프레임이 참조됨
+     */
+    virtual void RecordAccess(const PageKey &key) = 0;
+
+    /**
+     * @brief 프레임이 버퍼 풀에서 제거됨
+     */
+    virtual void Remove(const PageKey &key) = 0;
+
+    /**
+     * @brief 교체할 프레임 선택 (선택만 하고 제거는 Remove로 수행)
+     *
+     * @param evictable 프레임을 내보낼 수 있는지 확인하는 함수
+     * @param victim 선택된 프레임
+     * @return true 선택 성공
+     * @return false 내보낼 수 있는 프레임 없음
+     */
+    virtual bool Victim(const std::function<bool(const PageKey &)> &evictable, PageKey *victim) = 0;
+};
+
+/**
+ * @brief freq/infreq 두 구역으로 나눈 segmented LRU (기본 정책)
+ * @details 새 페이지는 infreq에 들어가고 다시 참조되어야 freq로 승격된다.
+ *          교체는 infreq의 LRU부터 시도하므로 한 번만 읽히는 스캔 페이지가 freq를 밀어내지 않는다.
+ */
+class SegmentedLruPolicy : public ReplacementPolicy
+{
+private:
+    typedef std::list<PageKey>::iterator KeyIter;
+    struct Entry {
+        bool in_freq;
+        KeyIter pos;
+    };
+
+    size_t max_freq_size_;
+    std::list<PageKey> freq_;    // front가 MRU
+    std::list<PageKey> infreq_;  // front가 MRU
+    std::unordered_map<PageKey, Entry, PageKeyHash> entries_;
+
+public:
+    explicit SegmentedLruPolicy(size_t capacity) : max_freq_size_(capacity * 5 / 8) {}
+    const char *Name() const override { return "slru"; }
+    void RecordInsert(const PageKey &key) override;
+    void RecordAccess(const PageKey &key) override;
+    void Remove(const PageKey &key) override;
+    bool Victim(const std::function<bool(const PageKey &)> &evictable, PageKey *victim) override;
+};
+
+/**
+ * @brief CLOCK (clock-sweep)
+ * @details 참조 비트 대신 최대 MAX_USAGE까지 올라가는 사용 횟수를 두고, hand가 지나갈 때마다 1씩 줄인다.
+ *          새로 적재된 프레임은 0에서 시작하므로 한 번만 읽힌 스캔 페이지가 가장 먼저 교체된다.
+ */
+class ClockPolicy : public ReplacementPolicy
+{
+private:
+    static const int MAX_USAGE = 5;
+    struct Slot {
+        PageKey key;
+        bool valid;
+        int usage;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<size_t> free_slots_;
+    std::unordered_map<PageKey, size_t, PageKeyHash> index_;
+    size_t hand_;
+
+public:
+    explicit ClockPolicy(size_t capacity) : hand_(0) { slots_.reserve(capacity); }
+    const char *Name() const override { return "clock"; }
+    void RecordInsert(const PageKey &key) override;
+    void RecordAccess(const PageKey &key) override;
+    void Remove(const PageKey &key) override;
+    bool Victim(const std::function<bool(const PageKey &)> &evictable, PageKey *victim) override;
+};
+
+/**
+ * @brief LRU-K
+ * @details backward K-distance가 가장 큰 프레임을 교체한다. 참조가 K번 미만인 프레임은 거리가 무한대로
+ *          취급되어 먼저 교체되며, 교체된 프레임의 참조 기록은 capacity개까지 보관한다.
+ */
+class LruKPolicy : public ReplacementPolicy
+{
+private:
+    struct History {
+        std::vector<uint64_t> times;           // 최근 K번의 참조 시각 (front가 가장 오래됨)
+        bool resident;
+        std::list<PageKey>::iterator retired;  // resident가 아닐 때 retired_ 내 위치
+    };
+
+    size_t k_;
+    size_t capacity_;
+    uint64_t clock_;
+    std::unordered_map<PageKey, History, PageKeyHash> history_;
+    std::list<PageKey> retired_;               // 버퍼 풀에서 나간 프레임의 기록 (front가 오래됨)
+    std::map<uint64_t, PageKey> cold_;         // 참조 K번 미만: 마지막 참조 시각 순
+    std::map<uint64_t, PageKey> hot_;          // 참조 K번 이상: K번째 최근 참조 시각 순
+
+    void Unlink(const History &h);
+    void Link(const PageKey &key, const History &h);
+    void Touch(History &h);
+
+public:
+    LruKPolicy(size_t capacity, size_t k) : k_(k), capacity_(capacity), clock_(0) {}
+    const char *Name() const override { return "lru-k"; }
+    void RecordInsert(const PageKey &key) override;
+    void RecordAccess(const PageKey &key) override;
+    void Remove(const PageKey &key) override;
+    bool Victim(const std::function<bool(const PageKey &)> &evictable, PageKey *victim) override;
+};
+
+/**
+ * @brief 2Q (full version)
+ * @details 새 프레임은 FIFO인 A1in에 들어가고, A1in에서 밀려난 프레임의 키는 ghost 큐 A1out에 남는다.
+ *          A1out에 기록이 있는 프레임이 다시 적재될 때만 LRU인 Am으로 들어간다.
+ */
+class TwoQueuePolicy : public ReplacementPolicy
+{
+private:
+    enum Queue { A1IN, AM };
+    typedef std::list<PageKey>::iterator KeyIter;
+    struct Entry {
+        Queue queue;
+        KeyIter pos;
+    };
+
+    size_t kin_;
+    size_t kout_;
+    std::list<PageKey> a1in_;   // front가 최신
+    std::list<PageKey> a1out_;  // front가 최신, ghost
+    std::list<PageKey> am_;     // front가 MRU
+    std::unordered_map<PageKey, Entry, PageKeyHash> entries_;
+    std::unordered_map<PageKey, KeyIter, PageKeyHash> ghosts_;
+
+    void RememberGhost(const PageKey &key);
+
+public:
+    explicit TwoQueuePolicy(size_t capacity)
+        : kin_(capacity / 4 > 0 ? capacity / 4 : 1), kout_(capacity / 2 > 0 ? capacity / 2 : 1) {}
+    const char *Name() const override { return "2q"; }
+    void RecordInsert(const PageKey &key) override;
+    void RecordAccess(const PageKey &key) override;
+    void Remove(const PageKey &key) override;
+    bool Victim(const std::function<bool(const PageKey &)> &evictable, PageKey *victim) override;
+};
+
+/**
+ * @brief 이름으로 교체 정책 생성 ("slru", "clock", "lru-k", "2q")
+ *
+ * @param name 정책 이름, 알 수 없는 이름이면 slru
+ * @param capacity 버퍼 풀의 프레임 수
+ */
+std::unique_ptr<ReplacementPolicy> CreateReplacementPolicy(const std::string &name, size_t capacity);
+
+#endif
@@ -0,0 +1,72 @@
+#include "scan_ring.h"
+
+#include <algorithm>
+
+ScanRing::ScanRing(size_t capacity) : hand_(0) {
+    frames_.resize(std::max<size_t>(capacity, 1));
+    for (Frame &frame : frames_) {
+        frame.key = PageKey{-1, -1, -1};
+        frame.page = std::make_shared<Page>("", 0);
+        frame.loading = false;
+    }
+}
+
+size_t ScanRing::Reserve(const PageKey &key) {
+    for (size_t i = 0; i < frames_.size(); i++) {
+        size_t slot = (hand_ + i) % frames_.size();
+        Frame &frame = frames_[slot];
+        if (frame.loading || frame.page.use_count() != 1) {
+            continue;   // 커서나 다른 스레드가 보고 있는 페이지
+        }
+        index_.erase(frame.key);
+        frame.key = key;
+        frame.loading = true;
+        index_[key] = slot;
+        hand_ = (slot + 1) % frames_.size();
+        return slot;
+    }
+    return frames_.size();
+}
+
+std::shared_ptr<Page> ScanRing::Get(const PageKey &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end() || frames_[it->second].loading) {
+        return nullptr;
+    }
+    return frames_[it->second].page;
+}
+
+std::shared_ptr<Page> ScanRing::Load(const PageKey &key, const std::function<void(Page &)> &read) {
+    size_t slot;
+    std::shared_ptr<Page> page;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            return frames_[it->second].loading ? nullptr : frames_[it->second].page;
+        }
+        slot = Reserve(key);
+        if (slot == frames_.size()) {
+            return nullptr;
+        }
+        page = frames_[slot].page;  // 읽는 동안 다른 스레드가 이 프레임을 고르지 않음
+    }
+    try {
+        read(*page);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index_.erase(key);
+        frames_[slot].key = PageKey{-1, -1, -1};
+        frames_[slot].loading = false;
+        throw;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    frames_[slot].loading = false;
+    return page;
+}
+
+bool ScanRing::Contains(const PageKey &key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.count(key) != 0;
+}
@@ -0,0 +1,69 @@
+#ifndef ABCDB_SCAN_RING_H_
+#define ABCDB_SCAN_RING_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "page.h"
+#include "replacement_policy.h"
+
+/**
+ * @brief 큰 테이블을 스캔할 때 공유 버퍼 풀 대신 쓰는 스캔 전용 프레임 묶음 (PostgreSQL의 BufferAccessStrategy ring)
+ * @details 프레임 capacity개를 처음에 한 번 만들어 두고, 버퍼 풀에 없는 페이지는 BufferPool::InsertPage를 거치지 않고
+ *          이 프레임에 돌려 가며 읽는다. 그래서 한 번만 읽힐 페이지가 다른 세션의 자주 쓰는 페이지를 내보내지 않고,
+ *          스캔이 페이지마다 새 이미지를 할당하지도 않는다. read-ahead로 미리 읽은 페이지도 같은 프레임에 둔다.
+ *
+ *          hand가 가리키는 프레임부터 아무도 들고 있지 않은 (shared_ptr이 ring 하나뿐인) 프레임을 골라 다시 쓰므로,
+ *          커서가 보고 있는 페이지는 덮어쓰이지 않는다. 모든 프레임이 쓰이는 중이면 Load는 nullptr을 돌려준다.
+ *          ring의 페이지는 statement latch(shared) 아래에서 읽으므로 바뀌지 않는다 (dirty가 되지 않음).
+ *          스캔 스레드들과 I/O 스레드가 같이 쓰므로 mutex로 보호하며, 파일 읽기는 mutex 밖에서 한다.
+ */
+class ScanRing {
+private:
+    struct Frame {
+        PageKey key;
+        std::shared_ptr<Page> page;
+        bool loading;   // 읽는 중이라 아직 내줄 수 없음
+    };
+
+    std::mutex mutex_;
+    std::vector<Frame> frames_;
+    std::unordered_map<PageKey, size_t, PageKeyHash> index_;   // 읽은 (또는 읽는 중인) 페이지 -> 프레임
+    size_t hand_;
+
+    /**
+     * @brief hand부터 돌며 다시 쓸 수 있는 프레임을 찾아 key를 읽는 중으로 표시 (mutex_를 잡고 부름)
+     *
+     * @return 프레임 index. 모든 프레임이 쓰이는 중이면 frames_.size()
+     */
+    size_t Reserve(const PageKey &key);
+
+public:
+    /**
+     * @param capacity ring의 프레임 수
+     */
+    explicit ScanRing(size_t capacity);
+
+    /**
+     * @brief ring에 읽어 둔 페이지 (프레임은 ring에 남음)
+     *
+     * @return 없거나 아직 읽는 중이면 nullptr
+     */
+    std::shared_ptr<Page> Get(const PageKey &key);
+
+    /**
+     * @brief 프레임 하나를 골라 read로 key의 페이지를 읽어 넣음
+     *
+     * @param read 프레임의 Page에 페이지 이미지를 읽어 넣는 함수. 예외를 던지면 프레임은 비워짐
+     * @return 읽은 프레임. 이미 ring에 있으면 그 프레임, 다른 스레드가 읽는 중이거나 빈 프레임이 없으면 nullptr
+     */
+    std::shared_ptr<Page> Load(const PageKey &key, const std::function<void(Page &)> &read);
+
+    bool Contains(const PageKey &key);
+    size_t capacity() const { return frames_.size(); }
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include "server.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include "interpreter.h"
+#include "session_output.h"
+
+namespace {
+
+bool SendAll(int fd, const std::string &data)
+{
+  size_t done = 0;
+  while (done < data.size())
+  {
+    ssize_t n = send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (n <= 0)
+    {
+      return false;
+    }
+    done += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+bool IsQuit(const std::string &sql)
+{
+  return sql.compare(0, 4, "exit") == 0 || sql.compare(0, 4, "quit") == 0;
+}
+
+}  // namespace
+
+SessionServer::SessionServer(API *core, int port, std::size_t workers)
+    : core_(core), port_(port), worker_count_(workers), listen_fd_(-1), stop_(false)
+{
+  if (worker_count_ == 0)
+  {
+    worker_count_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (std::size_t i = 0; i < worker_count_; i++)
+  {
+    workers_.emplace_back(&SessionServer::Work, this);
+  }
+}
+
+SessionServer::~SessionServer()
+{
+  Stop();
+  for (std::thread &worker : workers_)
+  {
+    worker.join();
+  }
+  for (int fd : pending_)
+  {
+    close(fd);
+  }
+  if (listen_fd_ >= 0)
+  {
+    close(listen_fd_);
+  }
+}
+
+void SessionServer::Run()
+{
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+  {
+    throw std::runtime_error("소켓을 만들 수 없습니다.");
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);   // Stop이 다른 스레드에서 listen_fd_를 닫을 수 있음
+    listen_fd_ = fd;
+    if (stop_)
+    {
+      return;
+    }
+  }
+  int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(static_cast<uint16_t>(port_));
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, 128) != 0)
+  {
+    throw std::runtime_error("포트를 열 수 없습니다: " + std::to_string(port_));
+  }
+  std::cout << "[Server] listening on port " << port_ << " with " << worker_count_ << " workers" << std::endl;
+
+  while (true)
+  {
+    int conn = accept(fd, nullptr, nullptr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_)
+    {
+      if (conn >= 0)
+      {
+        close(conn);
+      }
+      return;
+    }
+    if (conn < 0)
+    {
+      if (errno == EINVAL)
+      {
+        return;   // Stop 전에 shutdown된 소켓
+      }
+      continue;   // EINTR, 연결이 먼저 끊김 등
+    }
+    pending_.push_back(conn);
+    cv_.notify_one();
+  }
+}
+
+void SessionServer::Stop()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stop_)
+  {
+    return;
+  }
+  stop_ = true;
+  if (listen_fd_ >= 0)
+  {
+    shutdown(listen_fd_, SHUT_RDWR);  // accept를 깨움
+  }
+  for (int fd : active_)
+  {
+    shutdown(fd, SHUT_RDWR);          // recv 중인 세션을 깨움
+  }
+  cv_.notify_all();
+}
+
+void SessionServer::Work()
+{
+  while (true)
+  {
+    int fd;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+      if (stop_)
+      {
+        return;
+      }
+      fd = pending_.front();
+      pending_.pop_front();
+      active_.insert(fd);
+    }
+    Serve(fd);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      active_.erase(fd);
+    }
+    close(fd);
+  }
+}
+
+void SessionServer::Serve(int fd)
+{
+  Interpreter itp(core_->OpenSession());
+  std::string pending;
+  char buf[4096];
+  while (true)
+  {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (n <= 0)
+    {
+      return;
+    }
+    pending.append(buf, static_cast<size_t>(n));
+
+    size_t found;
+    while ((found = pending.find(';')) != std::string::npos)
+    {
+      std::string sql = boost::algorithm::trim_copy(pending.substr(0, found + 1));
+      pending.erase(0, found + 1);
+      if (IsQuit(sql))
+      {
+        return;
+      }
+      std::ostringstream out;
+      {
+        SessionOutputScope scope(out, out);
+        try
+        {
+          itp.ExecSQL(sql);
+        }
+        catch (const std::exception &e)
+        {
+          out << "Error: " << e.what() << std::endl;
+        }
+      }
+      out << std::endl;
+      if (!SendAll(fd, out.str()))
+      {
+        return;
+      }
+    }
+    if (IsQuit(boost::algorithm::trim_copy(pending)))
+    {
+      return;
+    }
+  }
+}
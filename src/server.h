@@ -0,0 +1,71 @@
+#ifndef ABCDB_SERVER_H_
+#define ABCDB_SERVER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "api.h"
+
+/**
+ * @brief 여러 클라이언트 세션을 한 프로세스에서 실행하는 TCP 서버
+ * @details accept한 연결은 대기열에 넣고, 고정된 수의 worker 스레드가 하나씩 꺼내 연결이 끊길 때까지
+ *          그 세션의 문장을 실행한다. 세션마다 API::OpenSession으로 만든 Interpreter를 가지며, 받은 내용을
+ *          ';' 단위로 잘라 Interpreter::ExecSQL로 실행한 뒤 그 문장의 출력(SessionOut/SessionErr)을 돌려보낸다.
+ *          "exit" 또는 "quit"를 받으면 연결을 닫는다.
+ *
+ *          SELECT는 statement latch를 shared로 잡으므로 worker 수만큼 동시에 실행되고, 쓰기 문장은 하나씩 실행된다.
+ *          worker보다 많은 연결은 앞선 세션이 끝날 때까지 대기열에서 기다린다.
+ */
+class SessionServer
+{
+private:
+  API *core_;
+  int port_;
+  std::size_t worker_count_;
+  int listen_fd_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<int> pending_;   // 아직 worker가 맡지 않은 연결
+  std::set<int> active_;      // 실행 중인 세션 연결
+  bool stop_;
+  std::vector<std::thread> workers_;
+
+  void Work();
+
+  /**
+   * @brief 연결 하나의 세션을 끝날 때까지 실행
+   */
+  void Serve(int fd);
+
+public:
+  /**
+   * @param core 세션이 공유할 카탈로그와 버퍼 매니저를 가진 API
+   * @param port TCP 포트
+   * @param workers worker 스레드 수 (0이면 CPU 코어 수)
+   */
+  SessionServer(API *core, int port, std::size_t workers);
+  ~SessionServer();
+
+  /**
+   * @brief 포트를 열고 Stop이 불릴 때까지 연결을 받음
+   *
+   * @throw std::runtime_error 포트를 열 수 없음
+   */
+  void Run();
+
+  /**
+   * @brief 새 연결을 그만 받고 열린 세션을 끊음. 다른 스레드에서 불러도 됨
+   */
+  void Stop();
+
+  std::size_t worker_count() const { return worker_count_; }
+};
+
+#endif
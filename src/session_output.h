@@ -0,0 +1,47 @@
+#ifndef ABCDB_SESSION_OUTPUT_H_
+#define ABCDB_SESSION_OUTPUT_H_
+
+#include <iostream>
+
+namespace session_output_detail {
+inline thread_local std::ostream *out = nullptr;
+inline thread_local std::ostream *err = nullptr;
+}  // namespace session_output_detail
+
+/**
+ * @brief 현재 스레드가 실행 중인 세션의 출력. 세션 서버 밖(readline 모드)에서는 std::cout
+ */
+inline std::ostream &SessionOut() {
+  return session_output_detail::out ? *session_output_detail::out : std::cout;
+}
+
+/**
+ * @brief 현재 스레드가 실행 중인 세션의 오류 출력. 세션 서버 밖에서는 std::cerr
+ */
+inline std::ostream &SessionErr() {
+  return session_output_detail::err ? *session_output_detail::err : std::cerr;
+}
+
+/**
+ * @brief 살아 있는 동안 이 스레드의 SessionOut/SessionErr를 바꿈 (세션 서버 worker가 문장마다 사용)
+ */
+class SessionOutputScope {
+private:
+  std::ostream *prev_out_;
+  std::ostream *prev_err_;
+
+public:
+  SessionOutputScope(std::ostream &out, std::ostream &err)
+      : prev_out_(session_output_detail::out), prev_err_(session_output_detail::err) {
+    session_output_detail::out = &out;
+    session_output_detail::err = &err;
+  }
+  ~SessionOutputScope() {
+    session_output_detail::out = prev_out_;
+    session_output_detail::err = prev_err_;
+  }
+  SessionOutputScope(const SessionOutputScope &) = delete;
+  SessionOutputScope &operator=(const SessionOutputScope &) = delete;
+};
+
+#endif
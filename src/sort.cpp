@@ -0,0 +1,272 @@
+#include "sort.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "config.h"
+
+namespace {
+
+size_t KeyWidth(const Attribute &attr) {
+    return attr.data_type() == T_CHAR ? static_cast<size_t>(attr.length()) : 4;
+}
+
+/**
+ * @brief 정규화 키 앞 8바이트를 big-endian 정수로 (짧으면 0으로 채움)
+ */
+uint64_t LoadPrefix(const char *key, size_t len) {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < 8; i++) {
+        prefix = (prefix << 8) | (i < len ? static_cast<unsigned char>(key[i]) : 0);
+    }
+    return prefix;
+}
+
+}  // namespace
+
+ExternalSortCursor::ExternalSortCursor(std::unique_ptr<ResultCursor> input, std::vector<SortKey> keys, long limit,
+                                       size_t work_mem, const std::string &spill_prefix, Arena *arena)
+    : input_(std::move(input)), keys_(std::move(keys)), limit_(limit), work_mem_(work_mem),
+      spill_prefix_(spill_prefix), schema_(input_->Schema()), key_len_(0), rows_(schema_, arena), seq_(0), run_count_(0),
+      sorted_(false), merging_(false), pos_(0), pending_(-1) {
+    for (const SortKey &key : keys_) {
+        key_len_ += KeyWidth(schema_[key.column]);
+    }
+    scratch_.resize(key_len_);
+    size_t per_row = rows_.row_len() + key_len_ + sizeof(SortEntry);
+    top_n_ = limit_ >= 0 && static_cast<size_t>(limit_) <= work_mem_ / per_row;
+    fan_in_ = std::max<size_t>(2, std::min<size_t>(SORT_MAX_MERGE_RUNS, work_mem_ / Config::Instance().page_size()));
+}
+
+void ExternalSortCursor::Encode(const std::vector<TKeyView> &row, char *out) const {
+    for (const SortKey &key : keys_) {
+        const Attribute &attr = schema_[key.column];
+        const TKeyView &value = row[key.column];
+        unsigned char *dst = reinterpret_cast<unsigned char *>(out);
+        size_t width = KeyWidth(attr);
+        if (value.key() == nullptr) {
+            memset(dst, 0, width);      // NULL은 가장 앞
+        } else if (attr.data_type() == T_CHAR) {
+            size_t n = strnlen(value.key(), std::min<size_t>(value.length(), width));
+            memcpy(dst, value.key(), n);
+            memset(dst + n, 0, width - n);
+        } else {
+            uint32_t bits;
+            memcpy(&bits, value.key(), sizeof(bits));
+            if (attr.data_type() == T_FLOAT) {
+                float f;
+                memcpy(&f, value.key(), sizeof(f));
+                bits = f == 0.0f ? 0 : bits;    // -0 == 0
+                bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+            } else {
+                bits ^= 0x80000000u;
+            }
+            dst[0] = static_cast<unsigned char>(bits >> 24);
+            dst[1] = static_cast<unsigned char>(bits >> 16);
+            dst[2] = static_cast<unsigned char>(bits >> 8);
+            dst[3] = static_cast<unsigned char>(bits);
+        }
+        if (key.desc) {
+            for (size_t i = 0; i < width; i++) {
+                dst[i] = static_cast<unsigned char>(~dst[i]);
+            }
+        }
+        out += width;
+    }
+}
+
+bool ExternalSortCursor::Less(const SortEntry &a, const SortEntry &b) const {
+    if (a.prefix != b.prefix) {
+        return a.prefix < b.prefix;
+    }
+    if (key_len_ > 8) {
+        int c = memcmp(Key(a) + 8, Key(b) + 8, key_len_ - 8);
+        if (c != 0) {
+            return c < 0;
+        }
+    }
+    return a.seq < b.seq;
+}
+
+void ExternalSortCursor::AddRow(const std::vector<TKeyView> &row) {
+    rows_.Append(row);
+    size_t end = key_data_.size();
+    key_data_.resize(end + key_len_);
+    Encode(row, key_data_.data() + end);
+    entries_.push_back({LoadPrefix(key_data_.data() + end, key_len_), seq_++,
+                        static_cast<uint32_t>(rows_.size() - 1)});
+    if (!top_n_ && entries_.size() > 1 &&
+        rows_.bytes() + key_data_.size() + entries_.size() * sizeof(SortEntry) > work_mem_) {
+        SpillRun();
+    }
+}
+
+void ExternalSortCursor::AddTopN(const std::vector<TKeyView> &row) {
+    auto less = [this](const SortEntry &a, const SortEntry &b) { return Less(a, b); };
+    if (entries_.size() < static_cast<size_t>(limit_)) {
+        AddRow(row);
+        std::push_heap(entries_.begin(), entries_.end(), less);
+        return;
+    }
+    if (entries_.empty()) {
+        return;     // LIMIT 0
+    }
+    // 가장 큰 행보다 작을 때만 복사 (키가 같으면 먼저 들어온 행이 남음)
+    Encode(row, scratch_.data());
+    uint64_t prefix = LoadPrefix(scratch_.data(), key_len_);
+    uint64_t seq = seq_++;
+    const SortEntry &top = entries_.front();
+    if (prefix > top.prefix ||
+        (prefix == top.prefix && (key_len_ <= 8 || memcmp(scratch_.data() + 8, Key(top) + 8, key_len_ - 8) >= 0))) {
+        return;
+    }
+    std::pop_heap(entries_.begin(), entries_.end(), less);
+    SortEntry &slot = entries_.back();
+    slot.prefix = prefix;
+    slot.seq = seq;
+    rows_.Replace(slot.row, row);
+    memcpy(key_data_.data() + slot.row * key_len_, scratch_.data(), key_len_);
+    std::push_heap(entries_.begin(), entries_.end(), less);
+}
+
+void ExternalSortCursor::SpillRun() {
+    std::sort(entries_.begin(), entries_.end(),
+              [this](const SortEntry &a, const SortEntry &b) { return Less(a, b); });
+    std::unique_ptr<SpillFile> run(new SpillFile(spill_prefix_ + "r" + std::to_string(run_count_++)));
+    for (const SortEntry &entry : entries_) {
+        run->Add(rows_.row(entry.row), static_cast<int>(rows_.row_len()));
+    }
+    run->Finish();
+    rows_.Clear();
+    key_data_.clear();
+    entries_.clear();
+    runs_.push_back(std::move(run));
+    levels_.push_back(0);
+
+    // 같은 level의 run이 fan_in_개 모이면 합쳐 열린 파일 수와 마지막 merge의 입력 수를 줄임
+    while (runs_.size() >= fan_in_) {
+        size_t first = runs_.size() - fan_in_;
+        if (!std::all_of(levels_.begin() + first, levels_.end(), [this](int l) { return l == levels_.back(); })) {
+            break;
+        }
+        MergeRuns(first, fan_in_);
+    }
+}
+
+void ExternalSortCursor::MergeRuns(size_t first, size_t n) {
+    std::vector<std::unique_ptr<SpillFile>> inputs(std::make_move_iterator(runs_.begin() + first),
+                                                   std::make_move_iterator(runs_.begin() + first + n));
+    int level = *std::max_element(levels_.begin() + first, levels_.begin() + first + n) + 1;
+    runs_.erase(runs_.begin() + first, runs_.begin() + first + n);
+    levels_.erase(levels_.begin() + first, levels_.begin() + first + n);
+
+    std::unique_ptr<SpillFile> merged(new SpillFile(spill_prefix_ + "r" + std::to_string(run_count_++)));
+    StartMerge(std::move(inputs));
+    while (const char *row = MergeNext()) {
+        merged->Add(row, static_cast<int>(rows_.row_len()));
+    }
+    merged->Finish();
+    sources_.clear();
+    runs_.insert(runs_.begin() + first, std::move(merged));
+    levels_.insert(levels_.begin() + first, level);
+}
+
+void ExternalSortCursor::SortInput() {
+    sorted_ = true;
+    while (const std::vector<TKeyView> *row = input_->Next()) {
+        if (top_n_) {
+            AddTopN(*row);
+        } else {
+            AddRow(*row);
+        }
+    }
+    input_.reset();     // 고정한 페이지를 놓음
+
+    if (runs_.empty()) {
+        std::sort(entries_.begin(), entries_.end(),
+                  [this](const SortEntry &a, const SortEntry &b) { return Less(a, b); });
+        return;
+    }
+    if (!entries_.empty()) {
+        SpillRun();
+    }
+    while (runs_.size() > fan_in_) {
+        MergeRuns(0, fan_in_);
+    }
+    StartMerge(std::move(runs_));
+    runs_.clear();
+    levels_.clear();
+    merging_ = true;
+}
+
+bool ExternalSortCursor::Advance(MergeSource &source) {
+    source.row = source.run->NextRow();
+    if (source.row == nullptr) {
+        source.run.reset();     // 파일 삭제
+        return false;
+    }
+    rows_.View(source.row, values_);
+    Encode(values_, source.key.data());
+    return true;
+}
+
+void ExternalSortCursor::StartMerge(std::vector<std::unique_ptr<SpillFile>> runs) {
+    sources_.clear();
+    heap_.clear();
+    pending_ = -1;
+    for (std::unique_ptr<SpillFile> &run : runs) {
+        MergeSource source;
+        source.run = std::move(run);
+        source.key.resize(key_len_);
+        if (Advance(source)) {
+            heap_.push_back(sources_.size());
+            sources_.push_back(std::move(source));
+        }
+    }
+    std::make_heap(heap_.begin(), heap_.end(), [this](size_t a, size_t b) { return SourceAfter(a, b); });
+}
+
+bool ExternalSortCursor::SourceAfter(size_t a, size_t b) const {
+    int c = memcmp(sources_[a].key.data(), sources_[b].key.data(), key_len_);
+    return c != 0 ? c > 0 : a > b;      // 키가 같으면 앞의 run(먼저 들어온 행)이 먼저
+}
+
+const char *ExternalSortCursor::MergeNext() {
+    auto greater = [this](size_t a, size_t b) { return SourceAfter(a, b); };
+    if (pending_ >= 0) {
+        size_t s = static_cast<size_t>(pending_);
+        pending_ = -1;
+        if (Advance(sources_[s])) {
+            heap_.push_back(s);
+            std::push_heap(heap_.begin(), heap_.end(), greater);
+        }
+    }
+    if (heap_.empty()) {
+        return nullptr;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), greater);
+    size_t s = heap_.back();
+    heap_.pop_back();
+    pending_ = static_cast<int>(s);
+    return sources_[s].row;
+}
+
+const std::vector<TKeyView> *ExternalSortCursor::Next() {
+    if (!sorted_) {
+        SortInput();
+    }
+    if (merging_) {
+        const char *row = MergeNext();
+        if (row == nullptr) {
+            return nullptr;
+        }
+        rows_.View(row, row_);
+        return &row_;
+    }
+    if (pos_ >= entries_.size()) {
+        return nullptr;
+    }
+    rows_.View(rows_.row(entries_[pos_++].row), row_);
+    return &row_;
+}
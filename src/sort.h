@@ -0,0 +1,139 @@
+#ifndef ABCDB_SORT_H_
+#define ABCDB_SORT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "catalog_manager.h"
+#include "sql_statement.h"
+#include "cursor.h"
+#include "spill_file.h"
+
+#define SORT_MAX_MERGE_RUNS 64      // k-way merge가 한 번에 합치는 최대 run 수 (run마다 페이지 하나를 메모리에 둠)
+
+/**
+ * @brief ORDER BY 속성 하나
+ */
+struct SortKey {
+    int column;     // 입력 행의 속성 위치
+    bool desc;
+};
+
+/**
+ * @brief 입력 행을 모두 읽어 ORDER BY 순서로 돌려주는 커서 (external merge sort)
+ * @details 행마다 정렬 키를 memcmp 순서가 값 순서와 같은 바이트열로 바꿔 둔다 (정수는 부호 비트를 뒤집은 big-endian,
+ *          실수는 IEEE 비트를 부호에 따라 뒤집은 big-endian, CHAR는 NULL 뒤를 0으로 채운 바이트, DESC는 모든 비트를 반전).
+ *          정렬 배열에는 키 앞 8바이트를 정수로 담아 대부분의 비교가 정수 비교 하나로 끝나고, 같을 때만 키 전체를 memcmp한다.
+ *
+ *          행과 키가 work_mem를 넘으면 지금까지 모은 행을 정렬해 run 하나로 SpillFile에 쓴다. 입력이 끝나면 run들을
+ *          min-heap으로 k-way merge하며, run이 SORT_MAX_MERGE_RUNS(또는 work_mem / page_size)보다 많으면 앞의 run들을
+ *          먼저 합쳐 새 run으로 쓴다. 입력이 work_mem 안에 들어가면 파일을 쓰지 않는다.
+ *
+ *          limit이 있고 limit개 행이 work_mem 안에 들어가면 run을 만들지 않고 limit개짜리 max-heap(top-N)만 유지한다.
+ *          새 행은 키만 만들어 heap의 가장 큰 행과 비교하고, 더 작을 때만 그 자리에 복사한다.
+ *
+ *          키가 같은 행은 입력 순서를 유지한다.
+ */
+class ExternalSortCursor : public ResultCursor {
+private:
+    /**
+     * @brief 정렬할 행 하나. prefix는 정규화 키 앞 8바이트 (big-endian)
+     */
+    struct SortEntry {
+        uint64_t prefix;
+        uint64_t seq;       // 입력 순서 (키가 같을 때 비교)
+        uint32_t row;       // rows_와 key_data_의 행 번호
+    };
+
+    /**
+     * @brief k-way merge 입력 run 하나의 현재 행
+     */
+    struct MergeSource {
+        std::unique_ptr<SpillFile> run;
+        const char *row;
+        std::vector<char> key;
+    };
+
+    std::unique_ptr<ResultCursor> input_;
+    std::vector<SortKey> keys_;
+    long limit_;                        // -1이면 없음
+    size_t work_mem_;
+    std::string spill_prefix_;
+    std::vector<Attribute> schema_;
+    size_t key_len_;
+    bool top_n_;                        // limit개 행만 heap에 유지
+    size_t fan_in_;                     // 한 번에 합치는 run 수
+
+    RowBuffer rows_;                    // 현재 run(또는 top-N heap)의 행
+    std::vector<char> key_data_;        // 행별 정규화 키 (key_len_ bytes씩)
+    std::vector<SortEntry> entries_;
+    std::vector<char> scratch_;         // 입력 행 하나의 정규화 키
+    uint64_t seq_;
+    std::vector<std::unique_ptr<SpillFile>> runs_;   // 입력 순서의 run
+    std::vector<int> levels_;           // run별로 합쳐진 횟수. 같은 level의 run이 fan_in_개 모이면 하나로 합침
+    size_t run_count_;                  // 만든 run 파일 수 (파일 이름)
+
+    bool sorted_;
+    bool merging_;
+    size_t pos_;                        // 메모리에서 정렬했을 때 다음 entries_
+    std::vector<MergeSource> sources_;
+    std::vector<size_t> heap_;          // sources_ 위치의 min-heap
+    int pending_;                       // 지난 Next가 돌려준 행의 source. 다음 Next에서 읽어 나감
+    std::vector<TKeyView> row_;
+    std::vector<TKeyView> values_;      // spill한 행을 키로 바꿀 때 씀
+
+    void Encode(const std::vector<TKeyView> &row, char *out) const;
+    bool Less(const SortEntry &a, const SortEntry &b) const;
+    void AddRow(const std::vector<TKeyView> &row);
+    void AddTopN(const std::vector<TKeyView> &row);
+
+    const char *Key(const SortEntry &entry) const { return key_data_.data() + entry.row * key_len_; }
+
+    /**
+     * @brief 모은 행을 정렬해 run 파일 하나로 씀
+     */
+    void SpillRun();
+
+    /**
+     * @brief runs_[first, first + n)을 merge해 그 자리에 run 하나로 씀
+     */
+    void MergeRuns(size_t first, size_t n);
+    void SortInput();
+
+    /**
+     * @brief runs를 k-way merge할 준비를 함
+     */
+    void StartMerge(std::vector<std::unique_ptr<SpillFile>> runs);
+
+    /**
+     * @brief 다음으로 작은 행 (merge 중). 더 없으면 nullptr
+     */
+    const char *MergeNext();
+    bool Advance(MergeSource &source);
+
+    /**
+     * @brief source a의 현재 행이 b보다 뒤에 나와야 하는지 (min-heap 비교)
+     */
+    bool SourceAfter(size_t a, size_t b) const;
+
+public:
+    /**
+     * @param limit 결과로 쓸 앞의 행 수 (LIMIT), 없으면 -1
+     * @param spill_prefix run 파일 경로 앞부분 (디렉토리는 있어야 함)
+     * @param arena 메모리에 모은 행을 담을 arena. nullptr이면 커서가 따로 잡음
+     */
+    ExternalSortCursor(std::unique_ptr<ResultCursor> input, std::vector<SortKey> keys, long limit, size_t work_mem,
+                       const std::string &spill_prefix, Arena *arena = nullptr);
+
+    const std::vector<Attribute> &Schema() { return schema_; }
+    const std::vector<TKeyView> *Next();
+
+    /**
+     * @brief 입력을 run 파일로 나눠 썼는지
+     */
+    bool spilled() const { return run_count_ > 0; }
+};
+
+#endif
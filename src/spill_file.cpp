@@ -0,0 +1,107 @@
+#include "spill_file.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "config.h"
+#include "exceptions.h"
+#include "metrics.h"
+
+/*=======================================SpillFile================================================ */
+SpillFile::SpillFile(const std::string &path)
+    : path_(path), fd_(open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)), page_size_(Config::Instance().page_size()),
+      page_count_(0), rows_(0), read_page_(0), slot_(0) {
+    if (fd_ < 0) {
+        throw std::runtime_error("임시 파일을 만들 수 없습니다: " + path);
+    }
+}
+
+SpillFile::~SpillFile() {
+    close(fd_);
+    std::remove(path_.c_str());
+}
+
+void SpillFile::Add(const char *row, int length) {
+    if (!tail_ || !tail_->HasEnoughSpace(length)) {
+        if (tail_) {
+            Flush();
+        }
+        std::shared_ptr<Page> page = std::make_shared<Page>(path_, 0);
+        page->SetFilename(path_);
+        page->ApplyFormat(PageFormat());
+        if (!page->HasEnoughSpace(length)) {
+            throw RowTooLargeException();
+        }
+        tail_ = page;
+    }
+    tail_->InsertRecord(row, length);
+    rows_++;
+}
+
+void SpillFile::Flush() {
+    const char *buf = tail_->GetRawData();
+    off_t offset = static_cast<off_t>(page_count_ * page_size_);
+    size_t done = 0;
+    while (done < page_size_) {
+        ssize_t n = pwrite(fd_, buf + done, page_size_ - done, offset + done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw std::runtime_error("임시 파일에 쓸 수 없습니다: " + path_);
+        }
+        done += static_cast<size_t>(n);
+    }
+    Metrics::Instance().Add(Metrics::PAGES_WRITTEN);
+    page_count_++;
+    tail_.reset();
+}
+
+void SpillFile::Finish() {
+    if (tail_) {
+        Flush();
+    }
+    read_page_ = 0;
+    slot_ = 0;
+    page_.reset();
+}
+
+const char *SpillFile::NextRow() {
+    while (true) {
+        if (page_ && slot_ < page_->GetSlotCount()) {
+            RecordRef record;
+            if (page_->GetRecord(slot_++, &record)) {
+                return record.data;
+            }
+            continue;
+        }
+        if (read_page_ >= page_count_) {
+            return nullptr;
+        }
+        if (!page_) {
+            page_ = std::make_shared<Page>(path_, 0);
+        }
+        char *buf = page_->GetRawData();
+        off_t offset = static_cast<off_t>(read_page_ * page_size_);
+        size_t done = 0;
+        while (done < page_size_) {
+            ssize_t n = pread(fd_, buf + done, page_size_ - done, offset + done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                throw std::runtime_error("임시 파일을 읽을 수 없습니다: " + path_);
+            }
+            done += static_cast<size_t>(n);
+        }
+        Metrics::Instance().Add(Metrics::PAGES_READ);
+        if (!page_->ReadHeader()) {
+            throw std::runtime_error("임시 파일을 읽을 수 없습니다: " + path_);
+        }
+        read_page_++;
+        slot_ = 0;
+    }
+}
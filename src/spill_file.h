@@ -0,0 +1,67 @@
+#ifndef ABCDB_SPILL_FILE_H_
+#define ABCDB_SPILL_FILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "page.h"
+
+#define TEMP_DIR_NAME ".tmp/"           // 데이터 경로 아래 spill 파일을 두는 디렉토리 (시작할 때 비움, 데이터베이스 이름과 겹치지 않음)
+
+/**
+ * @brief 메모리에 두지 못한 행을 내려 두는 임시 파일 (slotted page를 차례로 붙인 파일)
+ * @details 페이지를 버퍼 풀 밖에서 채워 가득 차면 파일 끝에 pwrite로 쓰고, 읽을 때는 페이지 하나를 돌려 쓰며 pread로
+ *          처음부터 읽는다. 테이블 파일이 아니므로 page directory와 free space map이 없고 fsync도 하지 않는다
+ *          (crash 뒤에는 시작할 때 TEMP_DIR_NAME을 비움). 버퍼 풀과 파일 캐시에 올리지 않으므로 같이 실행 중인
+ *          checkpoint, background writer와 공유하는 상태가 없고 WAL에도 남지 않는다. 소멸될 때 파일을 지운다.
+ */
+class SpillFile {
+private:
+    std::string path_;
+    int fd_;
+    size_t page_size_;
+    std::shared_ptr<Page> tail_;    // 채우는 중인 (아직 쓰지 않은) 페이지
+    size_t page_count_;             // 파일에 쓴 페이지 수
+    size_t rows_;
+
+    // 읽는 위치
+    size_t read_page_;
+    int slot_;
+    std::shared_ptr<Page> page_;    // 읽은 페이지 (페이지마다 이미지를 덮어씀)
+
+    void Flush();
+
+public:
+    /**
+     * @throw std::runtime_error 파일을 만들 수 없음
+     */
+    explicit SpillFile(const std::string &path);
+    SpillFile(const SpillFile &) = delete;
+    SpillFile &operator=(const SpillFile &) = delete;
+    ~SpillFile();
+
+    /**
+     * @brief 행 하나를 붙임
+     *
+     * @throw RowTooLargeException 빈 페이지에도 들어가지 않는 행
+     * @throw std::runtime_error 페이지를 쓸 수 없음
+     */
+    void Add(const char *row, int length);
+
+    /**
+     * @brief 남은 페이지를 쓰고 처음부터 읽을 준비를 함
+     */
+    void Finish();
+
+    /**
+     * @brief 다음 행. Finish 뒤에 부름
+     *
+     * @throw std::runtime_error 페이지를 읽을 수 없음
+     * @return const char* 다음 NextRow 호출 전까지 유효. 더 없으면 nullptr
+     */
+    const char *NextRow();
+
+    size_t rows() const { return rows_; }
+};
+
+#endif
@@ -1,11 +1,13 @@
 #include "sql_statement.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <cstring> // memcpy 사용을 위해 추가
 
 #include <boost/algorithm/string.hpp>
 
+#include "arena.h"
 #include "commons.h"
 #include "exceptions.h"
 
@@ -21,6 +23,18 @@ TKey::TKey(int keytype, int length)
   else
     length_ = 4;
   key_ = new char[length_];
+  owned_ = true;
+}
+
+TKey::TKey(int keytype, int length, Arena &arena)
+{
+  key_type_ = keytype;
+  if (keytype == 2)
+    length_ = length;
+  else
+    length_ = 4;
+  key_ = arena.AllocateBytes(length_);
+  owned_ = false;
 }
 
 // 복사 생성자
@@ -29,23 +43,63 @@ TKey::TKey(const TKey &t1)
   key_type_ = t1.key_type_;
   length_ = t1.length_;
   key_ = new char[length_];
+  owned_ = true;
   memcpy(key_, t1.key_, length_);
 }
 
+TKey::TKey(TKey &&t1) noexcept
+    : key_type_(t1.key_type_), key_(t1.key_), length_(t1.length_), owned_(t1.owned_)
+{
+  t1.key_ = NULL;
+  t1.length_ = 0;
+  t1.owned_ = false;
+}
+
+TKey::TKey(const TKeyView &view)
+{
+  key_type_ = view.key_type();
+  length_ = view.length();
+  key_ = new char[length_];
+  owned_ = true;
+  memcpy(key_, view.key(), length_);
+}
+
 // 대입 연산자
 TKey &TKey::operator=(const TKey &t1)
 {
   if (this != &t1)
   { // 자기 자신과의 대입 방지
     key_type_ = t1.key_type_;
+    if (!owned_ || length_ != t1.length_)
+    { // 길이가 같은 소유 버퍼는 그대로 씀
+      if (owned_)
+        delete[] key_;
+      key_ = new char[t1.length_];
+      owned_ = true;
+    }
     length_ = t1.length_;
-    delete[] key_;            // 기존 메모리 해제
-    key_ = new char[length_]; // 새로운 메모리 할당
     memcpy(key_, t1.key_, length_);
   }
   return *this;
 }
 
+TKey &TKey::operator=(TKey &&t1) noexcept
+{
+  if (this != &t1)
+  {
+    if (owned_)
+      delete[] key_;
+    key_type_ = t1.key_type_;
+    key_ = t1.key_;
+    length_ = t1.length_;
+    owned_ = t1.owned_;
+    t1.key_ = NULL;
+    t1.length_ = 0;
+    t1.owned_ = false;
+  }
+  return *this;
+}
+
 // 값 읽기 (char*)
 void TKey::ReadValue(const char *content)
 {
@@ -65,7 +119,10 @@ void TKey::ReadValue(const char *content)
   break;
   case 2:
   {
-    memcpy(key_, content, length_);
+    // 값보다 긴 부분은 0으로 채움 (값 끝을 넘어 읽지 않음)
+    size_t n = strnlen(content, length_);
+    memcpy(key_, content, n);
+    memset(key_ + n, 0, length_ - n);
   }
   break;
   }
@@ -90,7 +147,9 @@ void TKey::ReadValue(std::string str)
   break;
   case 2:
   {
-    memcpy(key_, str.c_str(), length_);
+    size_t n = std::min(str.size(), static_cast<size_t>(length_));
+    memcpy(key_, str.data(), n);
+    memset(key_ + n, 0, length_ - n);
   }
   break;
   }
@@ -99,96 +158,133 @@ void TKey::ReadValue(std::string str)
 // 소멸자
 TKey::~TKey()
 {
-  if (key_ != NULL)
+  if (owned_ && key_ != NULL)
     delete[] key_;
 }
 
 // 스트림 연산자 오버로딩
 std::ostream &operator<<(std::ostream &out, const TKey &object)
+{
+  return out << TKeyView(object);
+}
+
+// 비교 연산자 오버로딩
+bool TKey::operator<(const TKey &t1) const
+{
+  return TKeyView(*this) < TKeyView(t1);
+}
+
+bool TKey::operator>(const TKey &t1) const
+{
+  return TKeyView(*this) > TKeyView(t1);
+}
+
+bool TKey::operator<=(const TKey &t1) const
+{
+  return !(operator>(t1));
+}
+
+bool TKey::operator>=(const TKey &t1) const
+{
+  return !(operator<(t1));
+}
+
+bool TKey::operator==(const TKey &t1) const
+{
+  return TKeyView(*this) == TKeyView(t1);
+}
+
+bool TKey::operator!=(const TKey &t1) const
+{
+  return !(operator==(t1));
+}
+
+// 키 비교. 값이 페이지 안의 임의 위치에 있을 수 있으므로 memcpy로 읽음
+// 음수: a < b, 0: a == b, 양수: a > b
+static int CompareKey(int key_type, const char *a, const char *b, int length)
+{
+  switch (key_type)
+  {
+  case 0:
+  {
+    int x, y;
+    memcpy(&x, a, sizeof(int));
+    memcpy(&y, b, sizeof(int));
+    return (x > y) - (x < y);
+  }
+  case 1:
+  {
+    float x, y;
+    memcpy(&x, a, sizeof(float));
+    memcpy(&y, b, sizeof(float));
+    return (x > y) - (x < y);
+  }
+  case 2:
+    return strncmp(a, b, length);
+  default:
+    return 0;
+  }
+}
+
+// 스트림 연산자 오버로딩
+std::ostream &operator<<(std::ostream &out, const TKeyView &object)
 {
   switch (object.key_type_)
   {
   case 0:
   {
     int a;
-    memcpy(&a, object.key_, object.length_);
+    memcpy(&a, object.key_, sizeof(int));
     out << std::setw(9) << std::left << a;
   }
   break;
   case 1:
   {
     float a;
-    memcpy(&a, object.key_, object.length_);
+    memcpy(&a, object.key_, sizeof(float));
     out << std::setw(9) << std::left << a;
   }
   break;
   case 2:
   {
-    out << std::setw(9) << std::left << object.key_;
+    // 페이지 안의 CHAR 값은 NULL로 끝나지 않을 수 있음
+    out << std::setw(9) << std::left << std::string(object.key_, strnlen(object.key_, object.length_));
   }
   break;
+  default:
+    out << std::setw(9) << std::left << "NULL";  // 값 없음 (빈 입력의 MIN/MAX)
+    break;
   }
 
   return out;
 }
 
-// 비교 연산자 오버로딩
-bool TKey::operator<(const TKey &t1) const
+bool TKeyView::operator<(const TKeyView &t1) const
 {
-  switch (t1.key_type_)
-  {
-  case 0:
-    return *(int *)key_ < *(int *)t1.key_;
-  case 1:
-    return *(float *)key_ < *(float *)t1.key_;
-  case 2:
-    return (strncmp(key_, t1.key_, length_) < 0);
-  default:
-    return false;
-  }
+  return CompareKey(t1.key_type_, key_, t1.key_, length_) < 0;
 }
 
-bool TKey::operator>(const TKey &t1) const
+bool TKeyView::operator>(const TKeyView &t1) const
 {
-  switch (t1.key_type_)
-  {
-  case 0:
-    return *(int *)key_ > *(int *)t1.key_;
-  case 1:
-    return *(float *)key_ > *(float *)t1.key_;
-  case 2:
-    return (strncmp(key_, t1.key_, length_) > 0);
-  default:
-    return false;
-  }
+  return CompareKey(t1.key_type_, key_, t1.key_, length_) > 0;
 }
 
-bool TKey::operator<=(const TKey &t1) const
+bool TKeyView::operator<=(const TKeyView &t1) const
 {
   return !(operator>(t1));
 }
 
-bool TKey::operator>=(const TKey &t1) const
+bool TKeyView::operator>=(const TKeyView &t1) const
 {
   return !(operator<(t1));
 }
 
-bool TKey::operator==(const TKey &t1) const
+bool TKeyView::operator==(const TKeyView &t1) const
 {
-  switch (t1.key_type_)
-  {
-  case 0:
-    return *(int *)key_ == *(int *)t1.key_;
-  case 1:
-    return *(float *)key_ == *(float *)t1.key_;
-  case 2:
-    return (strncmp(key_, t1.key_, length_) == 0);
-  default:
-    return false;
-  }
+  return t1.key_type_ >= 0 && t1.key_type_ <= 2 && CompareKey(t1.key_type_, key_, t1.key_, length_) == 0;
 }
 
-bool TKey::operator!=(const TKey &t1) const
+bool TKeyView::operator!=(const TKeyView &t1) const
 {
   return !(operator==(t1));
 }
@@ -247,4 +343,40 @@ int SQL::ParseDataType(std::vector<std::string> sql_vector, Attribute &attr,
   }
 
   return pos;
-}
\ No newline at end of file
+}
+
+void SQLInsert::BindParameters(const std::vector<SQLValue> &params)
+{
+  if (static_cast<int>(params.size()) != param_count_)
+  {
+    throw SyntaxErrorException();
+  }
+  for (std::vector<SQLValue> &row : rows_)
+  {
+    for (SQLValue &value : row)
+    {
+      if (value.param >= 0)
+      {
+        value = params[value.param];
+      }
+    }
+  }
+  param_count_ = 0;
+}
+
+void SQLSelect::BindParameters(const std::vector<SQLValue> &params)
+{
+  if (static_cast<int>(params.size()) != param_count_)
+  {
+    throw SyntaxErrorException();
+  }
+  for (SQLWhere &where : wheres_)
+  {
+    if (where.param >= 0)
+    {
+      where.value = params[where.param].value;
+      where.param = -1;
+    }
+  }
+  param_count_ = 0;
+}
@@ -1,9 +1,11 @@
 #ifndef SQL_STATEMENT_H_
 #define SQL_STATEMENT_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 #include "catalog_manager.h"
+#include "commons.h"
 
 class CatalogManager;
 class Database;
@@ -11,14 +13,8 @@ class Table;
 class Attribute;
 class Index;
 
-enum SignType {
-    SIGN_EQ,   // =
-    SIGN_NE,   // <>
-    SIGN_LT,   // <
-    SIGN_LE,   // <=
-    SIGN_GT,   // >
-    SIGN_GE    // >=
-};
+class TKeyView;
+class Arena;
 
 class TKey
 {
@@ -26,24 +22,36 @@ private:
   int key_type_;
   char *key_;
   int length_;
+  bool owned_;  // key_를 new char[]로 잡음. false면 Arena의 메모리
 
 public:
   // 생성자
   TKey(int keytype, int length);
 
-  // 복사 생성자
+  // 값 버퍼를 arena에 잡음 (arena가 Reset되거나 소멸되기 전까지만 유효, 따로 해제하지 않음)
+  TKey(int keytype, int length, Arena &arena);
+
+  // 복사 생성자 (arena의 값도 복사본은 소유)
   TKey(const TKey &t1);
 
+  // 이동 생성자 (버퍼를 넘겨받음)
+  TKey(TKey &&t1) noexcept;
+
+  // view가 가리키는 값을 복사해 소유
+  explicit TKey(const TKeyView &view);
+
   // 대입 연산자
   TKey &operator=(const TKey &t1);
+  TKey &operator=(TKey &&t1) noexcept;
 
   // 값 읽기
   void ReadValue(const char *content);
   void ReadValue(std::string str);
 
-  int key_type() { return key_type_; }
+  int key_type() const { return key_type_; }
   char *key() { return key_; };
-  int length() { return length_; }
+  const char *key() const { return key_; }
+  int length() const { return length_; }
 
   // 소멸자
   ~TKey();
@@ -59,6 +67,39 @@ public:
   bool operator!=(const TKey &t1) const;
 };
 
+/**
+ * @brief 값을 소유하지 않고 페이지 프레임 안의 바이트를 가리키는 TKey
+ * @details 레코드를 읽을 때 값마다 new char[]를 하지 않기 위해 사용한다.
+ *          가리키는 페이지가 고정되어 있는 동안만 유효하며, 보관하려면 TKey(view)로 복사해야 한다.
+ */
+class TKeyView
+{
+private:
+  int key_type_;
+  const char *key_;
+  int length_;
+
+public:
+  TKeyView() : key_type_(-1), key_(nullptr), length_(0) {}
+  TKeyView(int keytype, const char *key, int length)
+      : key_type_(keytype), key_(key), length_(length) {}
+  explicit TKeyView(const TKey &t1)
+      : key_type_(t1.key_type()), key_(t1.key()), length_(t1.length()) {}
+
+  int key_type() const { return key_type_; }
+  const char *key() const { return key_; }
+  int length() const { return length_; }
+
+  friend std::ostream &operator<<(std::ostream &out, const TKeyView &object);
+
+  bool operator<(const TKeyView &t1) const;
+  bool operator>(const TKeyView &t1) const;
+  bool operator<=(const TKeyView &t1) const;
+  bool operator>=(const TKeyView &t1) const;
+  bool operator==(const TKeyView &t1) const;
+  bool operator!=(const TKeyView &t1) const;
+};
+
 class SQL
 {
 protected:
@@ -101,33 +142,84 @@ class SQLCreateTable : public SQL
 private:
   std::string tb_name_;
   std::vector<Attribute> attrs_;
+  int storage_;   // STORAGE_ROW, STORAGE_PAX (USING ROW | PAX)
 
 public:
-  SQLCreateTable() { sql_type_ = 31; }
+  SQLCreateTable() : storage_(STORAGE_ROW) { sql_type_ = 31; }
   std::string tb_name() { return tb_name_; }
   void set_tb_name(std::string tbname) { tb_name_ = tbname; }
   std::vector<Attribute> attrs() { return attrs_; };
   void set_attrs(std::vector<Attribute> att) { attrs_ = att; }
+  int storage() const { return storage_; }
+  void set_storage(int storage) { storage_ = storage; }
 };
 
-typedef struct
+class SQLCreateIndex : public SQL
+{
+private:
+  std::string index_name_;
+  std::string tb_name_;
+  std::string col_name_;
+
+public:
+  SQLCreateIndex() { sql_type_ = 32; }
+  std::string index_name() { return index_name_; }
+  void set_index_name(std::string idxname) { index_name_ = idxname; }
+  std::string tb_name() { return tb_name_; }
+  void set_tb_name(std::string tbname) { tb_name_ = tbname; }
+  std::string col_name() { return col_name_; }
+  void set_col_name(std::string colname) { col_name_ = colname; }
+};
+
+class SQLDropIndex : public SQL
+{
+private:
+  std::string index_name_;
+
+public:
+  SQLDropIndex() { sql_type_ = 52; }
+  std::string index_name() { return index_name_; }
+  void set_index_name(std::string idxname) { index_name_ = idxname; }
+};
+
+typedef struct SQLValue
 {
   int data_type;
   std::string value;
+  int param = -1;  // PREPARE 문의 '?' 자리 번호 (0부터). -1이면 값
 } SQLValue;
 
 class SQLInsert : public SQL
 {
 private:
   std::string tb_name_;
-  std::vector<SQLValue> values_;
+  std::vector<std::vector<SQLValue> > rows_;  // VALUES (...), (...) 의 각 행
+  int param_count_;                           // '?' 자리 수
 
 public:
-  SQLInsert() { sql_type_ = 70; }
+  SQLInsert() : rows_(1), param_count_(0) { sql_type_ = 70; }
   std::string tb_name() { return tb_name_; }
   void set_tb_name(std::string tbname) { tb_name_ = tbname; }
-  std::vector<SQLValue> &values() { return values_; }
-  void set_values(const std::vector<SQLValue> &vals) { values_ = vals; }
+  /**
+   * @brief 첫 번째 행의 값 (한 행짜리 INSERT용)
+   */
+  std::vector<SQLValue> &values() { return rows_.front(); }
+  void set_values(const std::vector<SQLValue> &vals) { rows_.assign(1, vals); }
+  std::vector<std::vector<SQLValue> > &rows() { return rows_; }
+  void set_rows(const std::vector<std::vector<SQLValue> > &rows) { rows_ = rows; }
+  /**
+   * @brief 다른 INSERT의 행들을 뒤에 붙임 (EXEC에서 같은 테이블 INSERT를 묶을 때 사용)
+   */
+  void AppendRows(SQLInsert &other) { rows_.insert(rows_.end(), other.rows_.begin(), other.rows_.end()); }
+
+  int param_count() const { return param_count_; }
+  void set_param_count(int count) { param_count_ = count; }
+  /**
+   * @brief '?' 자리를 params의 값으로 바꿈
+   *
+   * @throw SyntaxErrorException 값 개수가 자리 수와 다름
+   */
+  void BindParameters(const std::vector<SQLValue> &params);
 };
 
 class SQLExec : public SQL
@@ -141,25 +233,144 @@ public:
   void set_file_name(std::string fname) { file_name_ = fname; }
 };
 
-typedef struct
+typedef struct SQLWhere
 {
   std::string key;
   int sign_type;
   std::string value;
+  int param = -1;  // PREPARE 문의 '?' 자리 번호 (0부터). -1이면 value가 값
 } SQLWhere;
 
+typedef struct SQLSelectItem
+{
+  int aggregate;        // AGG_NONE, AGG_COUNT, ...
+  std::string column;   // COUNT(*)이면 비어 있음
+} SQLSelectItem;
+
+typedef struct SQLOrderItem
+{
+  std::string column;   // "속성" 또는 "테이블.속성"
+  bool desc;            // DESC
+} SQLOrderItem;
+
+typedef struct SQLJoin
+{
+  std::string tb_name;    // 비어 있으면 JOIN 없음
+  std::string left_key;   // ON의 두 속성 ("속성" 또는 "테이블.속성", 어느 쪽 테이블이든 됨)
+  std::string right_key;
+} SQLJoin;
+
 class SQLSelect : public SQL
 {
 private:
   std::string tb_name_;
+  std::vector<std::string> columns_;  // SELECT 목록. 비어 있으면 *
+  std::vector<SQLSelectItem> items_;  // 집계나 GROUP BY가 있을 때의 SELECT 목록 (columns_는 비어 있음)
+  std::vector<std::string> group_by_;
+  std::vector<SQLOrderItem> order_by_;
+  SQLJoin join_;
   std::vector<SQLWhere> wheres_;
+  long limit_;                        // LIMIT n, 없으면 -1
+  int param_count_;
 
 public:
-  SQLSelect() { sql_type_ = 90; }
+  SQLSelect() : limit_(-1), param_count_(0) { sql_type_ = 90; }
   std::string tb_name() { return tb_name_; }
   void set_tb_name(std::string tbname) { tb_name_ = tbname; }
+  const std::vector<std::string> &columns() const { return columns_; }
+  void set_columns(const std::vector<std::string> &columns) { columns_ = columns; }
+  const std::vector<SQLSelectItem> &items() const { return items_; }
+  void set_items(const std::vector<SQLSelectItem> &items) { items_ = items; }
+  const std::vector<std::string> &group_by() const { return group_by_; }
+  void set_group_by(const std::vector<std::string> &group_by) { group_by_ = group_by; }
+  const std::vector<SQLOrderItem> &order_by() const { return order_by_; }
+  void set_order_by(const std::vector<SQLOrderItem> &order_by) { order_by_ = order_by; }
+  bool IsAggregate() const { return !items_.empty(); }
+  const SQLJoin &join() const { return join_; }
+  void set_join(const SQLJoin &join) { join_ = join; }
+  bool HasJoin() const { return !join_.tb_name.empty(); }
   std::vector<SQLWhere> &wheres() { return wheres_; }
   void set_wheres(const std::vector<SQLWhere> &ws) { wheres_ = ws; }
+  long limit() const { return limit_; }
+  void set_limit(long limit) { limit_ = limit; }
+
+  int param_count() const { return param_count_; }
+  void set_param_count(int count) { param_count_ = count; }
+  /**
+   * @brief '?' 자리를 params의 값으로 바꿈
+   *
+   * @throw SyntaxErrorException 값 개수가 자리 수와 다름
+   */
+  void BindParameters(const std::vector<SQLValue> &params);
+};
+
+/**
+ * @brief EXPLAIN ANALYZE <SELECT>. SELECT를 실행하되 결과 대신 행 수, 시간, 실행 통계를 출력
+ */
+class SQLExplain : public SQL
+{
+private:
+  std::unique_ptr<SQLSelect> select_;
+
+public:
+  SQLExplain() { sql_type_ = 91; }
+  SQLSelect *select() { return select_.get(); }
+  /**
+   * @brief 실행할 SELECT의 소유권을 넘겨받음
+   */
+  void set_select(SQLSelect *select) { select_.reset(select); }
+};
+
+/**
+ * @brief PREPARE name AS <INSERT 또는 SELECT>. 문장은 '?' 자리를 가질 수 있음
+ */
+class SQLPrepare : public SQL
+{
+private:
+  std::string name_;
+  std::unique_ptr<SQL> statement_;
+
+public:
+  SQLPrepare() { sql_type_ = 120; }
+  std::string name() { return name_; }
+  void set_name(std::string name) { name_ = name; }
+  SQL *statement() { return statement_.get(); }
+  /**
+   * @brief 준비할 문장의 소유권을 넘겨받음
+   */
+  void set_statement(SQL *statement) { statement_.reset(statement); }
+  SQL *release_statement() { return statement_.release(); }
+};
+
+/**
+ * @brief EXECUTE name [USING value, ...]
+ */
+class SQLExecute : public SQL
+{
+private:
+  std::string name_;
+  std::vector<SQLValue> params_;
+
+public:
+  SQLExecute() { sql_type_ = 121; }
+  std::string name() { return name_; }
+  void set_name(std::string name) { name_ = name; }
+  std::vector<SQLValue> &params() { return params_; }
+  void set_params(const std::vector<SQLValue> &params) { params_ = params; }
+};
+
+/**
+ * @brief DEALLOCATE name
+ */
+class SQLDeallocate : public SQL
+{
+private:
+  std::string name_;
+
+public:
+  SQLDeallocate() { sql_type_ = 122; }
+  std::string name() { return name_; }
+  void set_name(std::string name) { name_ = name; }
 };
 
 #endif
\ No newline at end of file
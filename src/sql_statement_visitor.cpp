@@ -4,11 +4,40 @@
 #include <sstream>
 #include <cstdlib>
 
+#include <boost/algorithm/string.hpp>
+
 #include "commons.h"
 #include "exceptions.h"
 
 using namespace std;
 
+SQLValue SQLStatementVisitor::VisitValue(SQLParser::ValueContext *ctx, bool allow_param)
+{
+    SQLValue sql_value;
+    if (ctx->STRING_LITERAL())
+    {
+        std::string val = ctx->STRING_LITERAL()->getText();
+        sql_value.data_type = 2;                    // 문자열 타입
+        sql_value.value = val.substr(1, val.length() - 2); // 따옴표 제거
+        boost::algorithm::replace_all(sql_value.value, "''", "'"); // '' 는 따옴표 하나
+    }
+    else if (ctx->NUMERIC_LITERAL())
+    {
+        sql_value.value = ctx->NUMERIC_LITERAL()->getText();
+        sql_value.data_type = sql_value.value.find('.') != std::string::npos ? 1 : 0; // 실수 / 정수 타입
+    }
+    else if (ctx->PARAM() && allow_param)
+    {
+        sql_value.data_type = -1;
+        sql_value.param = next_param_++;
+    }
+    else
+    {
+        throw SyntaxErrorException();
+    }
+    return sql_value;
+}
+
 antlrcpp::Any SQLStatementVisitor::visitSqlStatement(SQLParser::SqlStatementContext *ctx)
 {
     // SQL 문장을 방문하고, 하위 노드를 방문하여 SQL 객체를 생성
@@ -80,11 +109,43 @@ antlrcpp::Any SQLStatementVisitor::visitCreateTable(SQLParser::CreateTableContex
         }
     }
 
+    // 저장 형식: USING ROW (기본값) | USING PAX
+    if (ctx->storageClause())
+    {
+        std::string storage = boost::algorithm::to_upper_copy(ctx->storageClause()->IDENTIFIER()->getText());
+        if (storage == "PAX")
+        {
+            stmt->set_storage(STORAGE_PAX);
+        }
+        else if (storage != "ROW")
+        {
+            throw SyntaxErrorException();
+        }
+    }
+
     stmt->set_attrs(attrs);
     return static_cast<SQL *>(stmt);
 }
 
 
+antlrcpp::Any SQLStatementVisitor::visitCreateIndex(SQLParser::CreateIndexContext *ctx)
+{
+    // CREATE INDEX 인덱스이름 ON 테이블이름 ( 속성이름 )
+    SQLCreateIndex *stmt = new SQLCreateIndex();
+    stmt->set_index_name(ctx->IDENTIFIER(0)->getText());
+    stmt->set_tb_name(ctx->IDENTIFIER(1)->getText());
+    stmt->set_col_name(ctx->IDENTIFIER(2)->getText());
+    return static_cast<SQL *>(stmt);
+}
+
+antlrcpp::Any SQLStatementVisitor::visitDropIndex(SQLParser::DropIndexContext *ctx)
+{
+    SQLDropIndex *stmt = new SQLDropIndex();
+    stmt->set_index_name(ctx->IDENTIFIER()->getText());
+    return static_cast<SQL *>(stmt);
+}
+
+
 antlrcpp::Any SQLStatementVisitor::visitUseDatabase(SQLParser::UseDatabaseContext *ctx)
 {
     SQLUse *stmt = new SQLUse();
@@ -94,48 +155,118 @@ antlrcpp::Any SQLStatementVisitor::visitUseDatabase(SQLParser::UseDatabaseContex
 
 antlrcpp::Any SQLStatementVisitor::visitInsertInto(SQLParser::InsertIntoContext *ctx)
 {
+    std::vector<std::vector<SQLValue>> rows;
+    for (auto rowCtx : ctx->valueRow())
+    {
+        std::vector<SQLValue> values;
+        for (auto valCtx : rowCtx->valueList()->value())
+        {
+            values.push_back(VisitValue(valCtx, true));
+        }
+        rows.push_back(values);
+    }
+
     SQLInsert *stmt = new SQLInsert();
     stmt->set_tb_name(ctx->IDENTIFIER()->getText());
-    std::vector<SQLValue> values;
+    stmt->set_rows(rows);
+    stmt->set_param_count(next_param_);
+    return static_cast<SQL *>(stmt);
+}
 
-    for (auto valCtx : ctx->valueList()->value())
+antlrcpp::Any SQLStatementVisitor::visitSelectStatement(SQLParser::SelectStatementContext *ctx)
+{
+    SQLSelect *stmt = new SQLSelect();
+    stmt->set_tb_name(ctx->IDENTIFIER()->getText());
+
+    // FROM a JOIN b ON a.x = b.y (속성 이름은 "테이블.속성" 그대로 둠)
+    if (ctx->joinClause())
+    {
+        auto joinCtx = ctx->joinClause();
+        SQLJoin join;
+        join.tb_name = joinCtx->IDENTIFIER()->getText();
+        join.left_key = joinCtx->columnName(0)->getText();
+        join.right_key = joinCtx->columnName(1)->getText();
+        stmt->set_join(join);
+    }
+
+    // SELECT 목록 (* 이면 비워 둠)
+    std::vector<SQLSelectItem> items;
+    bool aggregate = ctx->groupBy() != nullptr;
+    for (auto itemCtx : ctx->selectList()->selectItem())
     {
-        SQLValue sql_value;
-        if (valCtx->STRING_LITERAL())
+        SQLSelectItem item;
+        auto aggCtx = itemCtx->aggregate();
+        if (aggCtx == nullptr)
         {
-            std::string val = valCtx->STRING_LITERAL()->getText();
-            val = val.substr(1, val.length() - 2); // 따옴표 제거
-            sql_value.data_type = 2;               // 문자열 타입
-            sql_value.value = val;
+            item.aggregate = AGG_NONE;
+            item.column = itemCtx->columnName()->getText();
         }
-        else if (valCtx->NUMERIC_LITERAL())
+        else
         {
-            std::string val = valCtx->NUMERIC_LITERAL()->getText();
-            if (val.find('.') != std::string::npos)
-            {
-                sql_value.data_type = 1; // 실수 타입
-            }
+            if (aggCtx->COUNT())
+                item.aggregate = AGG_COUNT;
+            else if (aggCtx->SUM())
+                item.aggregate = AGG_SUM;
+            else if (aggCtx->MIN())
+                item.aggregate = AGG_MIN;
             else
+                item.aggregate = AGG_MAX;
+            if (aggCtx->columnName())
+                item.column = aggCtx->columnName()->getText();
+            else if (item.aggregate != AGG_COUNT)
+                throw SyntaxErrorException();   // COUNT(*)만 * 허용
+            aggregate = true;
+        }
+        items.push_back(item);
+    }
+    if (aggregate)
+    {
+        if (items.empty())
+            throw SyntaxErrorException();       // SELECT * ... GROUP BY
+        std::vector<std::string> group_by;
+        if (ctx->groupBy())
+        {
+            for (auto column : ctx->groupBy()->columnName())
             {
-                sql_value.data_type = 0; // 정수 타입
+                group_by.push_back(column->getText());
             }
-            sql_value.value = val;
         }
-        else
+        stmt->set_items(items);
+        stmt->set_group_by(group_by);
+    }
+    else
+    {
+        std::vector<std::string> columns;
+        for (const SQLSelectItem &item : items)
         {
-            throw SyntaxErrorException();
+            columns.push_back(item.column);
         }
-        values.push_back(sql_value);
+        stmt->set_columns(columns);
     }
 
-    stmt->set_values(values);
-    return static_cast<SQL *>(stmt);
-}
+    // ORDER BY a, b DESC
+    if (ctx->orderBy())
+    {
+        std::vector<SQLOrderItem> order_by;
+        for (auto orderCtx : ctx->orderBy()->orderItem())
+        {
+            SQLOrderItem item;
+            item.column = orderCtx->columnName()->getText();
+            item.desc = orderCtx->DESC() != nullptr;
+            order_by.push_back(item);
+        }
+        stmt->set_order_by(order_by);
+    }
 
-antlrcpp::Any SQLStatementVisitor::visitSelectStatement(SQLParser::SelectStatementContext *ctx)
-{
-    SQLSelect *stmt = new SQLSelect();
-    stmt->set_tb_name(ctx->IDENTIFIER()->getText());
+    if (ctx->LIMIT())
+    {
+        std::string limit = ctx->NUMERIC_LITERAL()->getText();
+        if (limit.find_first_not_of("0123456789") != std::string::npos)
+        {
+            throw SyntaxErrorException();   // 소수
+        }
+        stmt->set_limit(std::atol(limit.c_str()));
+    }
     std::vector<SQLWhere> wheres;
 
     if (ctx->WHERE())
@@ -144,7 +275,7 @@ antlrcpp::Any SQLStatementVisitor::visitSelectStatement(SQLParser::SelectStateme
         {
             SQLWhere where;
             auto condCtx = ctx->condition(i);
-            where.key = condCtx->IDENTIFIER()->getText();
+            where.key = condCtx->columnName()->getText();
             std::string comp = condCtx->comparator()->getText();
 
             // 비교 연산자를 설정
@@ -163,26 +294,16 @@ antlrcpp::Any SQLStatementVisitor::visitSelectStatement(SQLParser::SelectStateme
             else
                 throw SyntaxErrorException();
 
-            // 값 설정
-            if (condCtx->value()->STRING_LITERAL())
-            {
-                std::string val = condCtx->value()->STRING_LITERAL()->getText();
-                val = val.substr(1, val.length() - 2); // 따옴표 제거
-                where.value = val;
-            }
-            else if (condCtx->value()->NUMERIC_LITERAL())
-            {
-                where.value = condCtx->value()->NUMERIC_LITERAL()->getText();
-            }
-            else
-            {
-                throw SyntaxErrorException();
-            }
+            // 값 설정 ('?'이면 EXECUTE 때 채움)
+            SQLValue value = VisitValue(condCtx->value(), true);
+            where.value = value.value;
+            where.param = value.param;
             wheres.push_back(where);
         }
     }
 
     stmt->set_wheres(wheres);
+    stmt->set_param_count(next_param_);
     return static_cast<SQL *>(stmt);
 }
 
@@ -193,6 +314,42 @@ antlrcpp::Any SQLStatementVisitor::visitExecStatement(SQLParser::ExecStatementCo
     return static_cast<SQL *>(stmt);
 }
 
+antlrcpp::Any SQLStatementVisitor::visitExplainStatement(SQLParser::ExplainStatementContext *ctx)
+{
+    SQLExplain *stmt = new SQLExplain();
+    stmt->set_select(static_cast<SQLSelect *>(std::any_cast<SQL *>(visit(ctx->selectStatement()))));
+    return static_cast<SQL *>(stmt);
+}
+
+antlrcpp::Any SQLStatementVisitor::visitPrepareStatement(SQLParser::PrepareStatementContext *ctx)
+{
+    SQLPrepare *stmt = new SQLPrepare();
+    stmt->set_name(ctx->IDENTIFIER()->getText());
+    antlrcpp::Any inner = ctx->insertInto() ? visit(ctx->insertInto()) : visit(ctx->selectStatement());
+    stmt->set_statement(std::any_cast<SQL *>(inner));
+    return static_cast<SQL *>(stmt);
+}
+
+antlrcpp::Any SQLStatementVisitor::visitExecuteStatement(SQLParser::ExecuteStatementContext *ctx)
+{
+    std::vector<SQLValue> params;
+    for (auto valCtx : ctx->value())
+    {
+        params.push_back(VisitValue(valCtx, false));
+    }
+    SQLExecute *stmt = new SQLExecute();
+    stmt->set_name(ctx->IDENTIFIER()->getText());
+    stmt->set_params(params);
+    return static_cast<SQL *>(stmt);
+}
+
+antlrcpp::Any SQLStatementVisitor::visitDeallocateStatement(SQLParser::DeallocateStatementContext *ctx)
+{
+    SQLDeallocate *stmt = new SQLDeallocate();
+    stmt->set_name(ctx->IDENTIFIER()->getText());
+    return static_cast<SQL *>(stmt);
+}
+
 antlrcpp::Any SQLStatementVisitor::visitShowDatabases(SQLParser::ShowDatabasesContext *ctx)
 {
     SQL *stmt = new SQL(40);
@@ -205,6 +362,12 @@ antlrcpp::Any SQLStatementVisitor::visitShowTables(SQLParser::ShowTablesContext
     return stmt;
 }
 
+antlrcpp::Any SQLStatementVisitor::visitShowStats(SQLParser::ShowStatsContext *ctx)
+{
+    SQL *stmt = new SQL(42);
+    return stmt;
+}
+
 antlrcpp::Any SQLStatementVisitor::visitHelpStatement(SQLParser::HelpStatementContext *ctx)
 {
     SQL *stmt = new SQL(20);
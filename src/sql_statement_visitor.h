@@ -7,16 +7,35 @@
 
 class SQLStatementVisitor : public SQLBaseVisitor
 {
+private:
+    int next_param_;    // 다음 '?' 자리 번호
+
+    /**
+     * @brief 리터럴 또는 '?' 자리 하나
+     *
+     * @throw SyntaxErrorException allow_param이 false인데 '?'
+     */
+    SQLValue VisitValue(SQLParser::ValueContext *ctx, bool allow_param);
+
 public:
+    SQLStatementVisitor() : next_param_(0) {}
+
     virtual antlrcpp::Any visitSqlStatement(SQLParser::SqlStatementContext *ctx) override;
     virtual antlrcpp::Any visitCreateDatabase(SQLParser::CreateDatabaseContext *ctx) override;
     virtual antlrcpp::Any visitCreateTable(SQLParser::CreateTableContext *ctx) override;
+    virtual antlrcpp::Any visitCreateIndex(SQLParser::CreateIndexContext *ctx) override;
+    virtual antlrcpp::Any visitDropIndex(SQLParser::DropIndexContext *ctx) override;
     virtual antlrcpp::Any visitUseDatabase(SQLParser::UseDatabaseContext *ctx) override;
     virtual antlrcpp::Any visitInsertInto(SQLParser::InsertIntoContext *ctx) override;
     virtual antlrcpp::Any visitSelectStatement(SQLParser::SelectStatementContext *ctx) override;
+    virtual antlrcpp::Any visitExplainStatement(SQLParser::ExplainStatementContext *ctx) override;
     virtual antlrcpp::Any visitExecStatement(SQLParser::ExecStatementContext *ctx) override;
+    virtual antlrcpp::Any visitPrepareStatement(SQLParser::PrepareStatementContext *ctx) override;
+    virtual antlrcpp::Any visitExecuteStatement(SQLParser::ExecuteStatementContext *ctx) override;
+    virtual antlrcpp::Any visitDeallocateStatement(SQLParser::DeallocateStatementContext *ctx) override;
     virtual antlrcpp::Any visitShowDatabases(SQLParser::ShowDatabasesContext *ctx) override;
     virtual antlrcpp::Any visitShowTables(SQLParser::ShowTablesContext *ctx) override;
+    virtual antlrcpp::Any visitShowStats(SQLParser::ShowStatsContext *ctx) override;
     virtual antlrcpp::Any visitHelpStatement(SQLParser::HelpStatementContext *ctx) override;
     virtual antlrcpp::Any visitQuitStatement(SQLParser::QuitStatementContext *ctx) override;
 };
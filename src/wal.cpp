@@ -0,0 +1,298 @@
+#include "wal.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/crc.hpp>
+
+namespace {
+
+uint32_t Crc32(const char *data, size_t len) {
+    boost::crc_32_type crc;
+    crc.process_bytes(data, len);
+    return crc.checksum();
+}
+
+template <typename T>
+void Put(std::vector<char> &out, const T &value) {
+    const char *p = reinterpret_cast<const char *>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+bool Get(const std::vector<char> &in, size_t *pos, T *value) {
+    if (*pos + sizeof(T) > in.size()) {
+        return false;
+    }
+    std::memcpy(value, in.data() + *pos, sizeof(T));
+    *pos += sizeof(T);
+    return true;
+}
+
+bool ReadAt(int fd, char *buf, size_t len, size_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = pread(fd, buf + done, len - done, offset + done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * @brief payload를 WalRecord로 풀어냄
+ */
+bool Decode(const WalRecordHeader &header, const std::vector<char> &payload, WalRecord *record) {
+    size_t pos = 0;
+    uint16_t name_len;
+    if (!Get(payload, &pos, &name_len) || pos + name_len > payload.size()) {
+        return false;
+    }
+    record->type = header.type;
+    record->lsn = header.lsn;
+    record->file.assign(payload.data() + pos, name_len);
+    pos += name_len;
+    if (!Get(payload, &pos, &record->dir_idx) || !Get(payload, &pos, &record->page_idx) ||
+        !Get(payload, &pos, &record->slot_no)) {
+        return false;
+    }
+    record->data.assign(payload.begin() + pos, payload.end());
+    return true;
+}
+
+}  // namespace
+
+WriteAheadLog::WriteAheadLog(const std::string &path, long commit_delay_us)
+    : fd_(-1), path_(path), commit_delay_us_(commit_delay_us), next_lsn_(1), flushed_lsn_(0),
+      flushing_(false), file_size_(0), sync_count_(0), commit_count_(0) {
+    fd_ = open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("로그 파일을 열 수 없습니다: " + path_);
+    }
+    WalFileHeader header;
+    if (!ReadAt(fd_, reinterpret_cast<char *>(&header), sizeof(header), 0) ||
+        header.magic != WAL_MAGIC || header.version != WAL_VERSION) {
+        WriteHeader(1);     // 새 로그 (알아볼 수 없는 파일도 새로 시작)
+        if (ftruncate(fd_, sizeof(WalFileHeader)) != 0) {
+            throw std::runtime_error("로그 파일을 초기화할 수 없습니다: " + path_);
+        }
+        file_size_ = sizeof(WalFileHeader);
+        return;
+    }
+
+    uint64_t last_lsn = header.start_lsn - 1;
+    file_size_ = Scan(nullptr, &last_lsn);
+    next_lsn_ = last_lsn + 1;
+    flushed_lsn_ = last_lsn;
+    struct stat st;
+    if (fstat(fd_, &st) == 0 && static_cast<size_t>(st.st_size) > file_size_) {
+        // 쓰다 중단된 마지막 레코드를 잘라냄
+        if (ftruncate(fd_, file_size_) != 0) {
+            throw std::runtime_error("로그 파일을 자를 수 없습니다: " + path_);
+        }
+    }
+}
+
+bool WriteAheadLog::HasRecords(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    WalFileHeader header;
+    struct stat st;
+    bool records = ReadAt(fd, reinterpret_cast<char *>(&header), sizeof(header), 0) &&
+                   header.magic == WAL_MAGIC && header.version == WAL_VERSION &&
+                   fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) > sizeof(WalFileHeader);
+    close(fd);
+    return records;
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+void WriteAheadLog::WriteAll(const char *buf, size_t len, size_t offset) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = pwrite(fd_, buf + done, len - done, offset + done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw std::runtime_error("로그를 쓸 수 없습니다: " + path_);
+        }
+        done += static_cast<size_t>(n);
+    }
+}
+
+void WriteAheadLog::WriteHeader(uint64_t start_lsn) {
+    WalFileHeader header = {WAL_MAGIC, WAL_VERSION, start_lsn};
+    WriteAll(reinterpret_cast<const char *>(&header), sizeof(header), 0);
+    if (fdatasync(fd_) != 0) {
+        throw std::runtime_error("로그를 디스크에 내릴 수 없습니다: " + path_);
+    }
+}
+
+size_t WriteAheadLog::Scan(const std::function<void(const WalRecord &)> &callback, uint64_t *last_lsn) {
+    size_t pos = sizeof(WalFileHeader);
+    std::vector<char> payload;
+    WalRecord record;
+    while (true) {
+        WalRecordHeader header;
+        if (!ReadAt(fd_, reinterpret_cast<char *>(&header), sizeof(header), pos) ||
+            header.magic != WAL_RECORD_MAGIC || header.lsn != *last_lsn + 1) {
+            break;  // 로그 끝, 또는 이전 checkpoint 전에 남은 레코드
+        }
+        payload.resize(header.length);
+        if (!ReadAt(fd_, payload.data(), header.length, pos + sizeof(header)) ||
+            Crc32(payload.data(), payload.size()) != header.crc || !Decode(header, payload, &record)) {
+            break;
+        }
+        if (callback) {
+            callback(record);
+        }
+        *last_lsn = header.lsn;
+        pos += sizeof(header) + header.length;
+    }
+    return pos;
+}
+
+uint64_t WriteAheadLog::Append(uint32_t type, const std::string &file, int32_t dir_idx, int32_t page_idx,
+                               int32_t slot_no, const char *data, int length) {
+    std::vector<char> payload;
+    payload.reserve(sizeof(uint16_t) + file.size() + 3 * sizeof(int32_t) + length);
+    Put(payload, static_cast<uint16_t>(file.size()));
+    payload.insert(payload.end(), file.begin(), file.end());
+    Put(payload, dir_idx);
+    Put(payload, page_idx);
+    Put(payload, slot_no);
+    payload.insert(payload.end(), data, data + length);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    WalRecordHeader header = {WAL_RECORD_MAGIC, type, next_lsn_, static_cast<uint32_t>(payload.size()),
+                              Crc32(payload.data(), payload.size())};
+    Put(buffer_, header);
+    buffer_.insert(buffer_.end(), payload.begin(), payload.end());
+    return next_lsn_++;
+}
+
+uint64_t WriteAheadLog::AppendInsert(const std::string &file, int dir_idx, int page_idx, int slot_no,
+                                     const char *record, int length) {
+    return Append(WAL_INSERT, file, dir_idx, page_idx, slot_no, record, length);
+}
+
+uint64_t WriteAheadLog::AppendReindex(const std::string &file) {
+    return Append(WAL_REINDEX, file, -1, -1, -1, nullptr, 0);
+}
+
+void WriteAheadLog::Flush(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    commit_count_++;
+    if (lsn >= next_lsn_) {
+        lsn = next_lsn_ - 1;
+    }
+    while (flushed_lsn_ < lsn) {
+        if (flushing_) {
+            flushed_cv_.wait(lock);     // 다른 leader가 쓰는 중. 끝나면 다시 확인
+            continue;
+        }
+        flushing_ = true;
+        if (commit_delay_us_ > 0) {
+            lock.unlock();
+            std::this_thread::sleep_for(std::chrono::microseconds(commit_delay_us_));
+            lock.lock();
+        }
+        std::vector<char> out;
+        out.swap(buffer_);
+        uint64_t upto = next_lsn_ - 1;
+        size_t offset = file_size_;
+        lock.unlock();
+
+        bool ok = true;
+        try {
+            WriteAll(out.data(), out.size(), offset);
+            ok = fdatasync(fd_) == 0;
+        } catch (const std::runtime_error &) {
+            ok = false;
+        }
+
+        lock.lock();
+        flushing_ = false;
+        flushed_cv_.notify_all();
+        if (!ok) {
+            // 쓰지 못한 레코드를 되돌려 다음 leader가 같은 offset부터 다시 쓰게 함 (flushed_lsn_은 그대로)
+            buffer_.insert(buffer_.begin(), out.begin(), out.end());
+            throw std::runtime_error("로그를 디스크에 내릴 수 없습니다: " + path_);
+        }
+        file_size_ = offset + out.size();
+        flushed_lsn_ = upto;
+        sync_count_++;
+    }
+}
+
+void WriteAheadLog::FlushAll() {
+    Flush(next_lsn() - 1);
+}
+
+void WriteAheadLog::Replay(const std::function<void(const WalRecord &)> &callback) {
+    WalFileHeader header;
+    if (!ReadAt(fd_, reinterpret_cast<char *>(&header), sizeof(header), 0)) {
+        return;
+    }
+    uint64_t last_lsn = header.start_lsn - 1;
+    Scan(callback, &last_lsn);
+}
+
+void WriteAheadLog::Truncate() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (flushing_) {
+        flushed_cv_.wait(lock);     // leader가 이전 file_size_ 위치에 쓰는 중이면 끝날 때까지 기다림
+    }
+    // 헤더의 start_lsn을 먼저 올리면 자르기 전에 중단돼도 남은 레코드는 LSN이 맞지 않아 무시됨
+    WriteHeader(next_lsn_);
+    if (ftruncate(fd_, sizeof(WalFileHeader)) != 0) {
+        throw std::runtime_error("로그 파일을 자를 수 없습니다: " + path_);
+    }
+    buffer_.clear();
+    file_size_ = sizeof(WalFileHeader);
+    flushed_lsn_ = next_lsn_ - 1;
+}
+
+size_t WriteAheadLog::size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_size_ + buffer_.size();
+}
+
+uint64_t WriteAheadLog::next_lsn() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return next_lsn_;
+}
+
+uint64_t WriteAheadLog::flushed_lsn() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flushed_lsn_;
+}
+
+uint64_t WriteAheadLog::sync_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sync_count_;
+}
+
+uint64_t WriteAheadLog::commit_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return commit_count_;
+}
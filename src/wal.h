@@ -0,0 +1,146 @@
+#ifndef ABCDB_WAL_H_
+#define ABCDB_WAL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define WAL_FILE_NAME "abcdb.wal"
+#define WAL_MAGIC 0x4c415741         // "AWAL"
+#define WAL_RECORD_MAGIC 0x52415741  // "AWAR"
+#define WAL_VERSION 1
+
+#define WAL_INSERT 1    // 페이지 슬롯에 레코드 삽입
+#define WAL_REINDEX 2   // 테이블 인덱스가 로그 없이 바뀜 (bulk load, CREATE INDEX). 복구할 때 인덱스를 다시 만듦
+
+/**
+ * @brief WAL 파일의 첫 부분
+ */
+struct WalFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t start_lsn;     // 이 파일의 첫 레코드가 받을 LSN (checkpoint 때마다 올라감)
+};
+
+/**
+ * @brief 레코드 앞에 붙는 헤더. 뒤에 length 바이트 payload가 이어짐
+ */
+struct WalRecordHeader {
+    uint32_t magic;
+    uint32_t type;      // WAL_INSERT ...
+    uint64_t lsn;
+    uint32_t length;    // payload 길이
+    uint32_t crc;       // payload의 CRC-32
+};
+
+/**
+ * @brief 복구할 때 읽은 로그 레코드
+ */
+struct WalRecord {
+    uint32_t type;
+    uint64_t lsn;
+    std::string file;       // 테이블 파일 경로
+    int32_t dir_idx;
+    int32_t page_idx;
+    int32_t slot_no;        // 레코드가 들어간 슬롯 번호
+    std::vector<char> data; // 레코드 바이트
+};
+
+/**
+ * @brief redo 전용 write-ahead log
+ * @details 레코드는 메모리 버퍼에 붙이고, Flush(lsn)을 부른 쪽 중 하나(leader)가 모인 레코드를
+ *          한 번에 쓰고 fdatasync 한다(group commit). leader가 쓰는 동안 들어온 commit은 기다렸다가
+ *          다음 leader가 함께 처리하므로 동시에 commit하는 세션이 많을수록 fsync 한 번이 여러 commit을 덮는다.
+ *          commit_delay_us가 0보다 크면 leader가 그만큼 기다려 레코드를 더 모은다.
+ *
+ *          페이지에는 마지막으로 반영된 레코드의 LSN이 기록되며, 페이지를 디스크에 쓰기 전에 그 LSN까지
+ *          로그를 먼저 내려야 한다(BufferManager::FlushPage). 모든 dirty 페이지가 디스크에 내려간 뒤에는
+ *          Truncate로 로그를 비운다(checkpoint). 로그 끝이 깨져 있으면(쓰다 중단됨) 그 앞까지만 유효하다.
+ */
+class WriteAheadLog {
+private:
+    int fd_;
+    std::string path_;
+    long commit_delay_us_;
+
+    std::mutex mutex_;
+    std::condition_variable flushed_cv_;
+    std::vector<char> buffer_;  // 아직 쓰지 않은 레코드
+    uint64_t next_lsn_;         // 다음 레코드가 받을 LSN
+    uint64_t flushed_lsn_;      // 이 LSN까지 디스크에 내려감
+    bool flushing_;             // leader가 쓰는 중
+    size_t file_size_;          // 파일에 쓴 끝 위치
+
+    uint64_t sync_count_;       // fdatasync 횟수
+    uint64_t commit_count_;     // Flush 요청 횟수
+
+    uint64_t Append(uint32_t type, const std::string &file, int32_t dir_idx, int32_t page_idx, int32_t slot_no,
+                    const char *data, int length);
+    void WriteHeader(uint64_t start_lsn);
+    void WriteAll(const char *buf, size_t len, size_t offset);
+
+    /**
+     * @brief 파일 헤더 뒤의 레코드를 차례로 읽음
+     *
+     * @return size_t 마지막으로 온전한 레코드의 끝 위치
+     */
+    size_t Scan(const std::function<void(const WalRecord &)> &callback, uint64_t *last_lsn);
+
+public:
+    /**
+     * @brief 로그 파일을 열고 끝을 찾음. 파일이 없거나 비어 있으면 새로 만듦
+     *
+     * @param commit_delay_us group commit leader가 레코드를 모으려고 기다리는 시간 (microseconds)
+     * @throw std::runtime_error 로그 파일을 열 수 없음
+     */
+    WriteAheadLog(const std::string &path, long commit_delay_us = 0);
+    ~WriteAheadLog();
+
+    /**
+     * @brief path의 로그 파일에 헤더 뒤 레코드가 남아 있는지 (파일을 만들거나 고치지 않음)
+     * @details checkpoint 뒤의 로그는 헤더만 남으므로, 레코드가 있으면 비정상 종료 뒤 아직 재생하지 않은 로그다.
+     */
+    static bool HasRecords(const std::string &path);
+
+    /**
+     * @brief 레코드 삽입을 로그에 붙임. 디스크에는 아직 쓰지 않음
+     *
+     * @return uint64_t 받은 LSN
+     */
+    uint64_t AppendInsert(const std::string &file, int dir_idx, int page_idx, int slot_no, const char *record, int length);
+    uint64_t AppendReindex(const std::string &file);
+
+    /**
+     * @brief lsn까지의 레코드가 디스크에 내려갈 때까지 기다림 (group commit)
+     */
+    void Flush(uint64_t lsn);
+
+    /**
+     * @brief 지금까지 붙인 모든 레코드를 내림 (문장 commit)
+     */
+    void FlushAll();
+
+    /**
+     * @brief 로그의 모든 레코드를 LSN 순서로 전달 (복구용)
+     */
+    void Replay(const std::function<void(const WalRecord &)> &callback);
+
+    /**
+     * @brief 로그를 비움. 모든 dirty 페이지가 디스크에 내려간 뒤에만 불러야 함 (checkpoint)
+     */
+    void Truncate();
+
+    /**
+     * @brief 로그 크기 (파일에 쓴 부분 + 아직 쓰지 않은 버퍼)
+     */
+    size_t size();
+    uint64_t next_lsn();
+    uint64_t flushed_lsn();
+    uint64_t sync_count();
+    uint64_t commit_count();
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include "config.h"
+
+/**
+ * @brief ParallelFor 호출 하나. slot마다 task deque를 가짐
+ */
+struct WorkStealingPool::Job {
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    const std::function<void(size_t, size_t)> *fn;
+    std::vector<Queue> queues;
+    std::atomic<size_t> remaining;
+
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    std::exception_ptr error;
+
+    Job(const std::function<void(size_t, size_t)> *f, size_t slots, size_t n) : fn(f), queues(slots), remaining(n) {}
+
+    /**
+     * @brief 자기 deque 앞에서 꺼내고, 비었으면 다른 deque의 뒤에서 훔침
+     */
+    bool Take(size_t slot, size_t *task) {
+        {
+            std::lock_guard<std::mutex> lock(queues[slot].mutex);
+            if (!queues[slot].tasks.empty()) {
+                *task = queues[slot].tasks.front();
+                queues[slot].tasks.pop_front();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < queues.size(); i++) {
+            Queue &victim = queues[(slot + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                *task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief 더 가져올 task가 없을 때까지 처리
+     */
+    void Work(size_t slot) {
+        size_t task;
+        while (Take(slot, &task)) {
+            try {
+                (*fn)(task, slot);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(done_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(done_mutex);
+                done_cv.notify_all();
+            }
+        }
+    }
+};
+
+WorkStealingPool::WorkStealingPool(size_t threads) : stop_(false) {
+    for (size_t i = 0; i < threads; i++) {
+        threads_.emplace_back(&WorkStealingPool::Run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread &thread : threads_) {
+        thread.join();
+    }
+}
+
+WorkStealingPool &WorkStealingPool::Instance() {
+    static WorkStealingPool pool(Config::Instance().parallel_workers() - 1);
+    return pool;
+}
+
+void WorkStealingPool::Retire(const std::shared_ptr<Job> &job) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find(jobs_.begin(), jobs_.end(), job);
+    if (it != jobs_.end()) {
+        jobs_.erase(it);
+    }
+}
+
+void WorkStealingPool::Run(size_t slot) {
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+            if (stop_) {
+                return;
+            }
+            job = jobs_.front();
+        }
+        job->Work(slot);
+        Retire(job);    // 꺼낼 task가 없음. 남은 task는 이미 다른 스레드가 실행 중
+    }
+}
+
+void WorkStealingPool::ParallelFor(size_t n, const std::function<void(size_t task, size_t slot)> &fn) {
+    if (n == 0) {
+        return;
+    }
+    size_t caller_slot = threads_.size();
+    if (threads_.empty() || n == 1) {
+        for (size_t task = 0; task < n; task++) {
+            fn(task, caller_slot);
+        }
+        return;
+    }
+
+    std::shared_ptr<Job> job = std::make_shared<Job>(&fn, slots(), n);
+    for (size_t task = 0; task < n; task++) {
+        job->queues[task * slots() / n].tasks.push_back(task);   // slot마다 연속 구간 (페이지 순서 유지)
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(job);
+    }
+    cv_.notify_all();
+
+    job->Work(caller_slot);
+    Retire(job);
+    {
+        std::unique_lock<std::mutex> lock(job->done_mutex);
+        job->done_cv.wait(lock, [&job] { return job->remaining.load(std::memory_order_acquire) == 0; });
+    }
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+}
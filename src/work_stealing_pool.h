@@ -0,0 +1,61 @@
+#ifndef ABCDB_WORK_STEALING_POOL_H_
+#define ABCDB_WORK_STEALING_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 작업(task) 번호를 병렬로 처리하는 work-stealing 스레드 풀
+ * @details ParallelFor는 task 0..n-1을 slot(풀 스레드 + 호출한 스레드)마다 연속 구간으로 나눠 각 slot의 deque에 넣는다.
+ *          각 스레드는 자기 deque의 앞에서 꺼내고, 비면 다른 slot deque의 뒤에서 훔쳐 온다. 그래서 조건에 맞는 행이 몰린
+ *          구간처럼 오래 걸리는 task가 있어도 먼저 끝난 스레드가 남은 일을 나눠 가진다.
+ *
+ *          호출한 스레드도 자기 slot으로 참여하므로 풀 스레드가 다른 세션의 작업을 하고 있어도 진행이 보장된다.
+ *          여러 세션이 동시에 ParallelFor를 불러도 되며, 풀 스레드는 먼저 들어온 작업부터 돕는다.
+ */
+class WorkStealingPool {
+private:
+    struct Job;
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<Job>> jobs_;     // 남은 task가 있을 수 있는 작업
+    bool stop_;
+
+    void Run(size_t slot);
+    void Retire(const std::shared_ptr<Job> &job);
+
+public:
+    /**
+     * @param threads 풀 스레드 수 (호출한 스레드는 제외)
+     */
+    explicit WorkStealingPool(size_t threads);
+    ~WorkStealingPool();
+
+    /**
+     * @brief Config::parallel_workers()로 만든 공용 풀
+     */
+    static WorkStealingPool &Instance();
+
+    /**
+     * @brief task를 처리할 수 있는 스레드 수 (풀 스레드 + 호출한 스레드). slot 번호는 0..slots()-1
+     */
+    size_t slots() const { return threads_.size() + 1; }
+
+    /**
+     * @brief fn(task, slot)을 task 0..n-1에 대해 병렬로 실행하고 모두 끝날 때까지 기다림
+     * @details 같은 slot 번호로 동시에 fn이 불리지 않으므로 slot별 작업 공간을 잠금 없이 쓸 수 있다.
+     *
+     * @throw fn이 던진 첫 예외 (나머지 task는 끝까지 실행됨)
+     */
+    void ParallelFor(size_t n, const std::function<void(size_t task, size_t slot)> &fn);
+};
+
+#endif